@@ -95,6 +95,16 @@
 #define ALMOND_USING_SOFTWARE_RENDERER 1
 #endif
 
+// Window-less software context (frame dumps / hashes for CI); needs the software renderer.
+// #define ALMOND_USING_SOFTWARE_HEADLESS
+#if defined(ALMOND_FORCE_ENABLE_SOFTWARE_HEADLESS)
+#undef ALMOND_USING_SOFTWARE_HEADLESS
+#define ALMOND_USING_SOFTWARE_HEADLESS 1
+#endif
+#if defined(ALMOND_USING_SOFTWARE_HEADLESS) && !defined(ALMOND_USING_SOFTWARE_RENDERER)
+#undef ALMOND_USING_SOFTWARE_HEADLESS
+#endif
+
 #if defined(ALMOND_FORCE_DISABLE_OPENGL)
 #undef ALMOND_USING_OPENGL
 #endif
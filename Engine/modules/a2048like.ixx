@@ -6,22 +6,24 @@ import aengine.core.context;      // core::Context
 import aengine.context.window;    // core::WindowData
 import aengine.input;             // input::Key
 import aatlas.manager;            // atlasmanager
+import aatlas.cache;              // atlascache::asset_paths
 import aimage.loader;             // a_loadImage
 import aspritehandle;             // SpriteHandle
 import asprite.pool;              // spritepool
+import aspritetable;              // SpriteTable, TileGrid
 import ascene;                    // scene::Scene
 import aengine.core.logger;       // logger::Logger
 import aengine.core.time;         // timing::Timer
 
 // C++ std
 import <algorithm>;
+import <array>;
 import <cstdint>;
 import <span>;
 import <stdexcept>;
 import <string>;
 import <string_view>;
 import <tuple>;
-import <unordered_map>;
 import <utility>;
 import <vector>;
 
@@ -51,9 +53,9 @@ export namespace almondnamespace::a2048like
             auto atlasVec = atlasmanager::get_atlas_vector_snapshot(); // by value
             std::span<const TextureAtlas* const> atlasSpan(atlasVec.data(), atlasVec.size());
 
-            if (auto it = sprites.find("bg"); it != sprites.end() && spritepool::is_alive(it->second))
+            if (const SpriteHandle background = sprites.live(SpriteBg); background.is_valid())
             {
-                ctx->draw_sprite_safe(it->second, atlasSpan, 0.0f, 0.0f,
+                ctx->draw_sprite_safe(background, atlasSpan, 0.0f, 0.0f,
                     float(ctx->get_width_safe()), float(ctx->get_height_safe()));
             }
 
@@ -63,23 +65,18 @@ export namespace almondnamespace::a2048like
             const float offsetX = (width - cellSize * float(kCols)) * 0.5f;
             const float offsetY = (height - cellSize * float(kRows)) * 0.5f;
 
-            for (int row = 0; row < kRows; ++row)
+            // Tile value kTileValues[n] is drawn with sprite n + 1; empty cells (0) draw nothing.
+            for (std::size_t i = 0; i < grid.size(); ++i)
             {
-                for (int col = 0; col < kCols; ++col)
-                {
-                    const int value = grid[static_cast<size_t>(row * kCols + col)];
-                    const auto name = std::to_string(value);
-                    auto it = sprites.find(name);
-                    if (it == sprites.end() || !spritepool::is_alive(it->second))
-                        continue;
-
-                    ctx->draw_sprite_safe(it->second, atlasSpan,
-                        offsetX + cellSize * float(col),
-                        offsetY + cellSize * float(row),
-                        cellSize, cellSize);
-                }
+                const auto it = std::find(kTileValues.begin(), kTileValues.end(), grid[i]);
+                cells[i] = it != kTileValues.end()
+                    ? static_cast<std::uint16_t>(SpriteTile0 + (it - kTileValues.begin()))
+                    : kNoTile;
             }
 
+            ctx->draw_tilemap_safe(sprites.palette(), cells, kCols, kRows,
+                { offsetX, offsetY, cellSize, cellSize }, atlasSpan);
+
             ctx->present_safe();
             return true;
         }
@@ -106,9 +103,12 @@ export namespace almondnamespace::a2048like
                 throw std::runtime_error("[A2048Like] Missing atlas registrar");
 
             TextureAtlas& atlas = registrar->atlas;
+
+            static constexpr std::array<std::string_view, 13> kSpriteIds{ "bg", "2", "4", "6", "8", "16", "32", "64", "128", "256", "512", "1024", "2048" };
+
             bool registered = false;
 
-            auto ensureSprite = [&](std::string_view id)
+            auto ensureSprite = [&](std::size_t index, std::string_view id)
             {
                 std::string name(id);
 
@@ -117,7 +117,7 @@ export namespace almondnamespace::a2048like
                     auto handle = std::get<0>(*existing);
                     if (spritepool::is_alive(handle))
                     {
-                        sprites[name] = handle;
+                        sprites.set(index, handle);
                         return;
                     }
                 }
@@ -131,25 +131,18 @@ export namespace almondnamespace::a2048like
 
                 if (handleOpt && spritepool::is_alive(*handleOpt))
                 {
-                    sprites[name] = *handleOpt;
+                    sprites.set(index, *handleOpt);
                     registered = true;
                 }
             };
 
-            // Always try to load a background sprite if available
-            ensureSprite("bg");
-            ensureSprite("2");
-            ensureSprite("4");
-            ensureSprite("6");
-            ensureSprite("8");
-            ensureSprite("16");
-            ensureSprite("32");
-            ensureSprite("64");
-            ensureSprite("128");
-            ensureSprite("256");
-            ensureSprite("512");
-            ensureSprite("1024");
-            ensureSprite("2048");
+            atlasmanager::load_or_bake_atlas(atlas.name,
+                atlascache::asset_paths("assets/games/a2048like/", kSpriteIds), [&]
+                {
+                    // Always try to load a background sprite if available
+                    for (std::size_t i = 0; i < kSpriteIds.size(); ++i)
+                        ensureSprite(i, kSpriteIds[i]);
+                });
 
             if (createdAtlas || registered)
             {
@@ -158,10 +151,15 @@ export namespace almondnamespace::a2048like
             }
         }
 
-        std::unordered_map<std::string, SpriteHandle> sprites{};
+        // Positions in kSpriteIds (setupSprites()), which are also the tile-map cell values.
+        enum SpriteId : std::uint16_t { SpriteBg, SpriteTile0 };
+
+        SpriteTable sprites{};
+        static constexpr std::array<int, 12> kTileValues{ 2, 4, 6, 8, 16, 32, 64, 128, 256, 512, 1024, 2048 };
         static constexpr int kRows = 4;
         static constexpr int kCols = 4;
         std::vector<int> grid{};
+        std::vector<std::uint16_t> cells{};
 
         void initializeGrid()
         {
@@ -171,6 +169,7 @@ export namespace almondnamespace::a2048like
                 512, 1024, 2048, 2,
                 4, 8, 16, 32
             };
+            cells.resize(grid.size());
         }
     };
 
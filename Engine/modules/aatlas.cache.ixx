@@ -0,0 +1,561 @@
+/**************************************************************
+ *   AlmondShell - Modular C++ Framework
+ **************************************************************/
+ // aatlas.cache.ixx
+ //
+ // Baked atlas cache: the packed pixel pages and entry table of an
+ // atlas, written once and memory-mapped on later launches when the
+ // source images still match. Sources are compared by path, size and
+ // modification time first; their bytes are hashed only when those differ.
+
+module;
+
+#if defined(_WIN32)
+#   ifndef WIN32_LEAN_AND_MEAN
+#       define WIN32_LEAN_AND_MEAN
+#   endif
+#   ifndef NOMINMAX
+#       define NOMINMAX
+#   endif
+#   include <windows.h>
+#else
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#endif
+
+export module aatlas.cache;
+
+// ────────────────────────────────────────────────────────────
+// STANDARD LIBRARY IMPORTS
+// ────────────────────────────────────────────────────────────
+
+import <array>;
+import <cstddef>;
+import <cstdint>;
+import <cstdlib>;
+import <cstring>;
+import <filesystem>;
+import <fstream>;
+import <iostream>;
+import <optional>;
+import <span>;
+import <string>;
+import <string_view>;
+import <system_error>;
+import <utility>;
+import <vector>;
+
+// ────────────────────────────────────────────────────────────
+// ENGINE DEPENDENCIES
+// ────────────────────────────────────────────────────────────
+
+import aatlas.texture;  // TextureAtlas, AtlasBakedEntry
+
+// ────────────────────────────────────────────────────────────
+// MODULE EXPORTS
+// ────────────────────────────────────────────────────────────
+
+export namespace almondnamespace::atlascache
+{
+    inline constexpr std::uint32_t kFormatVersion = 2;
+    inline constexpr std::array<char, 8> kMagic{ 'A', 'L', 'M', 'A', 'T', 'L', 'S', '\0' };
+    inline constexpr std::uint64_t kPageAlignment = 4096;
+
+    // ────────────────────────────────────────────────────────
+    // FILE LAYOUT
+    // ────────────────────────────────────────────────────────
+    // [FileHeader][EntryRecord * entryCount][names][pad][page 0]...[page N]
+    // Pages start on kPageAlignment so a mapped page never straddles them.
+
+    struct FileHeader
+    {
+        std::array<char, 8> magic{};
+        std::uint32_t formatVersion{};
+        std::uint32_t headerBytes{};
+        std::uint64_t contentHash{};
+        std::uint64_t metadataHash{};
+        std::uint32_t width{}, height{};
+        std::uint32_t padding{};
+        std::uint8_t  packer{};
+        std::uint8_t  extrude{};
+        std::uint8_t  reserved[2]{};
+        std::uint32_t pageCount{};
+        std::uint32_t entryCount{};
+        std::uint64_t namesOffset{}, namesBytes{};
+        std::uint64_t pixelsOffset{};
+    };
+
+    struct EntryRecord
+    {
+        std::uint32_t page{};
+        std::uint32_t x{}, y{};
+        std::uint32_t width{}, height{};
+        std::uint32_t nameOffset{}, nameLength{};
+        std::uint32_t flags{}; // bit 0: slice
+    };
+
+    // ────────────────────────────────────────────────────────
+    // MAPPED FILE
+    // ────────────────────────────────────────────────────────
+
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+
+        explicit MappedFile(const std::filesystem::path& path)
+        {
+#if defined(_WIN32)
+            HANDLE file = ::CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file == INVALID_HANDLE_VALUE)
+                return;
+
+            LARGE_INTEGER size{};
+            if (::GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+                HANDLE mapping = ::CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                if (mapping) {
+                    if (void* view = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0)) {
+                        ptr = static_cast<const std::uint8_t*>(view);
+                        bytes = static_cast<std::size_t>(size.QuadPart);
+                    }
+                    ::CloseHandle(mapping);
+                }
+            }
+            ::CloseHandle(file);
+#else
+            const int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0)
+                return;
+
+            struct stat st {};
+            if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+                void* view = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                if (view != MAP_FAILED) {
+                    ptr = static_cast<const std::uint8_t*>(view);
+                    bytes = static_cast<std::size_t>(st.st_size);
+                }
+            }
+            ::close(fd);
+#endif
+        }
+
+        ~MappedFile() { reset(); }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        MappedFile(MappedFile&& other) noexcept
+            : ptr(std::exchange(other.ptr, nullptr)), bytes(std::exchange(other.bytes, 0))
+        {
+        }
+
+        MappedFile& operator=(MappedFile&& other) noexcept
+        {
+            if (this != &other) {
+                reset();
+                ptr = std::exchange(other.ptr, nullptr);
+                bytes = std::exchange(other.bytes, 0);
+            }
+            return *this;
+        }
+
+        [[nodiscard]] bool is_open() const noexcept { return ptr != nullptr; }
+        [[nodiscard]] const std::uint8_t* data() const noexcept { return ptr; }
+        [[nodiscard]] std::size_t size() const noexcept { return bytes; }
+        [[nodiscard]] std::span<const std::uint8_t> bytes_view() const noexcept { return { ptr, bytes }; }
+
+    private:
+        void reset() noexcept
+        {
+            if (!ptr)
+                return;
+#if defined(_WIN32)
+            ::UnmapViewOfFile(ptr);
+#else
+            ::munmap(const_cast<std::uint8_t*>(ptr), bytes);
+#endif
+            ptr = nullptr;
+            bytes = 0;
+        }
+
+        const std::uint8_t* ptr{ nullptr };
+        std::size_t bytes{ 0 };
+    };
+
+    // ────────────────────────────────────────────────────────
+    // CONTENT HASH
+    // ────────────────────────────────────────────────────────
+
+    // Word-at-a-time mix; only needs to tell source sets apart, not resist attacks.
+    [[nodiscard]] inline std::uint64_t hash_bytes(std::span<const std::uint8_t> data, std::uint64_t seed) noexcept
+    {
+        constexpr std::uint64_t kMul = 0x9E3779B97F4A7C15ull;
+        std::uint64_t h = seed ^ (data.size() * kMul);
+
+        std::size_t i = 0;
+        for (; i + 8 <= data.size(); i += 8) {
+            std::uint64_t word;
+            std::memcpy(&word, data.data() + i, 8);
+            h = (h ^ word) * kMul;
+            h ^= h >> 29;
+        }
+        for (; i < data.size(); ++i)
+            h = (h ^ data[i]) * 0x100000001B3ull;
+
+        h ^= h >> 32;
+        return h * kMul;
+    }
+
+    [[nodiscard]] inline std::uint64_t hash_string(std::string_view text, std::uint64_t seed) noexcept
+    {
+        return hash_bytes({ reinterpret_cast<const std::uint8_t*>(text.data()), text.size() }, seed);
+    }
+
+    [[nodiscard]] inline std::uint64_t hash_layout(const TextureAtlas& atlas) noexcept
+    {
+        const std::uint32_t layout[] = {
+            atlas.width, atlas.height, atlas.padding,
+            static_cast<std::uint32_t>(atlas.packer_kind()), atlas.extrude_edges ? 1u : 0u
+        };
+        return hash_bytes({ reinterpret_cast<const std::uint8_t*>(layout), sizeof(layout) }, kFormatVersion);
+    }
+
+    // Hashes the atlas layout parameters and every source file's path and bytes.
+    // Missing files hash as such, so adding one later invalidates the cache.
+    [[nodiscard]] inline std::uint64_t hash_sources(
+        const TextureAtlas& atlas, std::span<const std::filesystem::path> sources)
+    {
+        std::uint64_t h = hash_layout(atlas);
+        for (const auto& source : sources) {
+            h = hash_string(source.generic_string(), h);
+            const MappedFile file{ source };
+            h = file.is_open() ? hash_bytes(file.bytes_view(), h) : hash_string("<missing>", h);
+        }
+        return h;
+    }
+
+    // Like hash_sources(), but over each file's size and modification time
+    // instead of its bytes: one stat per source.
+    [[nodiscard]] inline std::uint64_t hash_source_metadata(
+        const TextureAtlas& atlas, std::span<const std::filesystem::path> sources)
+    {
+        std::uint64_t h = hash_layout(atlas);
+        for (const auto& source : sources) {
+            h = hash_string(source.generic_string(), h);
+            std::error_code sizeError, timeError;
+            const auto size = std::filesystem::file_size(source, sizeError);
+            const auto time = std::filesystem::last_write_time(source, timeError);
+            if (sizeError || timeError) {
+                h = hash_string("<missing>", h);
+                continue;
+            }
+            const std::uint64_t stamp[] = {
+                static_cast<std::uint64_t>(size),
+                static_cast<std::uint64_t>(time.time_since_epoch().count())
+            };
+            h = hash_bytes({ reinterpret_cast<const std::uint8_t*>(stamp), sizeof(stamp) }, h);
+        }
+        return h;
+    }
+
+    // What a cache is keyed on. `contentHash` is filled in lazily by open().
+    struct SourceKey
+    {
+        std::uint64_t metadataHash{};
+        std::uint64_t contentHash{};
+        bool contentHashed = false;
+    };
+
+    // `directory + id + extension` for each id, in order.
+    template<typename Ids>
+    [[nodiscard]] std::vector<std::filesystem::path> asset_paths(
+        std::string_view directory, const Ids& ids, std::string_view extension = ".ppm")
+    {
+        std::vector<std::filesystem::path> paths;
+        for (const auto& id : ids) {
+            std::string path{ directory };
+            path.append(std::string_view{ id });
+            path.append(extension);
+            paths.emplace_back(std::move(path));
+        }
+        return paths;
+    }
+
+    namespace detail
+    {
+        [[nodiscard]] inline std::filesystem::path executable_dir()
+        {
+#if defined(_WIN32)
+            std::wstring buffer(32768, L'\0');
+            const DWORD n = ::GetModuleFileNameW(nullptr, buffer.data(), static_cast<DWORD>(buffer.size()));
+            if (n == 0 || n >= buffer.size())
+                return {};
+            buffer.resize(n);
+            return std::filesystem::path{ buffer }.parent_path();
+#else
+            std::vector<char> buffer(4096, '\0');
+            const ssize_t n = ::readlink("/proc/self/exe", buffer.data(), buffer.size() - 1);
+            if (n <= 0 || static_cast<std::size_t>(n) >= buffer.size() - 1)
+                return {};
+            return std::filesystem::path{ std::string{ buffer.data(), static_cast<std::size_t>(n) } }.parent_path();
+#endif
+        }
+
+        [[nodiscard]] inline std::filesystem::path env_cache_dir()
+        {
+#if defined(_WIN32)
+            char* envBuf = nullptr;
+            std::size_t len = 0;
+            if (_dupenv_s(&envBuf, &len, "ALMOND_ATLAS_CACHE_DIR") == 0 && envBuf) {
+                std::filesystem::path envPath{ envBuf };
+                free(envBuf);
+                return envPath;
+            }
+            return {};
+#else
+            if (const char* envValue = std::getenv("ALMOND_ATLAS_CACHE_DIR"))
+                return std::filesystem::path{ envValue };
+            return {};
+#endif
+        }
+
+        // ALMOND_ATLAS_CACHE_DIR if set; otherwise `cache/atlas` under the first of
+        // the working directory, its parent and the executable's directory that
+        // holds `assets/`, falling back to the executable's directory.
+        [[nodiscard]] inline std::filesystem::path resolve_cache_dir()
+        {
+            if (std::filesystem::path envPath = env_cache_dir(); !envPath.empty())
+                return envPath;
+
+            std::error_code ec;
+            const std::filesystem::path cwd = std::filesystem::current_path(ec);
+            const std::filesystem::path exeDir = executable_dir();
+            const std::array<std::filesystem::path, 3> roots{
+                cwd, cwd.empty() ? std::filesystem::path{} : cwd.parent_path(), exeDir
+            };
+            for (const auto& root : roots) {
+                if (!root.empty() && std::filesystem::is_directory(root / "assets", ec))
+                    return root / "cache" / "atlas";
+            }
+            return (exeDir.empty() ? cwd : exeDir) / "cache" / "atlas";
+        }
+    }
+
+    // Resolved once, so a later change of working directory cannot split the cache.
+    [[nodiscard]] inline std::filesystem::path cache_path(std::string_view atlasName)
+    {
+        static const std::filesystem::path directory = detail::resolve_cache_dir();
+        return directory / (std::string{ atlasName } + ".almatlas");
+    }
+
+    // ────────────────────────────────────────────────────────
+    // WRITE
+    // ────────────────────────────────────────────────────────
+
+    // Writes `primary` and its overflow pages. The file is written beside the
+    // target and renamed into place so a reader never maps a partial cache.
+    inline bool write(const std::filesystem::path& path, const SourceKey& key, const TextureAtlas& primary)
+    {
+        std::vector<const TextureAtlas*> pages{ &primary };
+        for (const auto* page : primary.overflow_pages())
+            pages.push_back(page);
+
+        std::vector<EntryRecord> records;
+        std::string names;
+        for (std::uint32_t p = 0; p < pages.size(); ++p) {
+            for (const auto& entry : pages[p]->baked_entries()) {
+                records.push_back({ p, entry.x, entry.y, entry.width, entry.height,
+                    static_cast<std::uint32_t>(names.size()), static_cast<std::uint32_t>(entry.name.size()),
+                    entry.slice ? 1u : 0u });
+                names.append(entry.name);
+            }
+        }
+
+        const std::uint64_t pageBytes = static_cast<std::uint64_t>(primary.width) * primary.height * 4;
+
+        FileHeader header{};
+        header.magic = kMagic;
+        header.formatVersion = kFormatVersion;
+        header.headerBytes = sizeof(FileHeader);
+        header.contentHash = key.contentHash;
+        header.metadataHash = key.metadataHash;
+        header.width = primary.width;
+        header.height = primary.height;
+        header.padding = primary.padding;
+        header.packer = static_cast<std::uint8_t>(primary.packer_kind());
+        header.extrude = primary.extrude_edges ? 1 : 0;
+        header.pageCount = static_cast<std::uint32_t>(pages.size());
+        header.entryCount = static_cast<std::uint32_t>(records.size());
+        header.namesOffset = sizeof(FileHeader) + records.size() * sizeof(EntryRecord);
+        header.namesBytes = names.size();
+        header.pixelsOffset = (header.namesOffset + header.namesBytes + kPageAlignment - 1) / kPageAlignment * kPageAlignment;
+
+        std::error_code ec;
+        std::filesystem::create_directories(path.parent_path(), ec);
+
+        auto temp = path;
+        temp += ".tmp";
+
+        // Once the temp file exists, no failure below leaves it behind.
+        struct TempGuard
+        {
+            const std::filesystem::path& temp;
+            bool armed = false;
+            ~TempGuard()
+            {
+                if (!armed)
+                    return;
+                std::error_code ignored;
+                std::filesystem::remove(temp, ignored);
+            }
+        } tempGuard{ temp };
+
+        {
+            std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+            if (!out) {
+                std::cerr << "[AtlasCache] Cannot write '" << temp.string() << "'\n";
+                return false;
+            }
+            tempGuard.armed = true;
+
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.write(reinterpret_cast<const char*>(records.data()),
+                static_cast<std::streamsize>(records.size() * sizeof(EntryRecord)));
+            out.write(names.data(), static_cast<std::streamsize>(names.size()));
+
+            const std::vector<char> pad(static_cast<std::size_t>(header.pixelsOffset - header.namesOffset - header.namesBytes), 0);
+            out.write(pad.data(), static_cast<std::streamsize>(pad.size()));
+
+            for (const auto* page : pages) {
+                if (page->pixel_data.size() != pageBytes) {
+                    std::cerr << "[AtlasCache] Page '" << page->name << "' has no pixel data\n";
+                    return false;
+                }
+                out.write(reinterpret_cast<const char*>(page->pixel_data.data()), static_cast<std::streamsize>(pageBytes));
+            }
+
+            if (!out) {
+                std::cerr << "[AtlasCache] Failed writing '" << temp.string() << "'\n";
+                return false;
+            }
+        }
+
+        std::filesystem::rename(temp, path, ec);
+        if (ec) {
+            std::cerr << "[AtlasCache] Cannot replace '" << path.string() << "': " << ec.message() << "\n";
+            return false;
+        }
+        tempGuard.armed = false;
+        return true;
+    }
+
+    // ────────────────────────────────────────────────────────
+    // READ
+    // ────────────────────────────────────────────────────────
+
+    // A validated, mapped cache. Page pixels point straight into the mapping.
+    struct BakedAtlas
+    {
+        MappedFile file;
+        FileHeader header{};
+        std::vector<std::vector<AtlasBakedEntry>> pageEntries;
+        bool staleMetadata = false; // matched by content only; see restamp()
+
+        [[nodiscard]] std::uint32_t page_count() const noexcept { return header.pageCount; }
+
+        [[nodiscard]] std::span<const std::uint8_t> page_pixels(std::uint32_t page) const noexcept
+        {
+            const std::size_t pageBytes = static_cast<std::size_t>(header.width) * header.height * 4;
+            return file.bytes_view().subspan(static_cast<std::size_t>(header.pixelsOffset) + page * pageBytes, pageBytes);
+        }
+    };
+
+    // Maps `path` and checks it was baked from `sources` with `atlas`'s layout.
+    // `key.metadataHash` must be set; when the cache's differs, or on a miss,
+    // the sources are hashed into `key.contentHash` for the comparison or the
+    // bake that follows.
+    [[nodiscard]] inline std::optional<BakedAtlas> open(const std::filesystem::path& path,
+        std::span<const std::filesystem::path> sources, SourceKey& key, const TextureAtlas& atlas)
+    {
+        auto ensure_content_hash = [&] {
+            if (!key.contentHashed) {
+                key.contentHash = hash_sources(atlas, sources);
+                key.contentHashed = true;
+            }
+        };
+        auto miss = [&] {
+            ensure_content_hash();
+            return std::nullopt;
+        };
+
+        BakedAtlas baked{ MappedFile{ path } };
+        if (!baked.file.is_open() || baked.file.size() < sizeof(FileHeader))
+            return miss();
+
+        auto& h = baked.header;
+        std::memcpy(&h, baked.file.data(), sizeof(FileHeader));
+        if (h.magic != kMagic || h.formatVersion != kFormatVersion || h.headerBytes != sizeof(FileHeader))
+            return miss();
+
+        if (h.metadataHash != key.metadataHash) {
+            ensure_content_hash();
+            if (h.contentHash != key.contentHash)
+                return std::nullopt;
+            baked.staleMetadata = true;
+        }
+
+        if (h.width != atlas.width || h.height != atlas.height || h.padding != atlas.padding
+            || h.packer != static_cast<std::uint8_t>(atlas.packer_kind()) || h.extrude != (atlas.extrude_edges ? 1 : 0)
+            || h.pageCount == 0 || h.pageCount > atlas.max_pages)
+            return miss();
+
+        const std::uint64_t pageBytes = static_cast<std::uint64_t>(h.width) * h.height * 4;
+        const std::uint64_t recordsEnd = sizeof(FileHeader) + static_cast<std::uint64_t>(h.entryCount) * sizeof(EntryRecord);
+        if (h.namesOffset != recordsEnd || h.namesOffset + h.namesBytes > h.pixelsOffset
+            || h.pixelsOffset + h.pageCount * pageBytes > baked.file.size()) {
+            std::cerr << "[AtlasCache] Ignoring truncated cache '" << path.string() << "'\n";
+            return miss();
+        }
+
+        const auto* names = reinterpret_cast<const char*>(baked.file.data() + h.namesOffset);
+        baked.pageEntries.resize(h.pageCount);
+        for (std::uint32_t i = 0; i < h.entryCount; ++i) {
+            EntryRecord record{};
+            std::memcpy(&record, baked.file.data() + sizeof(FileHeader) + i * sizeof(EntryRecord), sizeof(record));
+
+            if (record.page >= h.pageCount
+                || static_cast<std::uint64_t>(record.nameOffset) + record.nameLength > h.namesBytes
+                || static_cast<std::uint64_t>(record.x) + record.width > h.width
+                || static_cast<std::uint64_t>(record.y) + record.height > h.height) {
+                std::cerr << "[AtlasCache] Ignoring corrupt cache '" << path.string() << "'\n";
+                return miss();
+            }
+
+            baked.pageEntries[record.page].push_back({
+                std::string{ names + record.nameOffset, record.nameLength },
+                record.x, record.y, record.width, record.height, (record.flags & 1u) != 0 });
+        }
+
+        if (!key.contentHashed) {
+            key.contentHash = h.contentHash;
+            key.contentHashed = true;
+        }
+        return baked;
+    }
+
+    // Records `metadataHash` in a cache open() matched by content only (the
+    // sources were touched or checked out again), so the next launch matches
+    // on metadata alone. Call once the mapping is released.
+    inline bool restamp(const std::filesystem::path& path, std::uint64_t metadataHash)
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        if (!file)
+            return false;
+        file.seekp(static_cast<std::streamoff>(offsetof(FileHeader, metadataHash)));
+        file.write(reinterpret_cast<const char*>(&metadataHash), sizeof(metadataHash));
+        return static_cast<bool>(file);
+    }
+}
@@ -5,13 +5,17 @@ import aengine.platform;
 
 import asprite.pool;
 import aatlas.texture;
+import aatlas.cache;
+import atexture;
 import aspriteregistry;
 import aspritehandle;
 import aengine.context.type;
+import aengine.telemetry;
 
 import <atomic>;
 import <cstdint>;
 import <exception>;
+import <filesystem>;
 import <functional>;
 import <iostream>;
 import <memory>;
@@ -19,6 +23,7 @@ import <mutex>;
 import <optional>;
 import <queue>;
 import <shared_mutex>;
+import <span>;
 import <string>;
 import <tuple>;
 import <unordered_map>;
@@ -49,6 +54,9 @@ export namespace almondnamespace::atlasmanager
     // Stable pointers to heap atlases.
     export inline std::vector<const TextureAtlas*> atlas_vector{};
 
+    export inline std::optional<AtlasEntry> add_entry_with_overflow(
+        TextureAtlas& primary, const std::string& id, const Texture& tex, TextureAtlas*& outPage);
+
     export struct AtlasRegistrar
     {
         TextureAtlas& atlas;
@@ -98,7 +106,8 @@ export namespace almondnamespace::atlasmanager
 
             Texture tex{ 0, name, width, height, 4, pixels };
 
-            auto addedOpt = sharedAtlas.add_entry(name, tex);
+            TextureAtlas* page = &sharedAtlas;
+            auto addedOpt = add_entry_with_overflow(sharedAtlas, name, tex, page);
             if (!addedOpt)
             {
                 std::cerr << "[AtlasRegistrar] Failed to add '" << name << "' to atlas\n";
@@ -117,7 +126,7 @@ export namespace almondnamespace::atlasmanager
             SpriteHandle handle{
                 allocated.id,
                 allocated.generation,
-                static_cast<std::uint32_t>(sharedAtlas.index),
+                static_cast<std::uint32_t>(page->index),
                 static_cast<std::uint32_t>(added.index)
             };
 
@@ -177,6 +186,15 @@ export namespace almondnamespace::atlasmanager
         };
 
         inline std::mutex backendMutex{};
+        inline std::mutex overflowMutex{};
+
+        // Source key of each atlas whose cache lookup missed, for bake_atlas().
+        inline std::mutex bakeMutex{};
+        inline std::unordered_map<std::string, atlascache::SourceKey> pendingBakes{};
+
+        // Bytes handed to each backend's texture API since its last process_pending_uploads().
+        inline std::unordered_map<core::ContextType, std::uint64_t> uploadBytes{};
+        inline std::unordered_map<core::ContextType, std::uint64_t> uploadCount{};
         inline std::unordered_map<core::ContextType, BackendUploadState> backendStates{};
 
         inline thread_local bool processingUploads = false;
@@ -251,6 +269,212 @@ export namespace almondnamespace::atlasmanager
         return (it != registrar_map.end()) ? it->second.get() : nullptr;
     }
 
+    // Creates the next overflow page of `primary` and publishes it like any other atlas.
+    export inline TextureAtlas* create_overflow_page(TextureAtlas& primary)
+    {
+        const auto existing = primary.overflow_pages();
+        if (existing.size() + 1 >= primary.max_pages)
+        {
+            std::cerr << "[create_overflow_page] Atlas '" << primary.name << "' reached its page limit ("
+                << primary.max_pages << ")\n";
+            return nullptr;
+        }
+
+        AtlasConfig config = primary.page_config(static_cast<u32>(existing.size() + 1));
+        config.index = nextAtlasIndex.fetch_add(1, std::memory_order_relaxed);
+
+        TextureAtlas* pagePtr = nullptr;
+
+        {
+            std::unique_lock<std::shared_mutex> atlasLock(atlasMutex);
+
+            auto up = std::make_unique<TextureAtlas>();
+            if (!up->init(config))
+            {
+                std::cerr << "[create_overflow_page] Failed to initialize page '" << config.name << "'\n";
+                return nullptr;
+            }
+
+            pagePtr = up.get();
+            primary.attach_page(*pagePtr);
+            atlas_map.emplace(config.name, std::move(up));
+
+            update_atlas_vector_locked();
+        }
+
+        notify_backends_of_new_atlas(*pagePtr);
+        return pagePtr;
+    }
+
+    // Adds `tex` to the first page of `primary` with room, creating a new page when
+    // all of them are full. `outPage` receives the page the entry landed on.
+    inline std::optional<AtlasEntry> add_entry_with_overflow(
+        TextureAtlas& primary, const std::string& id, const Texture& tex, TextureAtlas*& outPage)
+    {
+        auto try_page = [&](TextureAtlas& page, bool& full) -> std::optional<AtlasEntry>
+            {
+                auto added = page.add_entry(id, tex, &full);
+                if (added)
+                    outPage = &page;
+                return added;
+            };
+
+        bool full = false;
+        if (auto added = try_page(primary, full))
+            return added;
+        if (!full)
+            return std::nullopt;
+
+        // Serialize page creation so concurrent registrations don't each add a page.
+        std::scoped_lock lock(detail::overflowMutex);
+
+        for (auto* page : primary.overflow_pages())
+        {
+            if (auto added = try_page(*page, full))
+                return added;
+            if (!full)
+                return std::nullopt;
+        }
+
+        auto* page = create_overflow_page(primary);
+        if (!page)
+        {
+            std::cerr << "[Atlas] Failed to pack '" << id << "' (no pages left)\n";
+            return std::nullopt;
+        }
+
+        return try_page(*page, full);
+    }
+
+    // ────────────────────────────────────────────────────────
+    // BAKED ATLAS CACHE
+    // ────────────────────────────────────────────────────────
+
+    // Restores the freshly created atlas `name` from its baked cache when the
+    // cache was built from the same `sources`, registering every sprite it holds
+    // so callers find them in `registry` without decoding anything. On a miss
+    // the source key is remembered for a later bake_atlas(name).
+    export inline bool load_baked_atlas(const std::string& name, std::span<const std::filesystem::path> sources)
+    {
+        TextureAtlas* primary = nullptr;
+        {
+            std::shared_lock lock(atlasMutex);
+            if (auto it = atlas_map.find(name); it != atlas_map.end())
+                primary = it->second.get();
+        }
+        if (!primary || primary->entry_count() != 0)
+            return false;
+
+        const auto path = atlascache::cache_path(name);
+        atlascache::SourceKey key{ .metadataHash = atlascache::hash_source_metadata(*primary, sources) };
+        auto baked = atlascache::open(path, sources, key, *primary);
+        if (!baked)
+        {
+            std::scoped_lock lock(detail::bakeMutex);
+            detail::pendingBakes[name] = key;
+            return false;
+        }
+
+        // Every page is restored before any sprite is registered. When one
+        // fails the pages before it are emptied again, so the full build that
+        // follows does not trip over their entries.
+        std::vector<TextureAtlas*> pages;
+        pages.reserve(baked->page_count());
+        for (u32 p = 0; p < baked->page_count(); ++p)
+        {
+            TextureAtlas* page = (p == 0) ? primary : create_overflow_page(*primary);
+            if (!page || !page->restore_baked(baked->pageEntries[p], baked->page_pixels(p)))
+            {
+                for (TextureAtlas* restored : pages)
+                    restored->reset_entries();
+
+                std::cerr << "[AtlasCache] Falling back to a full build of '" << name << "'\n";
+                std::scoped_lock lock(detail::bakeMutex);
+                detail::pendingBakes[name] = key;
+                return false;
+            }
+            pages.push_back(page);
+        }
+
+        for (u32 p = 0; p < baked->page_count(); ++p)
+        {
+            TextureAtlas* page = pages[p];
+            for (std::size_t i = 0; i < baked->pageEntries[p].size(); ++i)
+            {
+                const auto& entry = baked->pageEntries[p][i];
+                auto allocated = allocate();
+                if (!allocated.is_valid())
+                {
+                    std::cerr << "[AtlasCache] Failed to allocate spritepool handle for '" << entry.name << "'\n";
+                    continue;
+                }
+
+                AtlasRegion region{};
+                page->try_get_entry_info(static_cast<int>(i), region);
+
+                SpriteHandle handle{
+                    allocated.id,
+                    allocated.generation,
+                    static_cast<std::uint32_t>(page->index),
+                    static_cast<std::uint32_t>(i)
+                };
+
+                registry.add(entry.name, handle,
+                    region.u1,
+                    region.v1,
+                    region.u2 - region.u1,
+                    region.v2 - region.v1);
+            }
+        }
+
+        if (baked->staleMetadata)
+        {
+            baked.reset();
+            atlascache::restamp(path, key.metadataHash);
+        }
+        return true;
+    }
+
+    // Writes the cache for `name` if load_baked_atlas() missed for it.
+    export inline bool bake_atlas(const std::string& name)
+    {
+        atlascache::SourceKey key{};
+        {
+            std::scoped_lock lock(detail::bakeMutex);
+            auto it = detail::pendingBakes.find(name);
+            if (it == detail::pendingBakes.end())
+                return false;
+            key = it->second;
+            detail::pendingBakes.erase(it);
+        }
+
+        const TextureAtlas* primary = nullptr;
+        {
+            std::shared_lock lock(atlasMutex);
+            if (auto it = atlas_map.find(name); it != atlas_map.end())
+                primary = it->second.get();
+        }
+        if (!primary)
+            return false;
+
+        return atlascache::write(atlascache::cache_path(name), key, *primary);
+    }
+
+    // Restores atlas `name` from its baked cache when it matches `sources`,
+    // then runs `register_sprites`: restored sprites are already in `registry`,
+    // so it only decodes what the cache lacked. On a miss the atlas it built is
+    // baked for the next run. Returns true when the cache was used.
+    export template<typename RegisterFn>
+    bool load_or_bake_atlas(const std::string& name, std::span<const std::filesystem::path> sources,
+        RegisterFn&& register_sprites)
+    {
+        const bool restored = load_baked_atlas(name, sources);
+        register_sprites();
+        if (!restored)
+            bake_atlas(name);
+        return restored;
+    }
+
     // Snapshot-by-value only (safe).
     export inline std::vector<const TextureAtlas*> get_atlas_vector_snapshot()
     {
@@ -269,6 +493,7 @@ export namespace almondnamespace::atlasmanager
         state.pending = {};
         state.pendingVersions.clear();
         state.uploadedVersions.clear();
+        atlas_grace::enter(static_cast<int>(type));
 
         std::shared_lock atlasLock(atlasMutex);
         for (auto& [_, up] : atlas_map)
@@ -279,6 +504,22 @@ export namespace almondnamespace::atlasmanager
     {
         std::scoped_lock lock(detail::backendMutex);
         detail::backendStates.erase(type);
+        atlas_grace::leave(static_cast<int>(type));
+    }
+
+    // Registered backends call this once per frame from their render thread,
+    // at a point where they hold no atlas texels or entry slots from earlier
+    // frames. Memory an atlas retired before every registered backend has
+    // passed here since is freed.
+    export inline void mark_quiescent(core::ContextType type)
+    {
+        atlas_grace::quiescent(static_cast<int>(type));
+        if (!atlas_grace::has_pending())
+            return;
+
+        std::shared_lock lock(atlasMutex);
+        for (auto& [_, up] : atlas_map)
+            up->reclaim_retired();
     }
 
     export inline void enqueue_upload_for_all(const TextureAtlas& atlas)
@@ -292,11 +533,38 @@ export namespace almondnamespace::atlasmanager
         }
     }
 
+    // Backends call this from their uploaders with the bytes actually sent.
+    export inline void record_upload_bytes(core::ContextType type, std::size_t bytes)
+    {
+        std::scoped_lock lock(detail::backendMutex);
+        detail::uploadBytes[type] += bytes;
+        ++detail::uploadCount[type];
+    }
+
     export inline void process_pending_uploads(core::ContextType type)
     {
         if (detail::processingUploads)
             return;
 
+        // Flush the previous frame's upload traffic for this backend.
+        {
+            std::uint64_t bytes = 0;
+            std::uint64_t count = 0;
+            {
+                std::scoped_lock lock(detail::backendMutex);
+                bytes = std::exchange(detail::uploadBytes[type], 0);
+                count = std::exchange(detail::uploadCount[type], 0);
+            }
+
+            if (count > 0)
+            {
+                telemetry::emit_counter("renderer.atlas.upload_bytes",
+                    static_cast<std::int64_t>(bytes), telemetry::RendererTelemetryTags{ type, 0, "atlas" });
+                telemetry::emit_counter("renderer.atlas.upload_count",
+                    static_cast<std::int64_t>(count), telemetry::RendererTelemetryTags{ type, 0, "atlas" });
+            }
+        }
+
         std::vector<detail::PendingUpload> tasks{};
         std::function<void(const TextureAtlas&)> ensure{};
 
@@ -385,6 +653,8 @@ export namespace almondnamespace::atlasmanager
     export inline void ensure_uploaded(const TextureAtlas& atlas)
     {
         enqueue_upload_for_all(atlas);
+        for (const auto* page : atlas.overflow_pages())
+            enqueue_upload_for_all(*page);
 
         if (detail::activeBackend && !detail::processingUploads)
             process_pending_uploads(*detail::activeBackend);
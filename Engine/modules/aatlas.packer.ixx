@@ -0,0 +1,391 @@
+/**************************************************************
+ *   AlmondShell - Modular C++ Framework
+ **************************************************************/
+
+module;
+
+export module aatlas.packer;
+
+// ────────────────────────────────────────────────────────────
+// STANDARD LIBRARY IMPORTS
+// ────────────────────────────────────────────────────────────
+
+import <algorithm>;
+import <cstdint>;
+import <limits>;
+import <optional>;
+import <utility>;
+import <variant>;
+import <vector>;
+
+// ────────────────────────────────────────────────────────────
+// MODULE EXPORTS
+// ────────────────────────────────────────────────────────────
+
+export namespace almondnamespace
+{
+    // ────────────────────────────────────────────────────────
+    // PACKER KIND
+    // ────────────────────────────────────────────────────────
+
+    enum class AtlasPackerKind : std::uint8_t
+    {
+        Scan,       // legacy occupancy-grid first-fit (O(W*H*w*h) per insert)
+        Skyline,    // skyline bottom-left
+        MaxRects    // MaxRects, best short side fit
+    };
+
+    struct PackerRect
+    {
+        std::uint32_t x{}, y{};
+        std::uint32_t width{}, height{};
+    };
+
+    // ────────────────────────────────────────────────────────
+    // SCAN PACKER (legacy)
+    // ────────────────────────────────────────────────────────
+    // Kept for comparison and for callers that rely on the old
+    // row-major first-fit placement.
+
+    struct ScanPacker
+    {
+        std::uint32_t width{ 0 };
+        std::uint32_t height{ 0 };
+        std::vector<std::vector<bool>> occupancy;
+
+        void reset(std::uint32_t w, std::uint32_t h)
+        {
+            width = w;
+            height = h;
+            occupancy.assign(height, std::vector<bool>(width, false));
+        }
+
+        std::optional<std::pair<std::uint32_t, std::uint32_t>> pack(std::uint32_t w, std::uint32_t h)
+        {
+            for (std::uint32_t y = 0; y + h <= height; ++y) {
+                for (std::uint32_t x = 0; x + w <= width; ++x) {
+                    if (can_place(x, y, w, h)) {
+                        mark_used(x, y, w, h);
+                        return { std::pair{ x, y } };
+                    }
+                }
+            }
+
+            return std::nullopt;
+        }
+
+    private:
+        bool can_place(std::uint32_t x, std::uint32_t y, std::uint32_t w, std::uint32_t h) const
+        {
+            for (std::uint32_t dy = 0; dy < h; ++dy) {
+                for (std::uint32_t dx = 0; dx < w; ++dx) {
+                    if (occupancy[y + dy][x + dx]) {
+                        return false;
+                    }
+                }
+            }
+
+            return true;
+        }
+
+        void mark_used(std::uint32_t x, std::uint32_t y, std::uint32_t w, std::uint32_t h)
+        {
+            for (std::uint32_t dy = 0; dy < h; ++dy) {
+                for (std::uint32_t dx = 0; dx < w; ++dx) {
+                    occupancy[y + dy][x + dx] = true;
+                }
+            }
+        }
+    };
+
+    // ────────────────────────────────────────────────────────
+    // SKYLINE PACKER (bottom-left)
+    // ────────────────────────────────────────────────────────
+    // The atlas is y-down, so "bottom-left" here means the placement
+    // whose far edge (y + h) is closest to row 0, ties broken by the
+    // narrowest skyline segment. O(segments) per insert.
+
+    struct SkylinePacker
+    {
+        struct Segment
+        {
+            std::uint32_t x{}, y{}, width{};
+        };
+
+        std::uint32_t width{ 0 };
+        std::uint32_t height{ 0 };
+        std::vector<Segment> skyline;
+
+        void reset(std::uint32_t w, std::uint32_t h)
+        {
+            width = w;
+            height = h;
+            skyline.clear();
+            skyline.push_back({ 0, 0, width });
+        }
+
+        std::optional<std::pair<std::uint32_t, std::uint32_t>> pack(std::uint32_t w, std::uint32_t h)
+        {
+            if (w == 0 || h == 0 || w > width || h > height)
+                return std::nullopt;
+
+            std::size_t bestIndex = skyline.size();
+            std::uint32_t bestTop = (std::numeric_limits<std::uint32_t>::max)();
+            std::uint32_t bestWidth = (std::numeric_limits<std::uint32_t>::max)();
+            std::uint32_t bestY = 0;
+
+            for (std::size_t i = 0; i < skyline.size(); ++i) {
+                std::uint32_t y = 0;
+                if (!fits(i, w, h, y))
+                    continue;
+
+                const std::uint32_t top = y + h;
+                if (top < bestTop || (top == bestTop && skyline[i].width < bestWidth)) {
+                    bestIndex = i;
+                    bestTop = top;
+                    bestWidth = skyline[i].width;
+                    bestY = y;
+                }
+            }
+
+            if (bestIndex == skyline.size())
+                return std::nullopt;
+
+            const std::uint32_t x = skyline[bestIndex].x;
+            insert_segment(bestIndex, { x, bestY + h, w });
+            return { std::pair{ x, bestY } };
+        }
+
+    private:
+        // Rect of width w starting at segment i rests on the highest segment it spans.
+        bool fits(std::size_t i, std::uint32_t w, std::uint32_t h, std::uint32_t& outY) const
+        {
+            const std::uint32_t x = skyline[i].x;
+            if (x + w > width)
+                return false;
+
+            std::uint32_t remaining = w;
+            std::uint32_t y = skyline[i].y;
+            for (std::size_t j = i; remaining > 0; ++j) {
+                if (j >= skyline.size())
+                    return false;
+
+                y = (std::max)(y, skyline[j].y);
+                if (y + h > height)
+                    return false;
+
+                remaining = (skyline[j].width >= remaining) ? 0 : remaining - skyline[j].width;
+            }
+
+            outY = y;
+            return true;
+        }
+
+        void insert_segment(std::size_t index, const Segment& seg)
+        {
+            skyline.insert(skyline.begin() + static_cast<std::ptrdiff_t>(index), seg);
+
+            // Trim or drop the segments now shadowed by the new one.
+            for (std::size_t i = index + 1; i < skyline.size();) {
+                const auto& prev = skyline[i - 1];
+                auto& cur = skyline[i];
+                const std::uint32_t prevEnd = prev.x + prev.width;
+                if (cur.x >= prevEnd)
+                    break;
+
+                const std::uint32_t shrink = prevEnd - cur.x;
+                if (cur.width <= shrink) {
+                    skyline.erase(skyline.begin() + static_cast<std::ptrdiff_t>(i));
+                    continue;
+                }
+
+                cur.x += shrink;
+                cur.width -= shrink;
+                break;
+            }
+
+            // Merge neighbours at equal height.
+            for (std::size_t i = 0; i + 1 < skyline.size();) {
+                if (skyline[i].y == skyline[i + 1].y) {
+                    skyline[i].width += skyline[i + 1].width;
+                    skyline.erase(skyline.begin() + static_cast<std::ptrdiff_t>(i + 1));
+                }
+                else {
+                    ++i;
+                }
+            }
+        }
+    };
+
+    // ────────────────────────────────────────────────────────
+    // MAXRECTS PACKER (best short side fit)
+    // ────────────────────────────────────────────────────────
+    // Tracks maximal free rectangles. Pruning only compares the
+    // rectangles produced by the latest split against the existing
+    // list, so an insert is O(free * new) instead of O(free^2).
+
+    struct MaxRectsPacker
+    {
+        std::uint32_t width{ 0 };
+        std::uint32_t height{ 0 };
+        std::vector<PackerRect> freeRects;
+
+        void reset(std::uint32_t w, std::uint32_t h)
+        {
+            width = w;
+            height = h;
+            freeRects.clear();
+            freeRects.push_back({ 0, 0, width, height });
+            newRects.clear();
+        }
+
+        std::optional<std::pair<std::uint32_t, std::uint32_t>> pack(std::uint32_t w, std::uint32_t h)
+        {
+            if (w == 0 || h == 0)
+                return std::nullopt;
+
+            std::size_t bestIndex = freeRects.size();
+            std::uint32_t bestShort = (std::numeric_limits<std::uint32_t>::max)();
+            std::uint32_t bestLong = (std::numeric_limits<std::uint32_t>::max)();
+
+            for (std::size_t i = 0; i < freeRects.size(); ++i) {
+                const auto& fr = freeRects[i];
+                if (fr.width < w || fr.height < h)
+                    continue;
+
+                const std::uint32_t leftoverW = fr.width - w;
+                const std::uint32_t leftoverH = fr.height - h;
+                const std::uint32_t shortSide = (std::min)(leftoverW, leftoverH);
+                const std::uint32_t longSide = (std::max)(leftoverW, leftoverH);
+
+                if (shortSide < bestShort || (shortSide == bestShort && longSide < bestLong)) {
+                    bestIndex = i;
+                    bestShort = shortSide;
+                    bestLong = longSide;
+                }
+            }
+
+            if (bestIndex == freeRects.size())
+                return std::nullopt;
+
+            const PackerRect placed{ freeRects[bestIndex].x, freeRects[bestIndex].y, w, h };
+            place(placed);
+            return { std::pair{ placed.x, placed.y } };
+        }
+
+    private:
+        std::vector<PackerRect> newRects;
+
+        static bool contains(const PackerRect& outer, const PackerRect& inner) noexcept
+        {
+            return inner.x >= outer.x && inner.y >= outer.y
+                && inner.x + inner.width <= outer.x + outer.width
+                && inner.y + inner.height <= outer.y + outer.height;
+        }
+
+        void place(const PackerRect& used)
+        {
+            newRects.clear();
+
+            for (std::size_t i = 0; i < freeRects.size();) {
+                if (split(freeRects[i], used)) {
+                    freeRects[i] = freeRects.back();
+                    freeRects.pop_back();
+                }
+                else {
+                    ++i;
+                }
+            }
+
+            prune();
+        }
+
+        // Returns true when `fr` intersects `used` and has been replaced by its remainders.
+        bool split(const PackerRect& fr, const PackerRect& used)
+        {
+            if (used.x >= fr.x + fr.width || used.x + used.width <= fr.x
+                || used.y >= fr.y + fr.height || used.y + used.height <= fr.y)
+                return false;
+
+            if (used.x > fr.x)
+                push_new({ fr.x, fr.y, used.x - fr.x, fr.height });
+            if (used.x + used.width < fr.x + fr.width)
+                push_new({ used.x + used.width, fr.y, fr.x + fr.width - (used.x + used.width), fr.height });
+            if (used.y > fr.y)
+                push_new({ fr.x, fr.y, fr.width, used.y - fr.y });
+            if (used.y + used.height < fr.y + fr.height)
+                push_new({ fr.x, used.y + used.height, fr.width, fr.y + fr.height - (used.y + used.height) });
+
+            return true;
+        }
+
+        void push_new(const PackerRect& r)
+        {
+            // Drop if an already-produced remainder covers it; evict the ones it covers.
+            for (std::size_t i = 0; i < newRects.size();) {
+                if (contains(newRects[i], r))
+                    return;
+                if (contains(r, newRects[i])) {
+                    newRects[i] = newRects.back();
+                    newRects.pop_back();
+                }
+                else {
+                    ++i;
+                }
+            }
+            newRects.push_back(r);
+        }
+
+        void prune()
+        {
+            for (const auto& fr : freeRects) {
+                for (std::size_t j = 0; j < newRects.size();) {
+                    if (contains(fr, newRects[j])) {
+                        newRects[j] = newRects.back();
+                        newRects.pop_back();
+                    }
+                    else {
+                        ++j;
+                    }
+                }
+            }
+
+            freeRects.insert(freeRects.end(), newRects.begin(), newRects.end());
+            newRects.clear();
+        }
+    };
+
+    // ────────────────────────────────────────────────────────
+    // ATLAS PACKER (dispatch)
+    // ────────────────────────────────────────────────────────
+
+    struct AtlasPacker
+    {
+        AtlasPackerKind kind{ AtlasPackerKind::Skyline };
+
+        void reset(AtlasPackerKind k, std::uint32_t w, std::uint32_t h)
+        {
+            kind = k;
+            usedArea = 0;
+            switch (kind) {
+            case AtlasPackerKind::Scan:     impl.emplace<ScanPacker>().reset(w, h); break;
+            case AtlasPackerKind::Skyline:  impl.emplace<SkylinePacker>().reset(w, h); break;
+            case AtlasPackerKind::MaxRects: impl.emplace<MaxRectsPacker>().reset(w, h); break;
+            }
+        }
+
+        std::optional<std::pair<std::uint32_t, std::uint32_t>> pack(std::uint32_t w, std::uint32_t h)
+        {
+            auto pos = std::visit([&](auto& p) { return p.pack(w, h); }, impl);
+            if (pos)
+                usedArea += static_cast<std::uint64_t>(w) * h;
+            return pos;
+        }
+
+        [[nodiscard]] std::uint64_t used_area() const noexcept { return usedArea; }
+
+    private:
+        std::variant<SkylinePacker, MaxRectsPacker, ScanPacker> impl{};
+        std::uint64_t usedArea{ 0 };
+    };
+}
@@ -17,16 +17,26 @@ import <optional>;
 import <iostream>;
 import <algorithm>;
 import <mutex>;
+import <array>;
+import <atomic>;
+import <iterator>;
 import <shared_mutex>; // legacy include; this module now uses recursive_mutex for atlas entry protection
 import <unordered_map>;
 import <memory>;    // std::unique_ptr
 import <utility>;   // std::pair
+import <span>;
+import <type_traits>;
+import <thread>;
 
 // ────────────────────────────────────────────────────────────
 // ENGINE DEPENDENCIES
 // ────────────────────────────────────────────────────────────
 
 import atexture;        // provides Texture
+import aengine.systems;                 // Task
+import aengine.taskgraph.dotsystem;     // taskgraph::TaskGraph, Node
+import aatlas.packer;   // AtlasPacker, AtlasPackerKind
+import amipmapatlas;    // mip::MipLevel, mip::build_levels
 
 // ────────────────────────────────────────────────────────────
 // MODULE EXPORTS
@@ -48,15 +58,52 @@ export namespace almondnamespace
         float u2{}, v2{};
         u32   x{}, y{};
         u32   width{}, height{};
+        u32   page{};   // 0 = primary atlas, N = Nth overflow page
 
         [[nodiscard]] float uv_width()  const noexcept { return u2 - u1; }
         [[nodiscard]] float uv_height() const noexcept { return v2 - v1; }
     };
 
+    // ────────────────────────────────────────────────────────
+    // ATLAS DIRTY RECT
+    // ────────────────────────────────────────────────────────
+
+    struct AtlasDirtyRect
+    {
+        u32 x{}, y{};
+        u32 width{}, height{};
+
+        [[nodiscard]] bool empty() const noexcept { return width == 0 || height == 0; }
+
+        [[nodiscard]] std::size_t byte_size() const noexcept
+        {
+            return static_cast<std::size_t>(width) * height * 4;
+        }
+
+        void merge(const AtlasDirtyRect& other) noexcept
+        {
+            if (other.empty())
+                return;
+            if (empty()) {
+                *this = other;
+                return;
+            }
+
+            const u32 x1 = (std::max)(x + width, other.x + other.width);
+            const u32 y1 = (std::max)(y + height, other.y + other.height);
+            x = (std::min)(x, other.x);
+            y = (std::min)(y, other.y);
+            width = x1 - x;
+            height = y1 - y;
+        }
+    };
+
     // ────────────────────────────────────────────────────────
     // ATLAS ENTRY
     // ────────────────────────────────────────────────────────
 
+    // `pixels` is only filled on the copy handed back by add_entry; the atlas
+    // keeps the texels in pixel_data and does not retain a second copy.
     struct AtlasEntry
     {
         int                 index{ -1 };
@@ -65,6 +112,7 @@ export namespace almondnamespace
         std::vector<u8>     pixels;
         u32                 texWidth{ 0 };
         u32                 texHeight{ 0 };
+        bool                slice{ false }; // view into another entry's texels
 
         AtlasEntry() = default;
 
@@ -85,6 +133,270 @@ export namespace almondnamespace
         }
     };
 
+    // ────────────────────────────────────────────────────────
+    // ATLAS GRACE PERIODS
+    // ────────────────────────────────────────────────────────
+    // Memory lock-free readers may still be using is retired with a stamp
+    // instead of freed. Readers (the backends, registered by atlasmanager)
+    // pass a quiescent point once per frame, where they hold nothing from
+    // earlier frames; memory is freed once every registered reader has passed
+    // one since it was retired. With no readers registered it goes at once.
+
+    namespace atlas_grace
+    {
+        namespace detail
+        {
+            struct State
+            {
+                std::mutex mutex;
+                u64 epoch{ 1 };
+                std::unordered_map<int, u64> readers; // reader -> epoch at its last quiescent point
+            };
+
+            inline State& state()
+            {
+                static State shared;
+                return shared;
+            }
+
+            inline std::atomic<u64> safe{ ~u64{ 0 } };   // stamps below this are unreachable
+            inline std::atomic<std::size_t> pending{ 0 }; // retirements not freed yet
+
+            inline void publish_locked(const State& s) noexcept
+            {
+                u64 oldest = ~u64{ 0 };
+                for (const auto& [_, epoch] : s.readers)
+                    oldest = (std::min)(oldest, epoch);
+                safe.store(oldest, std::memory_order_release);
+            }
+        }
+
+        // Call after unpublishing the memory; returns its stamp.
+        [[nodiscard]] inline u64 retire()
+        {
+            auto& s = detail::state();
+            std::lock_guard lock(s.mutex);
+            detail::pending.fetch_add(1, std::memory_order_relaxed);
+            return s.epoch++;
+        }
+
+        [[nodiscard]] inline bool expired(u64 stamp) noexcept
+        {
+            return stamp < detail::safe.load(std::memory_order_acquire);
+        }
+
+        inline void released(std::size_t count) noexcept
+        {
+            detail::pending.fetch_sub(count, std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] inline bool has_pending() noexcept
+        {
+            return detail::pending.load(std::memory_order_relaxed) != 0;
+        }
+
+        // A reader only sees memory published after it enters.
+        inline void enter(int reader)
+        {
+            auto& s = detail::state();
+            std::lock_guard lock(s.mutex);
+            s.readers[reader] = s.epoch;
+            detail::publish_locked(s);
+        }
+
+        inline void leave(int reader)
+        {
+            auto& s = detail::state();
+            std::lock_guard lock(s.mutex);
+            s.readers.erase(reader);
+            detail::publish_locked(s);
+        }
+
+        inline void quiescent(int reader)
+        {
+            auto& s = detail::state();
+            std::lock_guard lock(s.mutex);
+            auto it = s.readers.find(reader);
+            if (it == s.readers.end())
+                return;
+            it->second = s.epoch;
+            detail::publish_locked(s);
+        }
+    }
+
+    // ────────────────────────────────────────────────────────
+    // ATLAS ENTRY TABLE
+    // ────────────────────────────────────────────────────────
+    // Append-only entry storage. Slots live in fixed-size chunks that never
+    // move, and `count` is released only after a slot is fully built, so
+    // index reads (SpriteHandle::localIndex) need no lock. Names and sizes are
+    // immutable once published; regions rewritten in place by defragment()
+    // are covered by a sequence counter that readers retry on.
+    //
+    // Writers (append, relocate, clear, reclaim) must hold the atlas lock.
+    // clear() runs inside the sequence counter so try_read() retries rather
+    // than follow a chunk pointer being nulled, and retires its chunks to
+    // atlas_grace: they are freed by reclaim() once every backend has passed
+    // its per-frame quiescent point (atlasmanager::mark_quiescent()), so a
+    // reader still holding a slot from before the clear never touches freed
+    // memory.
+
+    class AtlasEntryTable
+    {
+    public:
+        static constexpr std::size_t kChunkBits = 9;
+        static constexpr std::size_t kChunkSize = std::size_t{ 1 } << kChunkBits;
+        static constexpr std::size_t kMaxChunks = 4096;
+
+        AtlasEntryTable() = default;
+        ~AtlasEntryTable()
+        {
+            if (!retired.empty())
+                atlas_grace::released(retired.size());
+        }
+        AtlasEntryTable(const AtlasEntryTable&) = delete;
+        AtlasEntryTable& operator=(const AtlasEntryTable&) = delete;
+
+        class const_iterator
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = AtlasEntry;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const AtlasEntry*;
+            using reference = const AtlasEntry&;
+
+            const_iterator() = default;
+            const_iterator(const AtlasEntryTable* t, std::size_t i) noexcept : table(t), index(i) {}
+
+            reference operator*() const noexcept { return (*table)[index]; }
+            pointer operator->() const noexcept { return &(*table)[index]; }
+            const_iterator& operator++() noexcept { ++index; return *this; }
+            const_iterator operator++(int) noexcept { auto copy = *this; ++index; return copy; }
+            bool operator==(const const_iterator& other) const noexcept { return index == other.index; }
+
+        private:
+            const AtlasEntryTable* table{ nullptr };
+            std::size_t index{ 0 };
+        };
+
+        [[nodiscard]] std::size_t size() const noexcept { return count.load(std::memory_order_acquire); }
+        [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+        [[nodiscard]] static constexpr std::size_t capacity() noexcept { return kChunkSize * kMaxChunks; }
+
+        [[nodiscard]] const_iterator begin() const noexcept { return { this, 0 }; }
+        [[nodiscard]] const_iterator end() const noexcept { return { this, size() }; }
+
+        // Writer side, or readers of fields that never change after publication.
+        [[nodiscard]] AtlasEntry& operator[](std::size_t i) noexcept { return slot(i); }
+        [[nodiscard]] const AtlasEntry& operator[](std::size_t i) const noexcept { return slot(i); }
+
+        template<typename... Args>
+        AtlasEntry& emplace_back(Args&&... args)
+        {
+            const std::size_t i = count.load(std::memory_order_relaxed);
+            const std::size_t chunk = i >> kChunkBits;
+            if (!chunks[chunk].load(std::memory_order_relaxed)) {
+                owned.push_back(std::make_unique<AtlasEntry[]>(kChunkSize));
+                chunks[chunk].store(owned.back().get(), std::memory_order_release);
+            }
+
+            AtlasEntry& entry = slot(i);
+            entry = AtlasEntry(std::forward<Args>(args)...);
+            count.store(i + 1, std::memory_order_release);
+            return entry;
+        }
+
+        void clear()
+        {
+            begin_update();
+            count.store(0, std::memory_order_release);
+            for (auto& chunk : chunks)
+                chunk.store(nullptr, std::memory_order_release);
+            end_update();
+
+            if (!owned.empty()) {
+                retired.push_back({ atlas_grace::retire(), std::move(owned) });
+                owned.clear();
+            }
+            reclaim();
+        }
+
+        // Frees chunks retired before every reader's last quiescent point.
+        void reclaim()
+        {
+            const std::size_t before = retired.size();
+            std::erase_if(retired, [](const RetiredChunks& r) { return atlas_grace::expired(r.stamp); });
+            if (retired.size() != before)
+                atlas_grace::released(before - retired.size());
+        }
+        // Brackets in-place region rewrites so concurrent readers retry.
+        void begin_update() noexcept { seq.fetch_add(1, std::memory_order_acq_rel); }
+        void end_update() noexcept { seq.fetch_add(1, std::memory_order_release); }
+
+        // Lock-free read of a published entry's region (and optionally name).
+        [[nodiscard]] bool try_read(std::size_t i, AtlasRegion& outRegion, std::string* outName) const
+        {
+            for (;;) {
+                const u64 before = seq.load(std::memory_order_acquire);
+                if (before & 1u) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                if (i >= count.load(std::memory_order_acquire))
+                    return false;
+
+                const AtlasEntry* entry = find_slot(i);
+                if (!entry) {
+                    // Cleared after the count was read.
+                    if (seq.load(std::memory_order_acquire) == before)
+                        return false;
+                    continue;
+                }
+                outRegion = entry->region;
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (seq.load(std::memory_order_relaxed) != before)
+                    continue;
+
+                if (outName)
+                    *outName = entry->name;
+                return true;
+            }
+        }
+
+    private:
+        // nullptr when clear() has dropped the chunk holding `i`.
+        [[nodiscard]] AtlasEntry* find_slot(std::size_t i) const noexcept
+        {
+            AtlasEntry* chunk = chunks[i >> kChunkBits].load(std::memory_order_acquire);
+            return chunk ? chunk + (i & (kChunkSize - 1)) : nullptr;
+        }
+
+        // Writer side: `i` is below size(), so its chunk is present.
+        [[nodiscard]] AtlasEntry& slot(std::size_t i) const noexcept { return *find_slot(i); }
+
+        struct RetiredChunks
+        {
+            u64 stamp{};
+            std::vector<std::unique_ptr<AtlasEntry[]>> chunks;
+        };
+
+        std::array<std::atomic<AtlasEntry*>, kMaxChunks> chunks{};
+        std::vector<std::unique_ptr<AtlasEntry[]>> owned; // chunks behind `chunks`
+        std::vector<RetiredChunks> retired;               // dropped by clear(), see atlas_grace
+        std::atomic<std::size_t> count{ 0 };
+        std::atomic<u64> seq{ 0 };
+    };
+
+    // Placement of one entry as recorded in a baked atlas cache.
+    struct AtlasBakedEntry
+    {
+        std::string name;
+        u32 x{}, y{};
+        u32 width{}, height{};
+        bool slice{ false };
+    };
+
     // ────────────────────────────────────────────────────────
     // ATLAS CONFIG
     // ────────────────────────────────────────────────────────
@@ -95,7 +407,14 @@ export namespace almondnamespace
         u32 width{ 2048 };
         u32 height{ 2048 };
         bool generate_mipmaps{ false };
+        u32 mip_levels{ 0 };        // levels below the base; 0 = as deep as the padding allows
         int index{ 0 };
+
+        AtlasPackerKind packer{ AtlasPackerKind::Skyline };
+        u32 padding{ 0 };           // empty texels reserved around every packed entry; at least 1 with mipmaps
+        bool extrude_edges{ false }; // replicate edge texels into the padding ring
+        u32 max_pages{ 8 };          // primary + overflow pages the registrar may create
+        float sdf_scale{ 0.0f };     // > 0: alpha is a distance field, see TextureAtlas
     };
 
     // ────────────────────────────────────────────────────────
@@ -109,17 +428,33 @@ export namespace almondnamespace
         u32 width{ 0 };
         u32 height{ 0 };
         bool has_mipmaps{ false };
+        u32 mip_level_count{ 0 };   // levels below the base kept in mip_levels
+        u32 padding{ 0 };
+        bool extrude_edges{ false };
+
+        // 0 for ordinary atlases. Otherwise alpha holds a signed distance to a
+        // shape edge: 128 on the edge, changing by sdf_scale per texel (larger
+        // inside). Backends turn it into coverage for the on-screen size.
+        float sdf_scale{ 0.0f };
+
+        // Multi-page support. Overflow pages are full TextureAtlas instances with
+        // their own atlas index, so every backend uploads them like any other atlas.
+        u32 page{ 0 };
+        u32 max_pages{ 1 };
+        TextureAtlas* primary{ nullptr }; // owning atlas when this is an overflow page
 
         mutable u64 version{ 0 };
         mutable std::vector<u8> pixel_data;
+        mutable std::vector<mip::MipLevel> mip_levels; // level 1..N, see ensure_mipmaps()
 
-        std::vector<AtlasEntry> entries;
+        AtlasEntryTable entries;
 
         TextureAtlas() = default;
 
         TextureAtlas(std::string n, int w, int h)
             : name(std::move(n)), width(static_cast<u32>(w)), height(static_cast<u32>(h))
         {
+            packer.reset(AtlasPackerKind::Skyline, width, height);
         }
 
         TextureAtlas(const TextureAtlas&) = delete;
@@ -127,6 +462,12 @@ export namespace almondnamespace
         TextureAtlas(TextureAtlas&&) = delete;
         TextureAtlas& operator=(TextureAtlas&&) = delete;
 
+        ~TextureAtlas()
+        {
+            if (!retiredPixels.empty())
+                atlas_grace::released(retiredPixels.size());
+        }
+
         bool init(const AtlasConfig& config)
         {
             name = config.name;
@@ -134,19 +475,28 @@ export namespace almondnamespace
             width = config.width;
             height = config.height;
             has_mipmaps = config.generate_mipmaps;
+            padding = resolve_padding(config);
+            extrude_edges = config.extrude_edges;
+            sdf_scale = config.sdf_scale;
+            max_pages = (std::max)(1u, config.max_pages);
+            mip_level_count = resolve_mip_levels(config);
 
             pixel_data.clear();
             pixel_data.resize(
                 static_cast<std::size_t>(width) * height * 4, 0
             );
 
-            occupancy.clear();
-            occupancy.assign(height, std::vector<bool>(width, false));
+            packer.reset(config.packer, width, height);
 
             {
                 std::unique_lock lock(entriesMutex);
                 entries.clear();
                 lookup.clear();
+                pages.clear();
+                dirtyLog.clear();
+                dirtyLogFloor = 0;
+                mip_levels.clear();
+                mipVersion = 0;
             }
 
             version = 0;
@@ -155,28 +505,25 @@ export namespace almondnamespace
 
         [[nodiscard]] size_t entry_count() const noexcept
         {
-            std::lock_guard lock(entriesMutex);
             return entries.size();
         }
 
+        // Lock-free; this is the per-sprite hot path of every backend.
         [[nodiscard]] bool try_get_entry_info(
             int index,
             AtlasRegion& outRegion,
             std::string* outName = nullptr) const
         {
-            std::lock_guard lock(entriesMutex);
-
-            if (index < 0 || static_cast<size_t>(index) >= entries.size())
+            if (index < 0)
                 return false;
 
-            const auto& entry = entries[static_cast<size_t>(index)];
-            if (entry.region.width == 0 || entry.region.height == 0)
+            AtlasRegion region{};
+            if (!entries.try_read(static_cast<size_t>(index), region, outName))
+                return false;
+            if (region.width == 0 || region.height == 0)
                 return false;
 
-            outRegion = entry.region;
-            if (outName)
-                *outName = entry.name;
-
+            outRegion = region;
             return true;
         }
 
@@ -188,21 +535,176 @@ export namespace almondnamespace
             atlas->width = config.width;
             atlas->height = config.height;
             atlas->has_mipmaps = config.generate_mipmaps;
+            atlas->padding = resolve_padding(config);
+            atlas->extrude_edges = config.extrude_edges;
+            atlas->sdf_scale = config.sdf_scale;
+            atlas->max_pages = (std::max)(1u, config.max_pages);
+            atlas->mip_level_count = resolve_mip_levels(config);
             atlas->pixel_data.resize(
                 static_cast<size_t>(atlas->width) * atlas->height * 4, 0);
-            atlas->occupancy.assign(
-                atlas->height, std::vector<bool>(atlas->width, false));
+            atlas->packer.reset(config.packer, atlas->width, atlas->height);
 
             return atlas;
         }
 
         [[nodiscard]] int get_index() const noexcept { return index; }
+        [[nodiscard]] AtlasPackerKind packer_kind() const noexcept { return packer.kind; }
 
-        std::optional<AtlasEntry> add_entry(const std::string& id, const Texture& tex);
+        // Fraction of the atlas covered by packed entries (padding included).
+        [[nodiscard]] float occupancy_ratio() const noexcept
+        {
+            std::lock_guard lock(entriesMutex);
+            const u64 total = static_cast<u64>(width) * height;
+            return total ? static_cast<float>(packer.used_area()) / static_cast<float>(total) : 0.0f;
+        }
+
+        // Config for overflow page `pageNumber`; the caller assigns the atlas index.
+        [[nodiscard]] AtlasConfig page_config(u32 pageNumber) const
+        {
+            AtlasConfig config{};
+            config.name = name + "#page" + std::to_string(pageNumber);
+            config.width = width;
+            config.height = height;
+            config.generate_mipmaps = has_mipmaps;
+            config.mip_levels = mip_level_count;
+            config.packer = packer.kind;
+            config.padding = padding;
+            config.extrude_edges = extrude_edges;
+            config.sdf_scale = sdf_scale;
+            config.max_pages = 1;
+            return config;
+        }
+
+        void attach_page(TextureAtlas& pageAtlas)
+        {
+            std::lock_guard lock(entriesMutex);
+            pageAtlas.primary = this;
+            pageAtlas.page = static_cast<u32>(pages.size() + 1);
+            pages.push_back(&pageAtlas);
+        }
+
+        // Overflow pages in creation order (the primary itself is not included).
+        [[nodiscard]] std::vector<TextureAtlas*> overflow_pages() const
+        {
+            std::lock_guard lock(entriesMutex);
+            return pages;
+        }
+
+        // Union of the texels written after `sinceVersion`. Falls back to the whole
+        // atlas once the bounded history no longer reaches back that far.
+        // `outVersion` receives the version the rect covers, read under the same
+        // lock; uploaders store that rather than re-reading `version`, which a
+        // concurrent write may already have moved past the rect.
+        [[nodiscard]] AtlasDirtyRect dirty_rect_since(u64 sinceVersion, u64* outVersion = nullptr) const
+        {
+            std::lock_guard lock(entriesMutex);
+            if (outVersion)
+                *outVersion = version;
+            if (sinceVersion >= version)
+                return {};
+            if (sinceVersion < dirtyLogFloor)
+                return { 0, 0, width, height };
+
+            AtlasDirtyRect bounds{};
+            for (const auto& record : dirtyLog) {
+                if (record.version > sinceVersion)
+                    bounds.merge(record.rect);
+            }
+            return bounds;
+        }
+
+        // Copies `rect` out of pixel_data as tightly packed RGBA8 rows.
+        void copy_rect(const AtlasDirtyRect& rect, std::vector<u8>& out) const
+        {
+            std::lock_guard lock(entriesMutex);
+            out.resize(rect.byte_size());
+            const std::size_t stride = static_cast<std::size_t>(width) * 4;
+            const std::size_t rowBytes = static_cast<std::size_t>(rect.width) * 4;
+            for (u32 row = 0; row < rect.height; ++row) {
+                const u8* src = pixel_data.data() + (rect.y + row) * stride + static_cast<std::size_t>(rect.x) * 4;
+                std::copy_n(src, rowBytes, out.data() + row * rowBytes);
+            }
+        }
+
+        // Brings mip_levels up to date with pixel_data, refiltering only the area
+        // written since the last call. No-op when the atlas has no mipmaps.
+        void ensure_mipmaps() const;
+
+        // Level 0 is pixel_data; levels past the chain clamp to the smallest one.
+        // Call ensure_mipmaps() first.
+        [[nodiscard]] mip::MipView mip_view(u32 level) const noexcept
+        {
+            if (level == 0 || mip_levels.empty())
+                return { pixel_data.data(), width, height, 0 };
+
+            const u32 clamped = (std::min)(level, static_cast<u32>(mip_levels.size()));
+            const auto& mip = mip_levels[clamped - 1];
+            return { mip.pixels.data(), mip.width, mip.height, clamped };
+        }
+
+        // Entries in insertion order, for writing a baked cache.
+        [[nodiscard]] std::vector<AtlasBakedEntry> baked_entries() const
+        {
+            std::lock_guard lock(entriesMutex);
+            std::vector<AtlasBakedEntry> out;
+            out.reserve(entries.size());
+            for (const auto& entry : entries) {
+                out.push_back({ entry.name, entry.region.x, entry.region.y,
+                    entry.region.width, entry.region.height, entry.slice });
+            }
+            return out;
+        }
+
+        // Fills an empty atlas from a baked cache. The packer is replayed in the
+        // recorded order so later add_entry calls see the same free space; any
+        // disagreement leaves the atlas empty and returns false.
+        bool restore_baked(std::span<const AtlasBakedEntry> baked, std::span<const u8> pixels);
+
+        // Drops every entry and clears the texels, as if freshly initialised.
+        // Overflow pages stay attached.
+        void reset_entries();
+
+        // Frees memory retired for lock-free readers whose grace period is over.
+        void reclaim_retired()
+        {
+            std::lock_guard lock(entriesMutex);
+            entries.reclaim();
+            reclaim_pixels_locked();
+        }
+
+        // When `outFull` is provided, a pack failure for a texture that would fit an
+        // empty page is reported through it instead of being logged as an error.
+        std::optional<AtlasEntry> add_entry(const std::string& id, const Texture& tex, bool* outFull = nullptr);
         std::optional<AtlasEntry> add_slice_entry(const std::string& id, int x, int y, int w, int h);
         std::optional<AtlasRegion> get_region(const std::string& id) const;
+
+        // Replaces the texels of entry `id` (tightly packed RGBA8 of the entry's
+        // size) and records them dirty, so backends re-upload only that rect.
+        // For content that changes every frame, such as a simulation drawn as
+        // one texture. False if `id` is not on this page or the size is wrong.
+        bool write_entry(const std::string& id, std::span<const u8> pixels);
+
+        // Writes `pixels` (tightly packed RGBA8 of the rect's size) at `rect` and
+        // records it dirty, leaving entries alone. For owners that place texels
+        // themselves, such as the font glyph cache.
+        bool write_rect(const AtlasDirtyRect& rect, std::span<const u8> pixels);
+
+        // Points slice entry `index` at a new rect so its slot can be reused.
+        // Lock-free readers see the old region or the new one, never a mix.
+        bool move_slice(int index, u32 x, u32 y, u32 w, u32 h);
+
+        // pixel_data is written once per entry at insert time, so this is a no-op
+        // unless the buffer was lost or resized; then it is reallocated and the
+        // atlas reports a full dirty rect. Overflow pages are handled too.
         void rebuild_pixels() const;
 
+        // Repacks every entry tallest-first into a fresh layout and moves the texels
+        // across in parallel, holding the atlas lock only to snapshot and to swap.
+        // Regions change, so callers caching AtlasRegion values must query them
+        // again. Returns false (layout untouched) if the repack fails or the atlas
+        // keeps changing while it runs.
+        bool defragment();
+
     private:
         // IMPORTANT:
         // This atlas is accessed by both upload/build paths and GUI query paths.
@@ -211,22 +713,158 @@ export namespace almondnamespace
         // std::shared_mutex is not re-entrant; that pattern deadlocks (and MSVC will often
         // trip a debug check).
         //
-        // We use std::recursive_mutex as a pragmatic correctness fix. If you want the
-        // shared-read perf back later, switch to a snapshot/RCU-style structure.
+        // Index reads go through AtlasEntryTable and never take this lock; it now
+        // serializes writers and the name-keyed lookup only.
         mutable std::recursive_mutex entriesMutex;
         std::unordered_map<std::string, AtlasRegion> lookup;
-        std::vector<std::vector<bool>> occupancy;
+        std::vector<TextureAtlas*> pages;
+        AtlasPacker packer;
+
+        struct DirtyRecord
+        {
+            u64 version{};
+            AtlasDirtyRect rect{};
+        };
+
+        static constexpr std::size_t kMaxDirtyRecords = 256;
+        mutable u64 mipVersion{ 0 }; // atlas version the mip chain was last built from
+        mutable std::vector<DirtyRecord> dirtyLog;
+        mutable u64 dirtyLogFloor{ 0 }; // records at or below this version were dropped
+        struct RetiredPixels
+        {
+            u64 stamp{};
+            std::vector<u8> pixels;
+        };
+        std::vector<RetiredPixels> retiredPixels; // pre-defragment texels, see atlas_grace
+
+        void reclaim_pixels_locked()
+        {
+            const std::size_t before = retiredPixels.size();
+            std::erase_if(retiredPixels, [](const RetiredPixels& r) { return atlas_grace::expired(r.stamp); });
+            if (retiredPixels.size() != before)
+                atlas_grace::released(before - retiredPixels.size());
+        }
+
+        // Records `rect` against the current version; call after bumping it.
+        void mark_dirty(const AtlasDirtyRect& rect) const
+        {
+            if (rect.empty())
+                return;
+
+            dirtyLog.push_back({ version, rect });
+            if (dirtyLog.size() > kMaxDirtyRecords) {
+                const auto drop = dirtyLog.size() / 2;
+                dirtyLogFloor = dirtyLog[drop - 1].version;
+                dirtyLog.erase(dirtyLog.begin(), dirtyLog.begin() + static_cast<std::ptrdiff_t>(drop));
+            }
+        }
 
         std::optional<std::pair<u32, u32>> try_pack(u32 w, u32 h);
-        bool can_place(u32 x, u32 y, u32 w, u32 h) const;
-        void mark_used(u32 x, u32 y, u32 w, u32 h);
+        void extrude(u32 x, u32 y, u32 w, u32 h) { extrude_into(pixel_data.data(), x, y, w, h); }
+        void extrude_into(u8* pixels, u32 x, u32 y, u32 w, u32 h) const;
+
+        static u32 resolve_mip_levels(const AtlasConfig& config) noexcept
+        {
+            if (!config.generate_mipmaps)
+                return 0;
+            const u32 chain = mip::full_chain_length(config.width, config.height);
+            const u32 wanted = config.mip_levels ? config.mip_levels : mip::gutter_safe_levels(resolve_padding(config));
+            return (std::min)(wanted, chain);
+        }
+
+        // Mip levels need a gutter, or level 1 already mixes neighbouring entries.
+        static u32 resolve_padding(const AtlasConfig& config) noexcept
+        {
+            return config.generate_mipmaps ? (std::max)(1u, config.padding) : config.padding;
+        }
     };
+
+    namespace atlas_detail
+    {
+        // [0, count) handed out `grain` indices at a time to whoever asks next.
+        template<typename Fn>
+        struct ParallelBatch
+        {
+            Fn* fn{};
+            std::size_t count{};
+            std::size_t grain{};
+            std::atomic<std::size_t> next{ 0 };
+
+            void drain()
+            {
+                for (std::size_t begin = next.fetch_add(grain, std::memory_order_relaxed); begin < count;
+                    begin = next.fetch_add(grain, std::memory_order_relaxed)) {
+                    const std::size_t end = (std::min)(count, begin + grain);
+                    for (std::size_t i = begin; i < end; ++i)
+                        (*fn)(i);
+                }
+            }
+        };
+
+        template<typename Fn>
+        Task batch_worker(ParallelBatch<Fn>* batch)
+        {
+            batch->drain();
+            co_return;
+        }
+
+        // One graph for every atlas: defragment() is rare, so its workers are
+        // shared and callers take turns on the mutex.
+        struct SharedGraph
+        {
+            std::mutex mutex;
+            std::unique_ptr<taskgraph::TaskGraph> graph;
+        };
+
+        inline SharedGraph& shared_graph()
+        {
+            static SharedGraph shared;
+            return shared;
+        }
+
+        // Runs fn(i) for i in [0, count) on the calling thread plus TaskGraph
+        // helpers. Small batches stay on the calling thread.
+        template<typename Fn>
+        void parallel_for(std::size_t count, std::size_t grain, Fn&& fn)
+        {
+            grain = (std::max<std::size_t>)(1, grain);
+            const std::size_t hw = (std::max)(1u, std::thread::hardware_concurrency());
+            const std::size_t batches = (count + grain - 1) / grain;
+            const std::size_t helpers = (std::min)(hw - 1, batches > 0 ? batches - 1 : 0);
+
+            ParallelBatch<std::remove_reference_t<Fn>> batch{ &fn, count, grain };
+            if (helpers == 0) {
+                batch.drain();
+                return;
+            }
+
+            auto& shared = shared_graph();
+            std::lock_guard lock(shared.mutex);
+            if (!shared.graph)
+                shared.graph = std::make_unique<taskgraph::TaskGraph>(hw - 1);
+
+            for (std::size_t i = 0; i < helpers; ++i) {
+                auto node = std::make_unique<taskgraph::Node>(batch_worker(&batch));
+                node->Label = "atlas:defragment";
+                shared.graph->AddNode(std::move(node));
+            }
+            shared.graph->Execute();
+
+            batch.drain();
+
+            shared.graph->WaitAll();
+            shared.graph->PruneFinished();
+        }
+    }
 }
 
 namespace almondnamespace
 {
-    inline std::optional<AtlasEntry> TextureAtlas::add_entry(const std::string& id, const Texture& tex)
+    inline std::optional<AtlasEntry> TextureAtlas::add_entry(const std::string& id, const Texture& tex, bool* outFull)
     {
+        if (outFull)
+            *outFull = false;
+
         if (tex.width == 0 || tex.height == 0 || tex.pixels.empty()) {
             std::cerr << "[Atlas] Rejected empty texture '" << id << "'\n";
             return std::nullopt;
@@ -239,8 +877,18 @@ namespace almondnamespace
             return std::nullopt;
         }
 
+        if (entries.size() >= AtlasEntryTable::capacity()) {
+            std::cerr << "[Atlas] Entry table full for '" << name << "'\n";
+            return std::nullopt;
+        }
+
         auto pos = try_pack(tex.width, tex.height);
         if (!pos) {
+            const bool fitsEmptyPage = tex.width + padding * 2 <= width && tex.height + padding * 2 <= height;
+            if (outFull && fitsEmptyPage) {
+                *outFull = true;
+                return std::nullopt;
+            }
             std::cerr << "[Atlas] Failed to pack '" << id << "'\n";
             return std::nullopt;
         }
@@ -254,6 +902,9 @@ namespace almondnamespace
             std::copy_n(src, tex.width * 4, dst);
         }
 
+        if (extrude_edges && padding > 0)
+            extrude(x, y, tex.width, tex.height);
+
         AtlasRegion region{
             .u1 = static_cast<float>(x) / width,
             .v1 = static_cast<float>(height - (y + tex.height)) / height,
@@ -262,18 +913,21 @@ namespace almondnamespace
             .x = x,
             .y = y,
             .width = tex.width,
-            .height = tex.height
+            .height = tex.height,
+            .page = page
         };
 
         int entryIndex = static_cast<int>(entries.size());
-        AtlasEntry entry{ entryIndex, id, region, tex.pixels, tex.width, tex.height };
-        entries.push_back(entry);
+        const AtlasEntry& stored = entries.emplace_back(entryIndex, id, region, std::vector<u8>{}, tex.width, tex.height);
         lookup.emplace(id, region);
         ++version;
+        mark_dirty({ x - padding, y - padding, tex.width + padding * 2, tex.height + padding * 2 });
 #if defined(DEBUG_TEXTURE_RENDERING_VERBOSE)
         std::cerr << "[Atlas] Added '" << id << "' at (" << x << ", " << y
             << ") EntryIndex=" << entryIndex << "\n";
 #endif
+        AtlasEntry entry = stored;
+        entry.pixels = tex.pixels;
         return entry;
     }
 
@@ -304,9 +958,15 @@ namespace almondnamespace
             .x = static_cast<u32>(x),
             .y = static_cast<u32>(y),
             .width = static_cast<u32>(w),
-            .height = static_cast<u32>(h)
+            .height = static_cast<u32>(h),
+            .page = page
         };
 
+        if (entries.size() >= AtlasEntryTable::capacity()) {
+            std::cerr << "[Atlas] Entry table full for '" << name << "'\n";
+            return std::nullopt;
+        }
+
         const int entryIndex = static_cast<int>(entries.size());
         AtlasEntry entry{
             entryIndex,
@@ -316,6 +976,7 @@ namespace almondnamespace
             static_cast<u32>(w),
             static_cast<u32>(h)
         };
+        entry.slice = true;
 
         entries.emplace_back(entry);
         lookup.emplace(id, region);
@@ -329,6 +990,71 @@ namespace almondnamespace
         return entry;
     }
 
+    inline bool TextureAtlas::restore_baked(std::span<const AtlasBakedEntry> baked, std::span<const u8> pixels)
+    {
+        std::unique_lock<std::recursive_mutex> lock(entriesMutex);
+
+        const size_t size = static_cast<size_t>(width) * height * 4;
+        if (!entries.empty() || pixels.size() != size)
+            return false;
+
+        auto fail = [&](const std::string& id) {
+            std::cerr << "[Atlas] Baked layout for '" << name << "' no longer matches at '" << id << "'\n";
+            entries.clear();
+            lookup.clear();
+            packer.reset(packer.kind, width, height);
+            return false;
+        };
+
+        if (baked.size() > AtlasEntryTable::capacity())
+            return false;
+
+        for (const auto& record : baked) {
+            if (record.width == 0 || record.height == 0 || lookup.contains(record.name))
+                return fail(record.name);
+
+            if (!record.slice) {
+                auto pos = try_pack(record.width, record.height);
+                if (!pos || pos->first != record.x || pos->second != record.y)
+                    return fail(record.name);
+            }
+
+            const AtlasRegion region{
+                .u1 = static_cast<float>(record.x) / width,
+                .v1 = static_cast<float>(height - (record.y + record.height)) / height,
+                .u2 = static_cast<float>(record.x + record.width) / width,
+                .v2 = static_cast<float>(height - record.y) / height,
+                .x = record.x,
+                .y = record.y,
+                .width = record.width,
+                .height = record.height,
+                .page = page
+            };
+
+            AtlasEntry entry{ static_cast<int>(entries.size()), record.name, region,
+                std::vector<u8>{}, record.width, record.height };
+            entry.slice = record.slice;
+            entries.emplace_back(std::move(entry));
+            lookup.emplace(record.name, region);
+        }
+
+        pixel_data.assign(pixels.begin(), pixels.end());
+        ++version;
+        mark_dirty({ 0, 0, width, height });
+        return true;
+    }
+
+    inline void TextureAtlas::reset_entries()
+    {
+        std::unique_lock<std::recursive_mutex> lock(entriesMutex);
+        entries.clear();
+        lookup.clear();
+        packer.reset(packer.kind, width, height);
+        std::fill(pixel_data.begin(), pixel_data.end(), u8{ 0 });
+        ++version;
+        mark_dirty({ 0, 0, width, height });
+    }
+
     inline std::optional<AtlasRegion> TextureAtlas::get_region(const std::string& id) const
     {
         std::lock_guard lock(entriesMutex);
@@ -336,76 +1062,316 @@ namespace almondnamespace
         return (it != lookup.end()) ? std::optional{ it->second } : std::nullopt;
     }
 
-    inline void TextureAtlas::rebuild_pixels() const
+    inline bool TextureAtlas::write_entry(const std::string& id, std::span<const u8> pixels)
     {
         std::unique_lock<std::recursive_mutex> lock(entriesMutex);
-        const size_t size = static_cast<size_t>(width) * height * 4;
-        if (pixel_data.size() != size) {
-            pixel_data.resize(size);
-        }
+        auto it = lookup.find(id);
+        if (it == lookup.end())
+            return false;
+
+        const AtlasRegion& region = it->second;
+        const size_t rowBytes = static_cast<size_t>(region.width) * 4;
+        if (pixels.size() != rowBytes * region.height
+            || pixel_data.size() != static_cast<size_t>(width) * height * 4)
+            return false;
 
-        std::fill(pixel_data.begin(), pixel_data.end(), 0);
         const size_t stride = static_cast<size_t>(width) * 4;
+        for (u32 row = 0; row < region.height; ++row) {
+            std::copy_n(pixels.data() + row * rowBytes, rowBytes,
+                pixel_data.data() + (region.y + row) * stride + static_cast<size_t>(region.x) * 4);
+        }
 
-        for (const auto& entry : entries) {
-            if (entry.pixels.empty()) {
-                continue;
-            }
+        if (extrude_edges && padding > 0)
+            extrude(region.x, region.y, region.width, region.height);
 
-            const size_t requiredBytes = static_cast<size_t>(entry.texWidth)
-                * static_cast<size_t>(entry.texHeight) * 4;
-            if (entry.pixels.size() < requiredBytes) {
-                std::cerr << "[Atlas] Skipping rebuild for entry '" << entry.name
-                    << "' due to insufficient pixel data (have "
-                    << entry.pixels.size() << ", need " << requiredBytes << ")\n";
-                continue;
-            }
+        ++version;
+        mark_dirty({ region.x - padding, region.y - padding, region.width + padding * 2, region.height + padding * 2 });
+        return true;
+    }
 
-            for (u32 row = 0; row < entry.texHeight; ++row) {
-                auto dst = pixel_data.data()
-                    + ((entry.region.y + row) * stride)
-                    + (entry.region.x * 4);
-                auto src = entry.pixels.data() + (static_cast<size_t>(row) * entry.texWidth * 4);
-                std::copy_n(src, static_cast<size_t>(entry.texWidth) * 4, dst);
-            }
+    inline bool TextureAtlas::write_rect(const AtlasDirtyRect& rect, std::span<const u8> pixels)
+    {
+        std::unique_lock<std::recursive_mutex> lock(entriesMutex);
+        if (rect.empty() || rect.x + rect.width > width || rect.y + rect.height > height
+            || pixels.size() != rect.byte_size()
+            || pixel_data.size() != static_cast<size_t>(width) * height * 4)
+            return false;
+
+        const size_t stride = static_cast<size_t>(width) * 4;
+        const size_t rowBytes = static_cast<size_t>(rect.width) * 4;
+        for (u32 row = 0; row < rect.height; ++row) {
+            std::copy_n(pixels.data() + row * rowBytes, rowBytes,
+                pixel_data.data() + (rect.y + row) * stride + static_cast<size_t>(rect.x) * 4);
         }
 
         ++version;
+        mark_dirty(rect);
+        return true;
     }
 
-    inline std::optional<std::pair<u32, u32>> TextureAtlas::try_pack(u32 w, u32 h)
+    inline bool TextureAtlas::move_slice(int index, u32 x, u32 y, u32 w, u32 h)
     {
-        for (u32 y = 0; y + h <= height; ++y) {
-            for (u32 x = 0; x + w <= width; ++x) {
-                if (can_place(x, y, w, h)) {
-                    mark_used(x, y, w, h);
-                    return { std::pair{ x, y } };
-                }
+        std::unique_lock<std::recursive_mutex> lock(entriesMutex);
+        if (index < 0 || static_cast<size_t>(index) >= entries.size()
+            || w == 0 || h == 0 || x + w > width || y + h > height)
+            return false;
+
+        AtlasEntry& entry = entries[static_cast<size_t>(index)];
+        if (!entry.slice)
+            return false;
+
+        const AtlasRegion region{
+            .u1 = static_cast<float>(x) / width,
+            .v1 = static_cast<float>(height - (y + h)) / height,
+            .u2 = static_cast<float>(x + w) / width,
+            .v2 = static_cast<float>(height - y) / height,
+            .x = x,
+            .y = y,
+            .width = w,
+            .height = h,
+            .page = page
+        };
+
+        entries.begin_update();
+        entry.region = region;
+        entries.end_update();
+        lookup[entry.name] = region;
+        ++version;
+        return true;
+    }
+
+    inline void TextureAtlas::rebuild_pixels() const
+    {
+        std::unique_lock<std::recursive_mutex> lock(entriesMutex);
+        const size_t size = static_cast<size_t>(width) * height * 4;
+        if (pixel_data.size() != size) {
+            if (!entries.empty()) {
+                std::cerr << "[Atlas] Pixel data for '" << name
+                    << "' was discarded; entries must be re-added\n";
             }
+            pixel_data.assign(size, 0);
+            ++version;
+            mark_dirty({ 0, 0, width, height });
         }
 
-        return std::nullopt;
+        for (const auto* pageAtlas : pages)
+            pageAtlas->rebuild_pixels();
     }
 
-    inline bool TextureAtlas::can_place(u32 x, u32 y, u32 w, u32 h) const
+    inline bool TextureAtlas::defragment()
     {
-        for (u32 dy = 0; dy < h; ++dy) {
-            for (u32 dx = 0; dx < w; ++dx) {
-                if (occupancy[y + dy][x + dx]) {
+        struct Move
+        {
+            size_t entry{};
+            u32 fromX{}, fromY{};
+            u32 toX{}, toY{};
+        };
+
+        struct Placed
+        {
+            AtlasRegion region{};
+            u32 texWidth{}, texHeight{};
+            bool slice{ false };
+        };
+
+        // The plan and the texel copy work from a snapshot, so lookups and
+        // inserts on other threads only wait for the snapshot and the swap.
+        // A write in between invalidates the plan, which is then redone.
+        constexpr int kAttempts = 3;
+        for (int attempt = 0; attempt < kAttempts; ++attempt) {
+            u64 startVersion = 0;
+            AtlasPackerKind kind{};
+            std::vector<Placed> placed;
+            std::vector<u8> source;
+            {
+                std::unique_lock<std::recursive_mutex> lock(entriesMutex);
+                if (pixel_data.size() != static_cast<size_t>(width) * height * 4)
+                    return false;
+
+                startVersion = version;
+                kind = packer.kind;
+                placed.reserve(entries.size());
+                for (const auto& entry : entries)
+                    placed.push_back({ entry.region, entry.texWidth, entry.texHeight, entry.slice });
+                source = pixel_data;
+            }
+
+            std::vector<size_t> order;
+            order.reserve(placed.size());
+            for (size_t i = 0; i < placed.size(); ++i) {
+                if (!placed[i].slice)
+                    order.push_back(i);
+            }
+            std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+                return placed[a].texHeight > placed[b].texHeight;
+            });
+
+            AtlasPacker fresh{};
+            fresh.reset(kind, width, height);
+
+            // Only for logging; the table may have been cleared since the snapshot.
+            auto entry_name = [&](size_t i) {
+                std::lock_guard lock(entriesMutex);
+                return i < entries.size() ? entries[i].name : std::string{};
+            };
+
+            std::vector<Move> moves;
+            moves.reserve(order.size());
+            for (size_t i : order) {
+                const auto& entry = placed[i];
+                auto pos = fresh.pack(entry.texWidth + padding * 2, entry.texHeight + padding * 2);
+                if (!pos) {
+                    std::cerr << "[Atlas] Defragment of '" << name << "' failed to repack '"
+                        << entry_name(i) << "'\n";
+                    return false;
+                }
+                moves.push_back({ i, entry.region.x, entry.region.y, pos->first + padding, pos->second + padding });
+            }
+
+            // Slices ride along with the entry whose texels they view.
+            std::vector<std::pair<size_t, const Move*>> sliceMoves;
+            for (size_t i = 0; i < placed.size(); ++i) {
+                const auto& slice = placed[i];
+                if (!slice.slice)
+                    continue;
+
+                const Move* owner = nullptr;
+                for (const auto& move : moves) {
+                    const auto& r = placed[move.entry].region;
+                    if (slice.region.x >= r.x && slice.region.y >= r.y
+                        && slice.region.x + slice.region.width <= r.x + r.width
+                        && slice.region.y + slice.region.height <= r.y + r.height) {
+                        owner = &move;
+                        break;
+                    }
+                }
+                if (!owner) {
+                    std::cerr << "[Atlas] Defragment of '" << name << "' skipped: slice '"
+                        << entry_name(i) << "' has no owning entry\n";
                     return false;
                 }
+                sliceMoves.emplace_back(i, owner);
+            }
+
+            std::vector<u8> repacked(source.size(), 0);
+            const size_t stride = static_cast<size_t>(width) * 4;
+
+            atlas_detail::parallel_for(moves.size(), 16, [&](size_t m) {
+                const auto& move = moves[m];
+                const auto& entry = placed[move.entry];
+                const size_t rowBytes = static_cast<size_t>(entry.texWidth) * 4;
+                for (u32 row = 0; row < entry.texHeight; ++row) {
+                    const u8* src = source.data() + (move.fromY + row) * stride + static_cast<size_t>(move.fromX) * 4;
+                    u8* dst = repacked.data() + (move.toY + row) * stride + static_cast<size_t>(move.toX) * 4;
+                    std::copy_n(src, rowBytes, dst);
+                }
+                if (extrude_edges && padding > 0)
+                    extrude_into(repacked.data(), move.toX, move.toY, entry.texWidth, entry.texHeight);
+            });
+
+            std::unique_lock<std::recursive_mutex> lock(entriesMutex);
+            if (version != startVersion)
+                continue;
+
+            auto relocate = [&](AtlasEntry& entry, u32 x, u32 y) {
+                auto& r = entry.region;
+                r.x = x;
+                r.y = y;
+                r.u1 = static_cast<float>(x) / width;
+                r.v1 = static_cast<float>(height - (y + r.height)) / height;
+                r.u2 = static_cast<float>(x + r.width) / width;
+                r.v2 = static_cast<float>(height - y) / height;
+                lookup[entry.name] = r;
+            };
+
+            // Slices first: they locate themselves against their owner's old origin.
+            entries.begin_update();
+            for (const auto& [i, move] : sliceMoves) {
+                auto& slice = entries[i];
+                relocate(slice, move->toX + (slice.region.x - move->fromX), move->toY + (slice.region.y - move->fromY));
             }
+            for (const auto& move : moves)
+                relocate(entries[move.entry], move.toX, move.toY);
+            entries.end_update();
+
+            // Backends read pixel_data without the lock, so the old buffer is
+            // retired to atlas_grace rather than freed. An upload that read it
+            // before the swap recorded a version from before the bump, so the
+            // next pass resends everything.
+            pixel_data.swap(repacked);
+            retiredPixels.push_back({ atlas_grace::retire(), std::move(repacked) });
+            reclaim_pixels_locked();
+
+            packer = std::move(fresh);
+            ++version;
+            mark_dirty({ 0, 0, width, height });
+            return true;
         }
 
-        return true;
+        std::cerr << "[Atlas] Defragment of '" << name << "' gave up: the atlas kept changing\n";
+        return false;
     }
 
-    inline void TextureAtlas::mark_used(u32 x, u32 y, u32 w, u32 h)
+    inline void TextureAtlas::ensure_mipmaps() const
     {
-        for (u32 dy = 0; dy < h; ++dy) {
-            for (u32 dx = 0; dx < w; ++dx) {
-                occupancy[y + dy][x + dx] = true;
+        std::unique_lock<std::recursive_mutex> lock(entriesMutex);
+        if (!has_mipmaps || mip_level_count == 0)
+            return;
+        if (!mip_levels.empty() && mipVersion == version)
+            return;
+
+        const AtlasDirtyRect dirty = mip_levels.empty()
+            ? AtlasDirtyRect{ 0, 0, width, height }
+            : dirty_rect_since(mipVersion);
+
+        std::vector<PackerRect> rects;
+        rects.reserve(entries.size());
+        for (const auto& entry : entries) {
+            if (!entry.slice)
+                rects.push_back({ entry.region.x, entry.region.y, entry.region.width, entry.region.height });
+        }
+
+        mip::build_levels(pixel_data.data(), width, height, rects, mip_level_count,
+            { dirty.x, dirty.y, dirty.width, dirty.height }, mip_levels);
+        mipVersion = version;
+    }
+
+    inline std::optional<std::pair<u32, u32>> TextureAtlas::try_pack(u32 w, u32 h)
+    {
+        // Reserve the padding ring on every side; callers get the inner origin.
+        const u32 padW = w + padding * 2;
+        const u32 padH = h + padding * 2;
+        if (padW > width || padH > height)
+            return std::nullopt;
+
+        auto pos = packer.pack(padW, padH);
+        if (!pos)
+            return std::nullopt;
+
+        return { std::pair{ pos->first + padding, pos->second + padding } };
+    }
+
+    inline void TextureAtlas::extrude_into(u8* pixels, u32 x, u32 y, u32 w, u32 h) const
+    {
+        const size_t stride = static_cast<size_t>(width) * 4;
+        auto texel = [&](u32 px, u32 py) { return pixels + py * stride + static_cast<size_t>(px) * 4; };
+
+        // Left/right columns first, then full rows so the corners are filled too.
+        for (u32 row = 0; row < h; ++row) {
+            const u8* left = texel(x, y + row);
+            const u8* right = texel(x + w - 1, y + row);
+            for (u32 p = 1; p <= padding; ++p) {
+                std::copy_n(left, 4, texel(x - p, y + row));
+                std::copy_n(right, 4, texel(x + w - 1 + p, y + row));
             }
         }
+
+        const size_t rowBytes = static_cast<size_t>(w + padding * 2) * 4;
+        const u8* top = texel(x - padding, y);
+        const u8* bottom = texel(x - padding, y + h - 1);
+        for (u32 p = 1; p <= padding; ++p) {
+            std::copy_n(top, rowBytes, texel(x - padding, y - p));
+            std::copy_n(bottom, rowBytes, texel(x - padding, y + h - 1 + p));
+        }
     }
 }
@@ -7,22 +7,28 @@ import aengine.core.context;      // core::Context
 import aengine.context.window;    // core::WindowData
 import aengine.input;             // input::Key
 import aatlas.manager;            // atlasmanager
+import aatlas.cache;              // atlascache::asset_paths
 import aimage.loader;             // a_loadImage
 import aspritehandle;             // SpriteHandle
 import asprite.pool;              // spritepool
+import aspritetable;              // SpriteTable
+import acellularsim.life;         // BitLife, HashLife
 import ascene;                    // scene::Scene
 import aengine.core.logger;       // logger::Logger
 import aengine.core.time;         // timing::Timer
 
 // C++ std
 import <algorithm>;
+import <array>;
+import <bit>;
+import <cstddef>;
 import <cstdint>;
+import <random>;
 import <span>;
 import <stdexcept>;
 import <string>;
 import <string_view>;
 import <tuple>;
-import <unordered_map>;
 import <utility>;
 import <vector>;
 
@@ -37,6 +43,7 @@ export namespace almondnamespace::cellularsim
         {
             Scene::load();
             setupSprites();
+            setupBoard();
             initializeGrid();
         }
 
@@ -52,9 +59,9 @@ export namespace almondnamespace::cellularsim
             auto atlasVec = atlasmanager::get_atlas_vector_snapshot(); // by value
             std::span<const TextureAtlas* const> atlasSpan(atlasVec.data(), atlasVec.size());
 
-            if (auto it = sprites.find("bg"); it != sprites.end() && spritepool::is_alive(it->second))
+            if (const SpriteHandle background = sprites.live(SpriteBg); background.is_valid())
             {
-                ctx->draw_sprite_safe(it->second, atlasSpan, 0.0f, 0.0f,
+                ctx->draw_sprite_safe(background, atlasSpan, 0.0f, 0.0f,
                     float(ctx->get_width_safe()), float(ctx->get_height_safe()));
             }
 
@@ -64,21 +71,19 @@ export namespace almondnamespace::cellularsim
             const float offsetX = (width - cellSize * float(kCols)) * 0.5f;
             const float offsetY = (height - cellSize * float(kRows)) * 0.5f;
 
-            for (int row = 0; row < kRows; ++row)
+            handleInput(*ctx);
+            if (!paused)
             {
-                for (int col = 0; col < kCols; ++col)
-                {
-                    const bool alive = grid[static_cast<size_t>(row * kCols + col)];
-                    const char* spriteName = alive ? "cell_alive" : "cell_dead";
-                    auto it = sprites.find(spriteName);
-                    if (it == sprites.end() || !spritepool::is_alive(it->second))
-                        continue;
-
-                    ctx->draw_sprite_safe(it->second, atlasSpan,
-                        offsetX + cellSize * float(col),
-                        offsetY + cellSize * float(row),
-                        cellSize, cellSize);
-                }
+                if (hashMode)
+                    hashLife.step(std::uint64_t{ 1 } << hashStepLog);
+                else
+                    life.step();
+            }
+
+            if (boardSprite.is_valid() && uploadBoard())
+            {
+                ctx->draw_sprite_safe(boardSprite, atlasSpan, offsetX, offsetY,
+                    cellSize * float(kCols), cellSize * float(kRows));
             }
 
             ctx->present_safe();
@@ -107,9 +112,12 @@ export namespace almondnamespace::cellularsim
                 throw std::runtime_error("[CellularSim] Missing atlas registrar");
 
             TextureAtlas& atlas = registrar->atlas;
+
+            static constexpr std::array<std::string_view, 1> kSpriteIds{ "bg" };
+
             bool registered = false;
 
-            auto ensureSprite = [&](std::string_view id)
+            auto ensureSprite = [&](std::size_t index, std::string_view id)
             {
                 std::string name(id);
 
@@ -118,7 +126,7 @@ export namespace almondnamespace::cellularsim
                     auto handle = std::get<0>(*existing);
                     if (spritepool::is_alive(handle))
                     {
-                        sprites[name] = handle;
+                        sprites.set(index, handle);
                         return;
                     }
                 }
@@ -132,15 +140,18 @@ export namespace almondnamespace::cellularsim
 
                 if (handleOpt && spritepool::is_alive(*handleOpt))
                 {
-                    sprites[name] = *handleOpt;
+                    sprites.set(index, *handleOpt);
                     registered = true;
                 }
             };
 
-            // Always try to load a background sprite if available
-            ensureSprite("bg");
-            ensureSprite("cell_alive");
-            ensureSprite("cell_dead");
+            atlasmanager::load_or_bake_atlas(atlas.name,
+                atlascache::asset_paths("assets/games/acellularsim/", kSpriteIds), [&]
+                {
+                    // Always try to load a background sprite if available
+                    for (std::size_t i = 0; i < kSpriteIds.size(); ++i)
+                        ensureSprite(i, kSpriteIds[i]);
+                });
 
             if (createdAtlas || registered)
             {
@@ -149,19 +160,132 @@ export namespace almondnamespace::cellularsim
             }
         }
 
-        std::unordered_map<std::string, SpriteHandle> sprites{};
-        static constexpr int kRows = 18;
-        static constexpr int kCols = 24;
-        std::vector<bool> grid{};
+        // The board is one texel per cell in its own atlas, rewritten every
+        // frame and drawn as a single sprite; backends upload only that rect.
+        void setupBoard()
+        {
+            atlasmanager::create_atlas({
+                .name = "acellularsim_board",
+                .width = kCols,
+                .height = kRows,
+                .generate_mipmaps = false,
+                .max_pages = 1 });
+
+            auto* registrar = atlasmanager::get_registrar("acellularsim_board");
+            if (!registrar)
+                throw std::runtime_error("[CellularSim] Missing board atlas registrar");
+
+            boardAtlas = &registrar->atlas;
+            boardPixels.assign(static_cast<std::size_t>(kCols * kRows) * 4, 0);
+            auto handleOpt = registrar->register_atlas_sprites_by_image(
+                std::string(kBoardName), boardPixels, kCols, kRows, *boardAtlas);
+            boardSprite = handleOpt ? *handleOpt : SpriteHandle::invalid();
+
+            boardAtlas->rebuild_pixels();
+            atlasmanager::ensure_uploaded(*boardAtlas);
+        }
+
+        // Space pauses, R reseeds, H switches between BitLife and HashLife
+        // (carrying the visible cells over), Up/Down change the HashLife jump.
+        void handleInput(core::Context& ctx)
+        {
+            if (ctx.is_key_down_safe(input::Key::Space))
+                paused = !paused;
+            if (ctx.is_key_down_safe(input::Key::R))
+                initializeGrid();
+            if (ctx.is_key_down_safe(input::Key::Up))
+                hashStepLog = std::min(hashStepLog + 1, kMaxHashStepLog);
+            if (ctx.is_key_down_safe(input::Key::Down) && hashStepLog > 0)
+                --hashStepLog;
+
+            if (ctx.is_key_down_safe(input::Key::H))
+            {
+                if (hashMode)
+                {
+                    life.clear();
+                    hashLife.for_each_alive(-kCols / 2, -kRows / 2, kCols, kRows,
+                        [&](std::int64_t x, std::int64_t y) {
+                            life.set(int(x) + kCols / 2, int(y) + kRows / 2, true);
+                        });
+                }
+                else
+                {
+                    hashLife.clear();
+                    for (int y = 0; y < kRows; ++y)
+                        for (int x = 0; x < kCols; ++x)
+                            if (life.get(x, y))
+                                hashLife.set(x - kCols / 2, y - kRows / 2, true);
+                }
+                hashMode = !hashMode;
+            }
+        }
+
+        // Expands the current generation to RGBA (dead cells transparent) and
+        // writes it over the board texture.
+        bool uploadBoard()
+        {
+            std::fill(boardPixels.begin(), boardPixels.end(), std::uint8_t{ 0 });
+            auto plot = [&](int x, int y)
+            {
+                std::uint8_t* texel = boardPixels.data() + (static_cast<std::size_t>(y) * kCols + static_cast<std::size_t>(x)) * 4;
+                std::copy(kAliveColor.begin(), kAliveColor.end(), texel);
+            };
+
+            if (hashMode)
+            {
+                hashLife.for_each_alive(-kCols / 2, -kRows / 2, kCols, kRows,
+                    [&](std::int64_t x, std::int64_t y) { plot(int(x) + kCols / 2, int(y) + kRows / 2); });
+            }
+            else
+            {
+                for (int y = 0; y < kRows; ++y)
+                {
+                    const auto words = life.row(y);
+                    for (std::size_t w = 0; w < words.size(); ++w)
+                        for (std::uint64_t bits = words[w]; bits != 0; bits &= bits - 1)
+                            plot(static_cast<int>(w * 64) + std::countr_zero(bits), y);
+                }
+            }
+
+            if (!boardAtlas->write_entry(std::string(kBoardName), boardPixels))
+                return false;
+            atlasmanager::ensure_uploaded(*boardAtlas);
+            return true;
+        }
+
+        // Positions in kSpriteIds (setupSprites()).
+        enum SpriteId : std::uint16_t { SpriteBg };
+
+        SpriteTable sprites{};
+        static constexpr int kRows = 160;
+        static constexpr int kCols = 256;
+        static constexpr std::uint32_t kMaxHashStepLog = 12;
+        static constexpr std::string_view kBoardName = "acellularsim_board_cells";
+        static constexpr std::array<std::uint8_t, 4> kAliveColor{ 235, 245, 255, 255 };
+
+        BitLife life{};
+        HashLife hashLife{};
+        bool hashMode = false;
+        bool paused = false;
+        std::uint32_t hashStepLog = 0; // HashLife advances 2^hashStepLog generations per frame
 
+        TextureAtlas* boardAtlas = nullptr;
+        SpriteHandle boardSprite = SpriteHandle::invalid();
+        std::vector<std::uint8_t> boardPixels{};
+
+        // A random soup at one third density.
         void initializeGrid()
         {
-            grid.resize(static_cast<size_t>(kRows * kCols));
+            life.resize(kCols, kRows);
+            hashLife.clear();
+            hashMode = false;
+
+            std::mt19937 rng{ std::random_device{}() };
             for (int row = 0; row < kRows; ++row)
             {
                 for (int col = 0; col < kCols; ++col)
                 {
-                    grid[static_cast<size_t>(row * kCols + col)] = ((row + col) % 2) == 0;
+                    life.set(col, row, rng() % 3 == 0);
                 }
             }
         }
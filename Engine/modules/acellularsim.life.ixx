@@ -0,0 +1,652 @@
+/**************************************************************
+ *   AlmondShell - Modular C++ Framework
+ **************************************************************/
+ // acellularsim.life.ixx
+ //
+ // Conway's Life engines for acellularsim and the `life` benchmark.
+ //
+ // BitLife packs 64 cells per word. A generation adds the eight
+ // neighbour bit-planes with bitwise full adders, so one pass over a
+ // word updates 64 cells; two (SSE2) or four (AVX2) words go at once
+ // and row blocks are spread over the task graph. Cells outside the
+ // board are dead.
+ //
+ // HashLife is Gosper's memoized quadtree for huge, sparse or
+ // periodic patterns on an unbounded plane: identical squares are
+ // stored once and their futures are cached, so it can jump 2^k
+ // generations at a time.
+
+module;
+
+#if defined(__AVX2__)
+#   include <immintrin.h>
+#   define ALMOND_LIFE_AVX2 1
+#   define ALMOND_LIFE_SSE2 1
+#elif defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#   include <emmintrin.h>
+#   define ALMOND_LIFE_SSE2 1
+#endif
+
+export module acellularsim.life;
+
+import <algorithm>;
+import <array>;
+import <atomic>;
+import <bit>;
+import <cstddef>;
+import <cstdint>;
+import <memory>;
+import <span>;
+import <thread>;
+import <unordered_map>;
+import <utility>;
+import <vector>;
+
+import aengine.systems;                 // Task
+import aengine.taskgraph.dotsystem;     // taskgraph::TaskGraph, Node
+
+namespace almondnamespace::cellularsim::detail
+{
+    // Eight neighbour planes -> next state. The sum is kept mod 8 in
+    // ones/twos/fours; a cell lives with 3 neighbours, or 2 if alive.
+    // Eight neighbours wrap to 0, which is dead as required.
+    template <typename L>
+    inline typename L::V life_kernel(const std::uint64_t* a, const std::uint64_t* b,
+        const std::uint64_t* c) noexcept
+    {
+        using V = typename L::V;
+        const V an = L::load(a), bn = L::load(b), cn = L::load(c);
+        // Bit x holds cell x, so the west neighbour shifts up and pulls in
+        // bit 63 of the previous word; east is the mirror image.
+        const V aw = L::or_(L::template shl<1>(an), L::template shr<63>(L::load(a - 1)));
+        const V ae = L::or_(L::template shr<1>(an), L::template shl<63>(L::load(a + 1)));
+        const V bw = L::or_(L::template shl<1>(bn), L::template shr<63>(L::load(b - 1)));
+        const V be = L::or_(L::template shr<1>(bn), L::template shl<63>(L::load(b + 1)));
+        const V cw = L::or_(L::template shl<1>(cn), L::template shr<63>(L::load(c - 1)));
+        const V ce = L::or_(L::template shr<1>(cn), L::template shl<63>(L::load(c + 1)));
+
+        const V s1 = L::xor_(L::xor_(aw, an), ae);
+        const V c1 = L::or_(L::and_(aw, an), L::and_(ae, L::xor_(aw, an)));
+        const V s2 = L::xor_(L::xor_(bw, be), cw);
+        const V c2 = L::or_(L::and_(bw, be), L::and_(cw, L::xor_(bw, be)));
+        const V s3 = L::xor_(cn, ce);
+        const V c3 = L::and_(cn, ce);
+
+        const V ones = L::xor_(L::xor_(s1, s2), s3);
+        const V c4 = L::or_(L::and_(s1, s2), L::and_(s3, L::xor_(s1, s2)));
+        const V t = L::xor_(L::xor_(c1, c2), c3);
+        const V cc1 = L::or_(L::and_(c1, c2), L::and_(c3, L::xor_(c1, c2)));
+        const V twos = L::xor_(t, c4);
+        const V fours = L::xor_(cc1, L::and_(t, c4));
+
+        return L::andnot(fours, L::and_(twos, L::or_(ones, bn)));
+    }
+
+    struct ScalarLanes
+    {
+        using V = std::uint64_t;
+        static constexpr int kWords = 1;
+        static V load(const std::uint64_t* p) noexcept { return *p; }
+        static void store(std::uint64_t* p, V v) noexcept { *p = v; }
+        static V and_(V x, V y) noexcept { return x & y; }
+        static V or_(V x, V y) noexcept { return x | y; }
+        static V xor_(V x, V y) noexcept { return x ^ y; }
+        static V andnot(V x, V y) noexcept { return ~x & y; }
+        template <int N> static V shl(V x) noexcept { return x << N; }
+        template <int N> static V shr(V x) noexcept { return x >> N; }
+    };
+
+#if defined(ALMOND_LIFE_SSE2)
+    struct Sse2Lanes
+    {
+        using V = __m128i;
+        static constexpr int kWords = 2;
+        static V load(const std::uint64_t* p) noexcept { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+        static void store(std::uint64_t* p, V v) noexcept { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+        static V and_(V x, V y) noexcept { return _mm_and_si128(x, y); }
+        static V or_(V x, V y) noexcept { return _mm_or_si128(x, y); }
+        static V xor_(V x, V y) noexcept { return _mm_xor_si128(x, y); }
+        static V andnot(V x, V y) noexcept { return _mm_andnot_si128(x, y); }
+        template <int N> static V shl(V x) noexcept { return _mm_slli_epi64(x, N); }
+        template <int N> static V shr(V x) noexcept { return _mm_srli_epi64(x, N); }
+    };
+#endif
+
+#if defined(ALMOND_LIFE_AVX2)
+    struct Avx2Lanes
+    {
+        using V = __m256i;
+        static constexpr int kWords = 4;
+        static V load(const std::uint64_t* p) noexcept { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+        static void store(std::uint64_t* p, V v) noexcept { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+        static V and_(V x, V y) noexcept { return _mm256_and_si256(x, y); }
+        static V or_(V x, V y) noexcept { return _mm256_or_si256(x, y); }
+        static V xor_(V x, V y) noexcept { return _mm256_xor_si256(x, y); }
+        static V andnot(V x, V y) noexcept { return _mm256_andnot_si256(x, y); }
+        template <int N> static V shl(V x) noexcept { return _mm256_slli_epi64(x, N); }
+        template <int N> static V shr(V x) noexcept { return _mm256_srli_epi64(x, N); }
+    };
+#endif
+
+    // Steps words [i, count) of one row in groups of L::kWords; returns
+    // the first word left over.
+    template <typename L>
+    inline int step_words(const std::uint64_t* a, const std::uint64_t* b, const std::uint64_t* c,
+        std::uint64_t* out, int i, int count) noexcept
+    {
+        for (; i + L::kWords <= count; i += L::kWords)
+            L::store(out + i, life_kernel<L>(a + i, b + i, c + i));
+        return i;
+    }
+
+    inline void step_row(const std::uint64_t* a, const std::uint64_t* b, const std::uint64_t* c,
+        std::uint64_t* out, int count) noexcept
+    {
+        int i = 0;
+#if defined(ALMOND_LIFE_AVX2)
+        i = step_words<Avx2Lanes>(a, b, c, out, i, count);
+#endif
+#if defined(ALMOND_LIFE_SSE2)
+        i = step_words<Sse2Lanes>(a, b, c, out, i, count);
+#endif
+        step_words<ScalarLanes>(a, b, c, out, i, count);
+    }
+}
+
+export namespace almondnamespace::cellularsim
+{
+    // ────────────────────────────────────────────────────────
+    // BitLife
+    // ────────────────────────────────────────────────────────
+
+    class BitLife
+    {
+    public:
+        static constexpr int kRowsPerTask = 16;
+
+        BitLife() = default;
+        BitLife(int width, int height) { resize(width, height); }
+        BitLife(const BitLife&) = delete;
+        BitLife& operator=(const BitLife&) = delete;
+
+        // Kills every cell.
+        void resize(int width, int height)
+        {
+            width_ = (std::max)(1, width);
+            height_ = (std::max)(1, height);
+            words_ = (width_ + 63) / 64;
+            // One dead word left and right of every row and one dead row above
+            // and below the board, so the kernel never needs a bounds check.
+            stride_ = static_cast<std::size_t>(words_) + 2;
+            const std::size_t total = stride_ * (static_cast<std::size_t>(height_) + 2);
+            cells_.assign(total, 0);
+            next_.assign(total, 0);
+            const int tail = width_ % 64;
+            lastMask_ = tail ? (std::uint64_t{ 1 } << tail) - 1 : ~std::uint64_t{ 0 };
+            generation_ = 0;
+        }
+
+        void clear()
+        {
+            std::fill(cells_.begin(), cells_.end(), 0);
+            generation_ = 0;
+        }
+
+        [[nodiscard]] int width() const noexcept { return width_; }
+        [[nodiscard]] int height() const noexcept { return height_; }
+        [[nodiscard]] std::uint64_t generation() const noexcept { return generation_; }
+
+        [[nodiscard]] bool get(int x, int y) const noexcept
+        {
+            if (x < 0 || y < 0 || x >= width_ || y >= height_)
+                return false;
+            return (row(y)[x >> 6] >> (x & 63)) & 1u;
+        }
+
+        void set(int x, int y, bool alive) noexcept
+        {
+            if (x < 0 || y < 0 || x >= width_ || y >= height_)
+                return;
+            std::uint64_t& word = cells_[offset(y) + static_cast<std::size_t>(x >> 6)];
+            const std::uint64_t bit = std::uint64_t{ 1 } << (x & 63);
+            word = alive ? (word | bit) : (word & ~bit);
+        }
+
+        // Row y, (width() + 63) / 64 words; bit (x % 64) of word (x / 64) is cell x.
+        [[nodiscard]] std::span<const std::uint64_t> row(int y) const noexcept
+        {
+            return { cells_.data() + offset(y), static_cast<std::size_t>(words_) };
+        }
+
+        [[nodiscard]] std::uint64_t population() const noexcept
+        {
+            std::uint64_t count = 0;
+            for (const auto word : cells_)
+                count += static_cast<std::uint64_t>(std::popcount(word));
+            return count;
+        }
+
+        // With `parallel` off every row is stepped on the calling thread.
+        void set_parallel(bool parallel) noexcept { parallel_ = parallel; }
+
+        void step()
+        {
+            const std::size_t blocks = static_cast<std::size_t>((height_ + kRowsPerTask - 1) / kRowsPerTask);
+            const std::size_t hw = (std::max)(1u, std::thread::hardware_concurrency());
+            const std::size_t helpers = parallel_ ? (std::min)(hw - 1, blocks - 1) : 0;
+
+            blockCount_ = blocks;
+            next_block_.store(0, std::memory_order_relaxed);
+            if (helpers > 0) {
+                if (!graph_)
+                    graph_ = std::make_unique<taskgraph::TaskGraph>(hw - 1);
+                for (std::size_t i = 0; i < helpers; ++i) {
+                    auto node = std::make_unique<taskgraph::Node>(block_worker(this));
+                    node->Label = "life:rows";
+                    graph_->AddNode(std::move(node));
+                }
+                graph_->Execute();
+            }
+
+            drain();
+
+            if (helpers > 0) {
+                graph_->WaitAll();
+                graph_->PruneFinished();
+            }
+
+            cells_.swap(next_);
+            ++generation_;
+        }
+
+        void step(std::uint64_t generations)
+        {
+            for (std::uint64_t g = 0; g < generations; ++g)
+                step();
+        }
+
+        // FNV-1a over the size and every word, for comparing runs.
+        [[nodiscard]] std::uint64_t hash() const noexcept
+        {
+            constexpr std::uint64_t kPrime = 0x100000001B3ull;
+            std::uint64_t h = 0xCBF29CE484222325ull;
+            h = (h ^ static_cast<std::uint32_t>(width_)) * kPrime;
+            h = (h ^ static_cast<std::uint32_t>(height_)) * kPrime;
+            for (int y = 0; y < height_; ++y)
+                for (const auto word : row(y))
+                    h = (h ^ word) * kPrime;
+            return h;
+        }
+
+    private:
+        [[nodiscard]] std::size_t offset(int y) const noexcept
+        {
+            return (static_cast<std::size_t>(y) + 1) * stride_ + 1;
+        }
+
+        void step_rows(int y0, int y1) noexcept
+        {
+            for (int y = y0; y < y1; ++y) {
+                const std::uint64_t* b = cells_.data() + offset(y);
+                std::uint64_t* out = next_.data() + offset(y);
+                detail::step_row(b - stride_, b, b + stride_, out, words_);
+                out[words_ - 1] &= lastMask_;
+            }
+        }
+
+        void drain() noexcept
+        {
+            for (std::size_t i = next_block_.fetch_add(1, std::memory_order_relaxed); i < blockCount_;
+                i = next_block_.fetch_add(1, std::memory_order_relaxed)) {
+                const int y0 = static_cast<int>(i) * kRowsPerTask;
+                step_rows(y0, (std::min)(height_, y0 + kRowsPerTask));
+            }
+        }
+
+        static Task block_worker(BitLife* self)
+        {
+            self->drain();
+            co_return;
+        }
+
+        int width_{ 0 };
+        int height_{ 0 };
+        int words_{ 0 };
+        std::size_t stride_{ 0 };
+        std::uint64_t lastMask_{ 0 };
+        std::uint64_t generation_{ 0 };
+        bool parallel_{ true };
+
+        std::vector<std::uint64_t> cells_;
+        std::vector<std::uint64_t> next_;
+
+        std::size_t blockCount_{ 0 };
+        std::atomic<std::size_t> next_block_{ 0 };
+        std::unique_ptr<taskgraph::TaskGraph> graph_;
+    };
+
+    // ────────────────────────────────────────────────────────
+    // HashLife
+    // ────────────────────────────────────────────────────────
+
+    class HashLife
+    {
+    public:
+        using NodeId = std::uint32_t;
+        static constexpr std::uint32_t kMaxLevel = 60;
+
+        // The node pool is compacted to what the pattern still uses once it
+        // grows past `maxNodes`.
+        explicit HashLife(std::size_t maxNodes = std::size_t{ 1 } << 21) : maxNodes_(maxNodes) { clear(); }
+        HashLife(const HashLife&) = delete;
+        HashLife& operator=(const HashLife&) = delete;
+
+        void clear()
+        {
+            nodes_.clear();
+            table_.clear();
+            empty_.clear();
+            nodes_.push_back({ kNone, kNone, kNone, kNone, kNone, 0, 0 }); // dead leaf
+            nodes_.push_back({ kNone, kNone, kNone, kNone, kNone, 0, 1 }); // live leaf
+            root_ = empty(3);
+            generation_ = 0;
+            stepLog_ = 0;
+        }
+
+        // Cells are addressed around the origin; the plane grows as needed.
+        void set(std::int64_t x, std::int64_t y, bool alive)
+        {
+            while (!inside(x, y))
+                expand();
+            const std::int64_t half = half_size(level());
+            root_ = set_rec(root_, x + half, y + half, alive);
+        }
+
+        [[nodiscard]] bool get(std::int64_t x, std::int64_t y) const noexcept
+        {
+            if (!inside(x, y))
+                return false;
+            const std::int64_t half = half_size(level());
+            NodeId id = root_;
+            x += half;
+            y += half;
+            for (std::uint32_t l = level(); l > 0; --l) {
+                const std::int64_t h = std::int64_t{ 1 } << (l - 1);
+                const Node& n = nodes_[id];
+                id = y < h ? (x < h ? n.nw : n.ne) : (x < h ? n.sw : n.se);
+                x &= h - 1;
+                y &= h - 1;
+            }
+            return id == kAlive;
+        }
+
+        [[nodiscard]] std::uint64_t population() const noexcept { return nodes_[root_].population; }
+        [[nodiscard]] std::uint64_t generation() const noexcept { return generation_; }
+        [[nodiscard]] std::uint32_t level() const noexcept { return nodes_[root_].level; }
+        [[nodiscard]] std::size_t node_count() const noexcept { return nodes_.size(); }
+
+        // Advances by `generations`, one power-of-two jump per set bit.
+        void step(std::uint64_t generations)
+        {
+            for (std::uint32_t k = 0; generations != 0; ++k, generations >>= 1) {
+                if (generations & 1u)
+                    step_pow2(k);
+            }
+        }
+
+        // Calls fn(x, y) for every live cell in [x0, x0 + w) x [y0, y0 + h),
+        // skipping empty squares whole.
+        template <typename Fn>
+        void for_each_alive(std::int64_t x0, std::int64_t y0, std::int64_t w, std::int64_t h, Fn&& fn) const
+        {
+            const std::int64_t half = half_size(level());
+            visit(root_, level(), -half, -half, x0, y0, x0 + w, y0 + h, fn);
+        }
+
+    private:
+        static constexpr NodeId kNone = 0xFFFFFFFFu;
+        static constexpr NodeId kDead = 0;
+        static constexpr NodeId kAlive = 1;
+
+        struct Node
+        {
+            NodeId nw, ne, sw, se;
+            NodeId next;               // result() for the current stepLog_, or kNone
+            std::uint32_t level;
+            std::uint64_t population;
+        };
+
+        using Key = std::array<NodeId, 4>;
+
+        struct KeyHash
+        {
+            std::size_t operator()(const Key& k) const noexcept
+            {
+                std::uint64_t h = k[0];
+                h = h * 0x9E3779B97F4A7C15ull + k[1];
+                h = h * 0x9E3779B97F4A7C15ull + k[2];
+                h = h * 0x9E3779B97F4A7C15ull + k[3];
+                return static_cast<std::size_t>(h ^ (h >> 29));
+            }
+        };
+
+        [[nodiscard]] static std::int64_t half_size(std::uint32_t level) noexcept
+        {
+            return level ? std::int64_t{ 1 } << (level - 1) : 0;
+        }
+
+        [[nodiscard]] bool inside(std::int64_t x, std::int64_t y) const noexcept
+        {
+            const std::int64_t half = half_size(level());
+            return x >= -half && y >= -half && x < half && y < half;
+        }
+
+        NodeId join(NodeId nw, NodeId ne, NodeId sw, NodeId se)
+        {
+            const Key key{ nw, ne, sw, se };
+            if (auto it = table_.find(key); it != table_.end())
+                return it->second;
+
+            const NodeId id = static_cast<NodeId>(nodes_.size());
+            nodes_.push_back({ nw, ne, sw, se, kNone, nodes_[nw].level + 1,
+                nodes_[nw].population + nodes_[ne].population + nodes_[sw].population + nodes_[se].population });
+            table_.emplace(key, id);
+            return id;
+        }
+
+        NodeId empty(std::uint32_t level)
+        {
+            if (empty_.empty())
+                empty_.push_back(kDead);
+            while (empty_.size() <= level) {
+                const NodeId e = empty_.back();
+                empty_.push_back(join(e, e, e, e));
+            }
+            return empty_[level];
+        }
+
+        // Doubles the plane, keeping the pattern centred.
+        void expand()
+        {
+            const Node r = nodes_[root_];
+            const NodeId e = empty(r.level - 1);
+            root_ = join(join(e, e, e, r.nw), join(e, e, r.ne, e),
+                join(e, r.sw, e, e), join(r.se, e, e, e));
+        }
+
+        NodeId set_rec(NodeId id, std::int64_t x, std::int64_t y, bool alive)
+        {
+            const Node n = nodes_[id];
+            if (n.level == 0)
+                return alive ? kAlive : kDead;
+
+            const std::int64_t h = std::int64_t{ 1 } << (n.level - 1);
+            NodeId nw = n.nw, ne = n.ne, sw = n.sw, se = n.se;
+            if (y < h) {
+                if (x < h) nw = set_rec(nw, x, y, alive);
+                else       ne = set_rec(ne, x - h, y, alive);
+            }
+            else {
+                if (x < h) sw = set_rec(sw, x, y - h, alive);
+                else       se = set_rec(se, x - h, y - h, alive);
+            }
+            return join(nw, ne, sw, se);
+        }
+
+        // The middle half of a node, one level down.
+        NodeId centre(NodeId id)
+        {
+            const Node n = nodes_[id];
+            return join(nodes_[n.nw].se, nodes_[n.ne].sw, nodes_[n.sw].ne, nodes_[n.se].nw);
+        }
+
+        // One generation of the middle 2x2 of a 4x4 node.
+        NodeId base_case(NodeId id)
+        {
+            const Node& n = nodes_[id];
+            std::uint32_t bits = 0; // bit (y * 4 + x)
+            const NodeId quads[4] = { n.nw, n.ne, n.sw, n.se };
+            for (int q = 0; q < 4; ++q) {
+                const Node& c = nodes_[quads[q]];
+                const int ox = (q & 1) * 2;
+                const int oy = (q >> 1) * 2;
+                const NodeId leaves[4] = { c.nw, c.ne, c.sw, c.se };
+                for (int l = 0; l < 4; ++l)
+                    if (leaves[l] == kAlive)
+                        bits |= 1u << ((oy + (l >> 1)) * 4 + ox + (l & 1));
+            }
+
+            NodeId out[4]{};
+            for (int l = 0; l < 4; ++l) {
+                const int x = 1 + (l & 1);
+                const int y = 1 + (l >> 1);
+                int count = 0;
+                for (int dy = -1; dy <= 1; ++dy)
+                    for (int dx = -1; dx <= 1; ++dx)
+                        if ((dx || dy) && ((bits >> ((y + dy) * 4 + x + dx)) & 1u))
+                            ++count;
+                const bool alive = (bits >> (y * 4 + x)) & 1u;
+                out[l] = (count == 3 || (alive && count == 2)) ? kAlive : kDead;
+            }
+            return join(out[0], out[1], out[2], out[3]);
+        }
+
+        // The middle half of `id`, min(2^(level-2), 2^stepLog_) generations on.
+        NodeId result(NodeId id)
+        {
+            if (nodes_[id].next != kNone)
+                return nodes_[id].next;
+
+            const Node n = nodes_[id];
+            NodeId out;
+            if (n.population == 0) {
+                out = empty(n.level - 1);
+            }
+            else if (n.level == 2) {
+                out = base_case(id);
+            }
+            else {
+                const Node nw = nodes_[n.nw], ne = nodes_[n.ne], sw = nodes_[n.sw], se = nodes_[n.se];
+                NodeId m[9] = {
+                    n.nw, join(nw.ne, ne.nw, nw.se, ne.sw), n.ne,
+                    join(nw.sw, nw.se, sw.nw, sw.ne), join(nw.se, ne.sw, sw.ne, se.nw), join(ne.sw, ne.se, se.nw, se.ne),
+                    n.sw, join(sw.ne, se.nw, sw.se, se.sw), n.se
+                };
+
+                // Full speed runs both halves of the jump; a smaller step
+                // only advances in the second half.
+                const bool full = n.level - 2 <= stepLog_;
+                for (auto& sub : m)
+                    sub = full ? result(sub) : centre(sub);
+
+                out = join(
+                    result(join(m[0], m[1], m[3], m[4])), result(join(m[1], m[2], m[4], m[5])),
+                    result(join(m[3], m[4], m[6], m[7])), result(join(m[4], m[5], m[7], m[8])));
+            }
+
+            nodes_[id].next = out;
+            return out;
+        }
+
+        void step_pow2(std::uint32_t k)
+        {
+            if (population() == 0) {
+                generation_ += std::uint64_t{ 1 } << k;
+                return;
+            }
+
+            if (nodes_.size() > maxNodes_)
+                collect();
+
+            if (k != stepLog_) {
+                for (auto& n : nodes_)
+                    n.next = kNone;
+                stepLog_ = k;
+            }
+
+            // Centre the pattern in a root at least two levels above the step,
+            // then double once more so its growth stays inside result().
+            while ((level() < k + 2 || nodes_[centre(root_)].population != population()) && level() < kMaxLevel)
+                expand();
+            expand();
+
+            root_ = result(root_);
+            generation_ += std::uint64_t{ 1 } << k;
+        }
+
+        // Rebuilds the pool from the live tree; cached results are dropped.
+        void collect()
+        {
+            std::vector<Node> old;
+            old.swap(nodes_);
+            std::vector<NodeId> remap(old.size(), kNone);
+            table_.clear();
+            empty_.clear();
+            nodes_.push_back(old[kDead]);
+            nodes_.push_back(old[kAlive]);
+            remap[kDead] = kDead;
+            remap[kAlive] = kAlive;
+
+            auto copy = [&](auto& self, NodeId id) -> NodeId {
+                if (remap[id] != kNone)
+                    return remap[id];
+                const Node& n = old[id];
+                const NodeId nw = self(self, n.nw);
+                const NodeId ne = self(self, n.ne);
+                const NodeId sw = self(self, n.sw);
+                const NodeId se = self(self, n.se);
+                return remap[id] = join(nw, ne, sw, se);
+            };
+            root_ = copy(copy, root_);
+        }
+
+        template <typename Fn>
+        void visit(NodeId id, std::uint32_t level, std::int64_t x, std::int64_t y,
+            std::int64_t x0, std::int64_t y0, std::int64_t x1, std::int64_t y1, Fn& fn) const
+        {
+            const Node& n = nodes_[id];
+            if (n.population == 0)
+                return;
+            const std::int64_t size = std::int64_t{ 1 } << level;
+            if (x >= x1 || y >= y1 || x + size <= x0 || y + size <= y0)
+                return;
+            if (level == 0) {
+                fn(x, y);
+                return;
+            }
+            const std::int64_t h = size / 2;
+            visit(n.nw, level - 1, x, y, x0, y0, x1, y1, fn);
+            visit(n.ne, level - 1, x + h, y, x0, y0, x1, y1, fn);
+            visit(n.sw, level - 1, x, y + h, x0, y0, x1, y1, fn);
+            visit(n.se, level - 1, x + h, y + h, x0, y0, x1, y1, fn);
+        }
+
+        std::vector<Node> nodes_;
+        std::unordered_map<Key, NodeId, KeyHash> table_;
+        std::vector<NodeId> empty_;     // empty node per level
+        NodeId root_{ kDead };
+        std::uint64_t generation_{ 0 };
+        std::uint32_t stepLog_{ 0 };
+        std::size_t maxNodes_;
+    };
+}
@@ -820,6 +820,7 @@ export namespace almondnamespace::openglcontext
                 return false;
         }
 
+        atlasmanager::mark_quiescent(core::ContextType::OpenGL);
         atlasmanager::process_pending_uploads(core::ContextType::OpenGL);
 
         int fbW = (std::max)(1, opengl_get_width());
@@ -892,6 +893,8 @@ export namespace almondnamespace::openglcontext
         auto& glState = backend.glState;
         (void)ctx;
 
+        atlasmanager::unregister_backend_uploader(core::ContextType::OpenGL);
+
 #if defined(_WIN32)
         PlatformGL::clear_current();
 
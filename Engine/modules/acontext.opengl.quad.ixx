@@ -125,6 +125,7 @@ export namespace almondnamespace::openglquad
         GLint  uUVRegionLoc = -1;
         GLint  uTransformLoc = -1;
         GLint  uSamplerLoc = -1;
+        GLint  uDistanceFieldLoc = -1; // (alpha where the edge ramp starts, ramp width); width 0 = plain texture
         GLuint vao = 0;
         GLuint vbo = 0;
         GLuint ebo = 0;
@@ -233,6 +234,7 @@ export namespace almondnamespace::openglquad
         s.uUVRegionLoc = -1;
         s.uTransformLoc = -1;
         s.uSamplerLoc = -1;
+        s.uDistanceFieldLoc = -1;
 
         if (s.vao && glIsVertexArray(s.vao)) glDeleteVertexArrays(1, &s.vao);
         if (s.vbo && glIsBuffer(s.vbo)) glDeleteBuffers(1, &s.vbo);
@@ -285,8 +287,12 @@ void main() {
             fs = R"(#version 120
 varying vec2 vUV;
 uniform sampler2D uTexture;
+uniform vec2 uDistanceField;
 void main() {
-    gl_FragColor = texture2D(uTexture, vUV);
+    vec4 color = texture2D(uTexture, vUV);
+    if (uDistanceField.y > 0.0)
+        color.a = clamp((color.a - uDistanceField.x) / uDistanceField.y, 0.0, 1.0);
+    gl_FragColor = color;
 })";
         }
         else if (gl33plus)
@@ -306,8 +312,12 @@ void main() {
 in vec2 vUV;
 out vec4 outColor;
 uniform sampler2D uTexture;
+uniform vec2 uDistanceField;
 void main() {
-    outColor = texture(uTexture, vUV);
+    vec4 color = texture(uTexture, vUV);
+    if (uDistanceField.y > 0.0)
+        color.a = clamp((color.a - uDistanceField.x) / uDistanceField.y, 0.0, 1.0);
+    outColor = color;
 })";
         }
         else
@@ -327,8 +337,12 @@ void main() {
 in vec2 vUV;
 out vec4 outColor;
 uniform sampler2D uTexture;
+uniform vec2 uDistanceField;
 void main() {
-    outColor = texture(uTexture, vUV);
+    vec4 color = texture(uTexture, vUV);
+    if (uDistanceField.y > 0.0)
+        color.a = clamp((color.a - uDistanceField.x) / uDistanceField.y, 0.0, 1.0);
+    outColor = color;
 })";
         }
 
@@ -350,6 +364,7 @@ void main() {
         s.uUVRegionLoc = glGetUniformLocation(s.shader, "uUVRegion");
         s.uTransformLoc = glGetUniformLocation(s.shader, "uTransform");
         s.uSamplerLoc = glGetUniformLocation(s.shader, "uTexture");
+        s.uDistanceFieldLoc = glGetUniformLocation(s.shader, "uDistanceField");
 
         if (s.uSamplerLoc >= 0)
         {
@@ -138,6 +138,8 @@ export namespace almondnamespace::openglrenderer
 
         if (pipe.uUVRegionLoc >= 0)
             glUniform4f(pipe.uUVRegionLoc, 0.f, 0.f, 1.f, 1.f);
+        if (pipe.uDistanceFieldLoc >= 0)
+            glUniform2f(pipe.uDistanceFieldLoc, 0.f, 0.f);
 
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_2D, texture);
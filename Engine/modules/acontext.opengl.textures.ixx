@@ -91,6 +91,7 @@ import acontext.opengl.state;
 import acontext.opengl.quad;
 import aatlas.manager;
 import aatlas.texture;
+import amipmapatlas;
 import atexture;
 import aimage.loader;
 import aspritehandle;
@@ -298,34 +299,91 @@ export namespace almondnamespace::opengltextures
 
         glBindTexture(GL_TEXTURE_2D, gpu.textureHandle);
 
-        if (gpu.width != atlas.width || gpu.height != atlas.height) {
+        const GLint mipCount = atlas.has_mipmaps ? static_cast<GLint>(atlas.mip_level_count) : 0;
+        if (mipCount > 0)
+            atlas.ensure_mipmaps();
+
+        // Only the texels written since our last upload; a fresh texture takes everything.
+        u64 uploadVersion = 0;
+        AtlasDirtyRect rect = atlas.dirty_rect_since(gpu.version, &uploadVersion);
+
+        const bool fullUpload = gpu.width != atlas.width || gpu.height != atlas.height;
+        if (fullUpload) {
+            rect = { 0, 0, atlas.width, atlas.height };
 #ifdef GL_ARB_texture_storage
-            glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, atlas.width, atlas.height);
+            glTexStorage2D(GL_TEXTURE_2D, mipCount + 1, GL_RGBA8, atlas.width, atlas.height);
 #else
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8,
-                atlas.width, atlas.height,
-                0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            for (GLint level = 0; level <= mipCount; ++level) {
+                const auto view = atlas.mip_view(static_cast<std::uint32_t>(level));
+                glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA8,
+                    view.width, view.height,
+                    0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            }
 #endif
             gpu.width = atlas.width;
             gpu.height = atlas.height;
         }
 
-        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0,
-            atlas.width, atlas.height,
-            GL_RGBA, GL_UNSIGNED_BYTE,
-            atlas.pixel_data.data());
+        if (!rect.empty()) {
+            const std::size_t offset =
+                (static_cast<std::size_t>(rect.y) * atlas.width + rect.x) * 4;
+
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, static_cast<GLint>(atlas.width));
+            glTexSubImage2D(GL_TEXTURE_2D, 0,
+                static_cast<GLint>(rect.x), static_cast<GLint>(rect.y),
+                static_cast<GLsizei>(rect.width), static_cast<GLsizei>(rect.height),
+                GL_RGBA, GL_UNSIGNED_BYTE,
+                atlas.pixel_data.data() + offset);
+
+            // Mip levels follow the same dirty area, scaled down per level.
+            for (GLint level = 1; level <= mipCount; ++level) {
+                const auto view = atlas.mip_view(static_cast<std::uint32_t>(level));
+                const auto scaled = mip::scale_rect({ rect.x, rect.y, rect.width, rect.height },
+                    static_cast<std::uint32_t>(level));
+                const std::uint32_t x1 = (std::min)(scaled.x + scaled.width, view.width);
+                const std::uint32_t y1 = (std::min)(scaled.y + scaled.height, view.height);
+                if (scaled.x >= x1 || scaled.y >= y1)
+                    continue;
+
+                glPixelStorei(GL_UNPACK_ROW_LENGTH, static_cast<GLint>(view.width));
+                glTexSubImage2D(GL_TEXTURE_2D, level,
+                    static_cast<GLint>(scaled.x), static_cast<GLint>(scaled.y),
+                    static_cast<GLsizei>(x1 - scaled.x), static_cast<GLsizei>(y1 - scaled.y),
+                    GL_RGBA, GL_UNSIGNED_BYTE,
+                    view.pixels + (static_cast<std::size_t>(scaled.y) * view.width + scaled.x) * 4);
+
+                atlasmanager::record_upload_bytes(core::ContextType::OpenGL,
+                    static_cast<std::size_t>(x1 - scaled.x) * (y1 - scaled.y) * 4);
+            }
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
 
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            atlasmanager::record_upload_bytes(core::ContextType::OpenGL, rect.byte_size());
+        }
+
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, mipCount);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
+            mipCount > 0 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
-        gpu.version = atlas.version;
+        gpu.version = uploadVersion;
 
         glBindTexture(GL_TEXTURE_2D, 0);
 
-        std::cerr << "[ OpenGL ] -  Uploaded atlas '" << atlas.name
-            << "' (tex id " << gpu.textureHandle << ")\n";
+        if (fullUpload) {
+            std::cerr << "[ OpenGL ] -  Uploaded atlas '" << atlas.name
+                << "' (tex id " << gpu.textureHandle << ", " << rect.width << "x" << rect.height << ")\n";
+        }
+#if defined(DEBUG_TEXTURE_RENDERING_VERBOSE)
+        else {
+            std::cerr << "[ OpenGL ] -  Updated atlas '" << atlas.name
+                << "' (tex id " << gpu.textureHandle << ", " << rect.width << "x" << rect.height
+                << " at " << rect.x << "," << rect.y << ")\n";
+        }
+#endif
     }
 
     inline void ensure_uploaded(const TextureAtlas& atlas)
@@ -532,8 +590,12 @@ export namespace almondnamespace::opengltextures
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_2D, tex);
 
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        // Distance fields need interpolated texels; the shader turns them into
+        // coverage (see acontext.softrenderer.blit distance_field()).
+        const bool distanceField = atlas->sdf_scale > 0.0f;
+        const GLint filter = distanceField ? GL_LINEAR : GL_NEAREST;
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
@@ -554,6 +616,21 @@ export namespace almondnamespace::opengltextures
         if (pipe.uUVRegionLoc >= 0)
             glUniform4f(pipe.uUVRegionLoc, u0, v0, du, dv);
 
+        if (pipe.uDistanceFieldLoc >= 0)
+        {
+            if (distanceField && region.width > 0 && region.height > 0)
+            {
+                const float pixelsPerTexel = (std::max)((std::min)(
+                    drawWidth / float(region.width), drawHeight / float(region.height)), 1.0f / 64.0f);
+                const float span = atlas->sdf_scale / pixelsPerTexel / 255.0f;
+                glUniform2f(pipe.uDistanceFieldLoc, 128.0f / 255.0f - span * 0.5f, span);
+            }
+            else
+            {
+                glUniform2f(pipe.uDistanceFieldLoc, 0.0f, 0.0f);
+            }
+        }
+
         float flippedY = h - (drawY + drawHeight * 0.5f);
 
         float ndc_x = ((drawX + drawWidth * 0.5f) / float(w)) * 2.f - 1.f;
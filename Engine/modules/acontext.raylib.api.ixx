@@ -176,6 +176,7 @@ export namespace almondnamespace::raylib_api
     void set_mouse_scale(float sx, float sy);
 
     Texture2D load_texture_from_image(const Image& img);
+    void update_texture_rec(const Texture2D& tex, const Rectangle& rec, const void* pixels);
     void unload_texture(const Texture2D& tex);
 
     RenderTexture2D load_render_texture(int w, int h);
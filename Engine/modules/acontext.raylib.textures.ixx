@@ -283,6 +283,8 @@ export namespace almondnamespace::raylibtextures
         auto& backend = get_raylib_backend();
 
         // 1) Cheap read under lock: do we already have the right version?
+        almondnamespace::raylib_api::Texture2D existing{};
+        u64 existingVersion = 0;
         {
             std::scoped_lock lock(backend.gpuMutex);
 
@@ -294,7 +296,36 @@ export namespace almondnamespace::raylibtextures
                     return;
                 if (gpu.uploading && gpu.uploadingVersion == atlas.version)
                     return;
+                if (gpu.texture.id != 0 && gpu.width == atlas.width && gpu.height == atlas.height)
+                {
+                    existing = gpu.texture;
+                    existingVersion = gpu.version;
+                }
+            }
+        }
+
+        // 1b) Same-sized texture already exists: patch only the texels written since (unlocked).
+        if (existing.id != 0)
+        {
+            u64 targetVersion = 0;
+            const AtlasDirtyRect rect = atlas.dirty_rect_since(existingVersion, &targetVersion);
+            if (!rect.empty())
+            {
+                std::vector<std::uint8_t> scratch;
+                atlas.copy_rect(rect, scratch);
+                almondnamespace::raylib_api::update_texture_rec(existing,
+                    { static_cast<float>(rect.x), static_cast<float>(rect.y),
+                      static_cast<float>(rect.width), static_cast<float>(rect.height) },
+                    scratch.data());
+                almondnamespace::atlasmanager::record_upload_bytes(
+                    almondnamespace::core::ContextType::RayLib, rect.byte_size());
             }
+
+            std::scoped_lock lock(backend.gpuMutex);
+            AtlasGPU& gpu = backend.gpu_atlases[&atlas];
+            if (gpu.texture.id == existing.id && gpu.version < targetVersion)
+                gpu.version = targetVersion;
+            return;
         }
 
 
@@ -318,6 +349,9 @@ export namespace almondnamespace::raylibtextures
             return;
         }
 
+        almondnamespace::atlasmanager::record_upload_bytes(
+            almondnamespace::core::ContextType::RayLib, atlas.pixel_data.size());
+
         // Optional: dump only when a *new* texture is successfully created.
         dump_atlas_rgb_ppm(atlas, atlas.index);
 
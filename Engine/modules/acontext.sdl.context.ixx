@@ -413,6 +413,7 @@ export namespace almondnamespace::sdlcontext
 #endif
 
         almond::diagnostics::FrameTiming frameTimer{ backendType, windowId, "SDL" };
+        atlasmanager::mark_quiescent(core::ContextType::SDL);
 
         SDL_Event sdl_event{};
         while (SDL_PollEvent(&sdl_event))
@@ -498,6 +499,8 @@ export namespace almondnamespace::sdlcontext
     {
         (void)ctx;
 
+        atlasmanager::unregister_backend_uploader(core::ContextType::SDL);
+
         if (sdlcontext.renderer)
         {
             SDL_DestroyRenderer(sdlcontext.renderer);
@@ -20,6 +20,7 @@ import aatlas.texture;
 import aimage.loader;
 import atexture;
 import aspritehandle;
+import aengine.context.type;
 
 import acontext.sdl.renderer;
 import acontext.sdl.state;
@@ -157,11 +158,36 @@ export namespace almondnamespace::sdltextures
             return;
         }
 
+        // Same-sized texture already on the GPU: patch only the texels that changed.
+        if (gpu.textureHandle && gpu.width == atlas.width && gpu.height == atlas.height) {
+            u64 uploadVersion = 0;
+            const AtlasDirtyRect rect = atlas.dirty_rect_since(gpu.version, &uploadVersion);
+            if (!rect.empty()) {
+                const SDL_Rect dst{
+                    static_cast<int>(rect.x), static_cast<int>(rect.y),
+                    static_cast<int>(rect.width), static_cast<int>(rect.height) };
+                const std::size_t offset =
+                    (static_cast<std::size_t>(rect.y) * atlas.width + rect.x) * 4;
+
+                if (!SDL_UpdateTexture(gpu.textureHandle, &dst,
+                    atlas.pixel_data.data() + offset, static_cast<int>(atlas.width * 4)))
+                    throw std::runtime_error("[ SDL ] -  Failed: SDL_UpdateTexture");
+
+                atlasmanager::record_upload_bytes(core::ContextType::SDL, rect.byte_size());
+            }
+
+            gpu.version = uploadVersion;
+            return;
+        }
+
         if (gpu.textureHandle) {
             SDL_DestroyTexture(gpu.textureHandle);
             gpu.textureHandle = nullptr;
         }
 
+        // Taken before the texels are read: a write racing the copy leaves the
+        // stored version behind, so the next upload picks it up.
+        const u64 fullVersion = atlas.version;
         SDL_Surface* surface = SDL_CreateSurfaceFrom(
             atlas.width,                 // int width
             atlas.height,                // int height
@@ -181,8 +207,9 @@ export namespace almondnamespace::sdltextures
 
         gpu.width = atlas.width;
         gpu.height = atlas.height;
-        gpu.version = atlas.version;
+        gpu.version = fullVersion;
 
+        atlasmanager::record_upload_bytes(core::ContextType::SDL, atlas.pixel_data.size());
         dump_atlas(atlas, atlas.index);
 
         std::cerr << "[ SDL ] -  Uploaded atlas '" << atlas.name << "'\n";
@@ -349,6 +349,7 @@ export namespace almondnamespace::sfmlcontext
         if (shouldResetSfmlState)
             sfmlcontext.window->resetGLStates();
 
+        atlasmanager::mark_quiescent(core::ContextType::SFML);
         atlasmanager::process_pending_uploads(core::ContextType::SFML);
 
         if (shouldResetSfmlState)
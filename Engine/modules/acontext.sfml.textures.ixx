@@ -19,6 +19,7 @@ import aatlas.texture;
 import aimage.loader;
 import atexture;
 import aspritehandle;
+import aengine.context.type;
 
 import acontext.sfml.state;
 
@@ -174,19 +175,37 @@ export namespace almondnamespace::sfmlcontext
         if (atlas.pixel_data.size() < expected)
             throw std::runtime_error("[ SFML ] -  atlas pixel_data is not RGBA8: '" + atlas.name + "'");
 
+        // Only the texels written since our last upload; a fresh texture takes everything.
+        u64 uploadVersion = 0;
+        AtlasDirtyRect rect = atlas.dirty_rect_since(gpu.version, &uploadVersion);
+
         // SFML 3: allocate/resize via resize(Vector2u). (No Texture::create(w,h).)
         if (gpu.texture.getSize() != size)
         {
             if (!gpu.texture.resize(size))
                 throw std::runtime_error("[ SFML ] -  sf::Texture::resize failed for atlas: " + atlas.name);
+            rect = { 0, 0, atlas.width, atlas.height };
         }
 
         // SFML expects RGBA8 bytes. Do NOT use sf::Utf8 (text).
-        gpu.texture.update(reinterpret_cast<const std::uint8_t*>(atlas.pixel_data.data()));
+        if (rect.width == atlas.width && rect.height == atlas.height)
+        {
+            gpu.texture.update(reinterpret_cast<const std::uint8_t*>(atlas.pixel_data.data()));
+        }
+        else if (!rect.empty())
+        {
+            // update(pixels, size, dest) wants a tightly packed block.
+            static thread_local std::vector<std::uint8_t> scratch;
+            atlas.copy_rect(rect, scratch);
+            gpu.texture.update(scratch.data(), { rect.width, rect.height }, { rect.x, rect.y });
+        }
+
+        if (!rect.empty())
+            atlasmanager::record_upload_bytes(core::ContextType::SFML, rect.byte_size());
 
         gpu.width = atlas.width;
         gpu.height = atlas.height;
-        gpu.version = atlas.version;
+        gpu.version = uploadVersion;
 
         dump_atlas(atlas, atlas.index);
 
@@ -0,0 +1,599 @@
+/**************************************************************
+ *   AlmondShell - Modular C++ Framework
+ **************************************************************/
+ // acontext.softrenderer.blit.ixx
+ //
+ // Alpha-blended sprite blits into the software framebuffer
+ // (0xAARRGGBB). Source texels are RGBA8 atlas rows. Rows are walked
+ // with 16.16 fixed-point stepping and blended in integer math, four
+ // (SSE2) or eight (AVX2) pixels at a time, with fully opaque and
+ // fully transparent groups taking a shortcut. Nearest sampling is
+ // the default; bilinear and trilinear (between two mip levels) are
+ // opt-in per draw and filter with 8-bit fixed-point weights.
+ // Distance-field sprites are filtered too, then their alpha is
+ // remapped to a one-pixel coverage ramp across the edge.
+
+module;
+
+#if defined(__AVX2__)
+#   include <immintrin.h>
+#   define ALMOND_BLIT_AVX2 1
+#   define ALMOND_BLIT_SSE2 1
+#elif defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#   include <emmintrin.h>
+#   define ALMOND_BLIT_SSE2 1
+#endif
+
+export module acontext.softrenderer.blit;
+
+import <algorithm>;
+import <cstdint>;
+import <cstring>;
+
+export namespace almondnamespace::anativecontext::blit
+{
+    // `pixels` holds the `width` x `height` window of the frame starting at
+    // (originX, originY); draws are clipped to that window. stride 0 == width.
+    struct BlitTarget
+    {
+        std::uint32_t* pixels{ nullptr }; // 0xAARRGGBB
+        int width{ 0 };
+        int height{ 0 };
+        int stride{ 0 };
+        int originX{ 0 };
+        int originY{ 0 };
+    };
+
+    struct BlitSource
+    {
+        const std::uint8_t* pixels{ nullptr }; // RGBA8, row stride == width texels
+        std::uint32_t width{ 0 };
+        std::uint32_t height{ 0 };
+        std::uint64_t version{ 0 };            // content revision, e.g. TextureAtlas::version
+    };
+
+    struct BlitRect
+    {
+        int x{}, y{};
+        int width{}, height{};
+    };
+
+    enum class SampleFilter : std::uint8_t { Nearest, Bilinear, Trilinear };
+
+    // How a sprite is sampled. Trilinear also reads `coarse`, the same sprite
+    // one mip level down, and mixes it in with weight lodFrac / 256.
+    // A non-zero sdfGain marks a distance field: each filtered alpha a becomes
+    // clamp(((a << 8) - sdfLo) * sdfGain >> 16, 0, 255); see distance_field().
+    struct SpriteSampling
+    {
+        SampleFilter filter{ SampleFilter::Nearest };
+        BlitSource coarse{};
+        BlitRect coarseSrc{};
+        std::uint32_t lodFrac{ 0 };
+        std::uint32_t sdfLo{ 0 };   // 8.8 alpha where coverage starts
+        std::uint32_t sdfGain{ 0 }; // 8.8 coverage per 8.8 alpha step
+    };
+
+    // Ramp for a distance field whose alpha changes by `sdfScale` per texel
+    // (TextureAtlas::sdf_scale), drawn at `pixelsPerTexel` screen pixels per
+    // texel: coverage goes 0 -> 255 over one screen pixel centred on 128.
+    inline void distance_field(SpriteSampling& sampling, float sdfScale, float pixelsPerTexel) noexcept
+    {
+        const float span = sdfScale / (std::max)(pixelsPerTexel, 1.0f / 64.0f); // alpha per screen pixel
+        const float lo = 128.0f - span * 0.5f;
+        sampling.sdfLo = lo > 0.0f ? static_cast<std::uint32_t>(lo * 256.0f) : 0u;
+        sampling.sdfGain = static_cast<std::uint32_t>((std::min)(255.0f * 256.0f / (std::max)(span, 1.0f / 256.0f), 16777216.0f));
+        if (sampling.filter == SampleFilter::Nearest)
+            sampling.filter = SampleFilter::Bilinear;
+    }
+
+    // Per-channel a + (b - a) * f / 256 for packed 8-bit channels, f in [0, 256].
+    [[nodiscard]] inline std::uint32_t lerp_texel(std::uint32_t a, std::uint32_t b, std::uint32_t f) noexcept
+    {
+        const std::uint32_t nf = 256 - f;
+        const std::uint32_t rb = (((a & 0x00FF00FFu) * nf + (b & 0x00FF00FFu) * f) >> 8) & 0x00FF00FFu;
+        const std::uint32_t ag = (((a >> 8) & 0x00FF00FFu) * nf + ((b >> 8) & 0x00FF00FFu) * f) & 0xFF00FF00u;
+        return rb | ag;
+    }
+
+    namespace detail
+    {
+        // RGBA8 in memory (0xAABBGGRR as a little-endian word) to 0xAARRGGBB.
+        [[nodiscard]] inline std::uint32_t rgba_to_argb(std::uint32_t t) noexcept
+        {
+            return (t & 0xFF00FF00u) | ((t & 0xFFu) << 16) | ((t >> 16) & 0xFFu);
+        }
+
+        [[nodiscard]] inline std::uint32_t load_texel(const std::uint8_t* row, std::uint32_t x) noexcept
+        {
+            std::uint32_t t;
+            std::memcpy(&t, row + static_cast<std::size_t>(x) * 4, 4);
+            return t;
+        }
+
+        // src-over with straight alpha, result opaque; /255 via (x + 128 + (x >> 8)) >> 8.
+        [[nodiscard]] inline std::uint32_t blend_argb(std::uint32_t src, std::uint32_t dst) noexcept
+        {
+            const std::uint32_t a = src >> 24;
+            if (a == 255)
+                return src | 0xFF000000u;
+            if (a == 0)
+                return dst;
+
+            const std::uint32_t ia = 255 - a;
+            std::uint32_t rb = (src & 0x00FF00FFu) * a + (dst & 0x00FF00FFu) * ia + 0x00800080u;
+            rb = ((rb + ((rb >> 8) & 0x00FF00FFu)) >> 8) & 0x00FF00FFu;
+            std::uint32_t g = (src & 0x0000FF00u) * a + (dst & 0x0000FF00u) * ia + 0x00008000u;
+            g = ((g + ((g >> 8) & 0x0000FF00u)) >> 8) & 0x0000FF00u;
+            return 0xFF000000u | rb | g;
+        }
+
+        inline void row_scalar(std::uint32_t* dst, int count, const std::uint8_t* srcRow,
+            std::uint32_t u, std::uint32_t du) noexcept
+        {
+            for (int i = 0; i < count; ++i, u += du)
+                dst[i] = blend_argb(rgba_to_argb(load_texel(srcRow, u >> 16)), dst[i]);
+        }
+
+#if defined(ALMOND_BLIT_SSE2)
+        [[nodiscard]] inline __m128i rgba_to_argb4(__m128i t) noexcept
+        {
+            const __m128i keep = _mm_set1_epi32(static_cast<int>(0xFF00FF00u));
+            const __m128i low = _mm_set1_epi32(0xFF);
+            return _mm_or_si128(_mm_and_si128(t, keep),
+                _mm_or_si128(_mm_slli_epi32(_mm_and_si128(t, low), 16),
+                    _mm_and_si128(_mm_srli_epi32(t, 16), low)));
+        }
+
+        // Two pixels widened to 16-bit lanes.
+        [[nodiscard]] inline __m128i blend_wide(__m128i s, __m128i d) noexcept
+        {
+            const __m128i c255 = _mm_set1_epi16(255);
+            const __m128i c128 = _mm_set1_epi16(128);
+            __m128i a = _mm_shufflelo_epi16(s, _MM_SHUFFLE(3, 3, 3, 3));
+            a = _mm_shufflehi_epi16(a, _MM_SHUFFLE(3, 3, 3, 3));
+            const __m128i ia = _mm_sub_epi16(c255, a);
+            __m128i sum = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(s, a), _mm_mullo_epi16(d, ia)), c128);
+            return _mm_srli_epi16(_mm_add_epi16(sum, _mm_srli_epi16(sum, 8)), 8);
+        }
+
+        [[nodiscard]] inline __m128i blend4(__m128i src, __m128i dst) noexcept
+        {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i lo = blend_wide(_mm_unpacklo_epi8(src, zero), _mm_unpacklo_epi8(dst, zero));
+            const __m128i hi = blend_wide(_mm_unpackhi_epi8(src, zero), _mm_unpackhi_epi8(dst, zero));
+            return _mm_packus_epi16(lo, hi);
+        }
+
+        inline void row_sse2(std::uint32_t* dst, int count, const std::uint8_t* srcRow,
+            std::uint32_t u, std::uint32_t du) noexcept
+        {
+            const __m128i opaqueA = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+            const __m128i alphaMask = opaqueA;
+            const __m128i zero = _mm_setzero_si128();
+            const bool unitStep = du == (1u << 16);
+
+            int i = 0;
+            for (; i + 4 <= count; i += 4, u += 4 * du) {
+                __m128i src;
+                if (unitStep) {
+                    src = _mm_loadu_si128(reinterpret_cast<const __m128i*>(srcRow + static_cast<std::size_t>(u >> 16) * 4));
+                }
+                else {
+                    src = _mm_setr_epi32(
+                        static_cast<int>(load_texel(srcRow, u >> 16)),
+                        static_cast<int>(load_texel(srcRow, (u + du) >> 16)),
+                        static_cast<int>(load_texel(srcRow, (u + 2 * du) >> 16)),
+                        static_cast<int>(load_texel(srcRow, (u + 3 * du) >> 16)));
+                }
+
+                const __m128i alpha = _mm_and_si128(src, alphaMask);
+                if (_mm_movemask_epi8(_mm_cmpeq_epi32(alpha, zero)) == 0xFFFF)
+                    continue;
+
+                src = rgba_to_argb4(src);
+                auto* out = reinterpret_cast<__m128i*>(dst + i);
+                if (_mm_movemask_epi8(_mm_cmpeq_epi32(alpha, opaqueA)) == 0xFFFF) {
+                    _mm_storeu_si128(out, src);
+                    continue;
+                }
+
+                _mm_storeu_si128(out, _mm_or_si128(blend4(src, _mm_loadu_si128(out)), opaqueA));
+            }
+
+            row_scalar(dst + i, count - i, srcRow, u, du);
+        }
+#endif
+
+#if defined(ALMOND_BLIT_AVX2)
+        inline void row_avx2(std::uint32_t* dst, int count, const std::uint8_t* srcRow,
+            std::uint32_t u, std::uint32_t du) noexcept
+        {
+            const __m256i opaqueA = _mm256_set1_epi32(static_cast<int>(0xFF000000u));
+            const __m256i zero = _mm256_setzero_si256();
+            const __m256i keep = _mm256_set1_epi32(static_cast<int>(0xFF00FF00u));
+            const __m256i low = _mm256_set1_epi32(0xFF);
+            const __m256i c255 = _mm256_set1_epi16(255);
+            const __m256i c128 = _mm256_set1_epi16(128);
+            const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+            const __m256i step = _mm256_set1_epi32(static_cast<int>(du));
+
+            auto blend_wide = [&](__m256i s, __m256i d) {
+                __m256i a = _mm256_shufflelo_epi16(s, _MM_SHUFFLE(3, 3, 3, 3));
+                a = _mm256_shufflehi_epi16(a, _MM_SHUFFLE(3, 3, 3, 3));
+                const __m256i ia = _mm256_sub_epi16(c255, a);
+                const __m256i sum = _mm256_add_epi16(
+                    _mm256_add_epi16(_mm256_mullo_epi16(s, a), _mm256_mullo_epi16(d, ia)), c128);
+                return _mm256_srli_epi16(_mm256_add_epi16(sum, _mm256_srli_epi16(sum, 8)), 8);
+            };
+
+            int i = 0;
+            for (; i + 8 <= count; i += 8, u += 8 * du) {
+                const __m256i us = _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(u)), _mm256_mullo_epi32(lane, step));
+                __m256i src = _mm256_i32gather_epi32(reinterpret_cast<const int*>(srcRow), _mm256_srli_epi32(us, 16), 4);
+
+                const __m256i alpha = _mm256_and_si256(src, opaqueA);
+                if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(alpha, zero)) == -1)
+                    continue;
+
+                src = _mm256_or_si256(_mm256_and_si256(src, keep),
+                    _mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(src, low), 16),
+                        _mm256_and_si256(_mm256_srli_epi32(src, 16), low)));
+
+                auto* out = reinterpret_cast<__m256i*>(dst + i);
+                if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(alpha, opaqueA)) == -1) {
+                    _mm256_storeu_si256(out, src);
+                    continue;
+                }
+
+                const __m256i d = _mm256_loadu_si256(out);
+                const __m256i lo = blend_wide(_mm256_unpacklo_epi8(src, zero), _mm256_unpacklo_epi8(d, zero));
+                const __m256i hi = blend_wide(_mm256_unpackhi_epi8(src, zero), _mm256_unpackhi_epi8(d, zero));
+                _mm256_storeu_si256(out, _mm256_or_si256(_mm256_packus_epi16(lo, hi), opaqueA));
+            }
+
+            row_sse2(dst + i, count - i, srcRow, u, du);
+        }
+#endif
+
+        using RowFn = void(*)(std::uint32_t*, int, const std::uint8_t*, std::uint32_t, std::uint32_t) noexcept;
+
+        // ---- Filtered sampling -------------------------------------------
+        // Sample positions are texel centres: pos = (p + 0.5) * src / dest - 0.5
+        // in 16.16, relative to the source rect. Taps are clamped to the rect
+        // so neighbouring atlas entries never bleed in.
+
+        struct Taps
+        {
+            int i0{ 0 };
+            int i1{ 0 };
+            std::uint32_t f{ 0 }; // weight of i1, 0..255
+        };
+
+        [[nodiscard]] inline Taps taps(std::int64_t pos, int extent) noexcept
+        {
+            if (pos <= 0)
+                return {};
+            const auto i = static_cast<int>(pos >> 16);
+            if (i >= extent - 1)
+                return { extent - 1, extent - 1, 0 };
+            return { i, i + 1, static_cast<std::uint32_t>(pos >> 8) & 0xFFu };
+        }
+
+        // Bilinear RGBA8 samples for `count` pixels of one row, written as
+        // 0xAARRGGBB. row0/row1 are the two source rows, fy the weight of row1.
+        inline void fetch_bilinear_scalar(std::uint32_t* out, int count, const std::uint8_t* row0,
+            const std::uint8_t* row1, std::int64_t u, std::int64_t du, int width, std::uint32_t fy) noexcept
+        {
+            for (int i = 0; i < count; ++i, u += du) {
+                const Taps t = taps(u, width);
+                const std::uint32_t top = lerp_texel(load_texel(row0, t.i0), load_texel(row0, t.i1), t.f);
+                const std::uint32_t bottom = lerp_texel(load_texel(row1, t.i0), load_texel(row1, t.i1), t.f);
+                out[i] = rgba_to_argb(lerp_texel(top, bottom, fy));
+            }
+        }
+
+        // Distance alpha to coverage in place; see SpriteSampling.
+        inline void distance_to_coverage(std::uint32_t* px, int count, std::uint32_t lo, std::uint32_t gain) noexcept
+        {
+            for (int i = 0; i < count; ++i) {
+                const std::int64_t d = (static_cast<std::int64_t>(px[i] >> 24) << 8) - lo;
+                const std::int64_t a = d <= 0 ? 0 : (std::min)((d * gain) >> 16, std::int64_t{ 255 });
+                px[i] = (px[i] & 0x00FFFFFFu) | (static_cast<std::uint32_t>(a) << 24);
+            }
+        }
+
+        inline void lerp_span_scalar(std::uint32_t* a, const std::uint32_t* b, int count, std::uint32_t f) noexcept
+        {
+            for (int i = 0; i < count; ++i)
+                a[i] = lerp_texel(a[i], b[i], f);
+        }
+
+        inline void blend_span_scalar(std::uint32_t* dst, const std::uint32_t* src, int count) noexcept
+        {
+            for (int i = 0; i < count; ++i)
+                dst[i] = blend_argb(src[i], dst[i]);
+        }
+
+#if defined(ALMOND_BLIT_SSE2)
+        // Both horizontal taps of one pixel in the low 64 bits.
+        [[nodiscard]] inline __m128i load_pair(const std::uint8_t* row, const Taps& t) noexcept
+        {
+            if (t.i1 != t.i0)
+                return _mm_loadl_epi64(reinterpret_cast<const __m128i*>(row + static_cast<std::size_t>(t.i0) * 4));
+            return _mm_set1_epi32(static_cast<int>(load_texel(row, t.i0)));
+        }
+
+        // Horizontal lerp of two pixels' tap pairs (a, b), widened to 16 bits:
+        // pixel a in the low four lanes, pixel b in the high four.
+        [[nodiscard]] inline __m128i lerp_pairs(__m128i a, __m128i b, const Taps& ta, const Taps& tb) noexcept
+        {
+            const __m128i zero = _mm_setzero_si128();
+            const auto fa = static_cast<short>(ta.f), fb = static_cast<short>(tb.f);
+            const auto na = static_cast<short>(256 - ta.f), nb = static_cast<short>(256 - tb.f);
+            __m128i wa = _mm_mullo_epi16(_mm_unpacklo_epi8(a, zero), _mm_setr_epi16(na, na, na, na, fa, fa, fa, fa));
+            __m128i wb = _mm_mullo_epi16(_mm_unpacklo_epi8(b, zero), _mm_setr_epi16(nb, nb, nb, nb, fb, fb, fb, fb));
+            wa = _mm_add_epi16(wa, _mm_shuffle_epi32(wa, _MM_SHUFFLE(1, 0, 3, 2)));
+            wb = _mm_add_epi16(wb, _mm_shuffle_epi32(wb, _MM_SHUFFLE(1, 0, 3, 2)));
+            return _mm_srli_epi16(_mm_unpacklo_epi64(wa, wb), 8);
+        }
+
+        // (a * (256 - f) + b * f) >> 8 on 16-bit lanes holding 8-bit values.
+        [[nodiscard]] inline __m128i lerp_wide(__m128i a, __m128i b, std::uint32_t f) noexcept
+        {
+            const __m128i wb = _mm_set1_epi16(static_cast<short>(f));
+            const __m128i wa = _mm_set1_epi16(static_cast<short>(256 - f));
+            return _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(a, wa), _mm_mullo_epi16(b, wb)), 8);
+        }
+
+        // Same results as fetch_bilinear_scalar; each pixel's 2x2 footprint is
+        // two 8-byte loads, filtered two pixels per register.
+        inline void fetch_bilinear_sse2(std::uint32_t* out, int count, const std::uint8_t* row0,
+            const std::uint8_t* row1, std::int64_t u, std::int64_t du, int width, std::uint32_t fy) noexcept
+        {
+            int i = 0;
+            for (; i + 4 <= count; i += 4, u += 4 * du) {
+                const Taps t0 = taps(u, width);
+                const Taps t1 = taps(u + du, width);
+                const Taps t2 = taps(u + 2 * du, width);
+                const Taps t3 = taps(u + 3 * du, width);
+
+                const __m128i top01 = lerp_pairs(load_pair(row0, t0), load_pair(row0, t1), t0, t1);
+                const __m128i bot01 = lerp_pairs(load_pair(row1, t0), load_pair(row1, t1), t0, t1);
+                const __m128i top23 = lerp_pairs(load_pair(row0, t2), load_pair(row0, t3), t2, t3);
+                const __m128i bot23 = lerp_pairs(load_pair(row1, t2), load_pair(row1, t3), t2, t3);
+
+                const __m128i px = _mm_packus_epi16(lerp_wide(top01, bot01, fy), lerp_wide(top23, bot23, fy));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), rgba_to_argb4(px));
+            }
+
+            fetch_bilinear_scalar(out + i, count - i, row0, row1, u, du, width, fy);
+        }
+
+        inline void lerp_span_sse2(std::uint32_t* a, const std::uint32_t* b, int count, std::uint32_t f) noexcept
+        {
+            const __m128i zero = _mm_setzero_si128();
+            int i = 0;
+            for (; i + 4 <= count; i += 4) {
+                auto* pa = reinterpret_cast<__m128i*>(a + i);
+                const __m128i va = _mm_loadu_si128(pa);
+                const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+                const __m128i lo = lerp_wide(_mm_unpacklo_epi8(va, zero), _mm_unpacklo_epi8(vb, zero), f);
+                const __m128i hi = lerp_wide(_mm_unpackhi_epi8(va, zero), _mm_unpackhi_epi8(vb, zero), f);
+                _mm_storeu_si128(pa, _mm_packus_epi16(lo, hi));
+            }
+            lerp_span_scalar(a + i, b + i, count - i, f);
+        }
+
+        inline void blend_span_sse2(std::uint32_t* dst, const std::uint32_t* src, int count) noexcept
+        {
+            const __m128i opaqueA = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+            const __m128i zero = _mm_setzero_si128();
+
+            int i = 0;
+            for (; i + 4 <= count; i += 4) {
+                const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+                const __m128i alpha = _mm_and_si128(s, opaqueA);
+                if (_mm_movemask_epi8(_mm_cmpeq_epi32(alpha, zero)) == 0xFFFF)
+                    continue;
+
+                auto* out = reinterpret_cast<__m128i*>(dst + i);
+                if (_mm_movemask_epi8(_mm_cmpeq_epi32(alpha, opaqueA)) == 0xFFFF)
+                    _mm_storeu_si128(out, s);
+                else
+                    _mm_storeu_si128(out, _mm_or_si128(blend4(s, _mm_loadu_si128(out)), opaqueA));
+            }
+            blend_span_scalar(dst + i, src + i, count - i);
+        }
+#endif
+
+        struct FilterScalar
+        {
+            static constexpr auto fetch = fetch_bilinear_scalar;
+            static constexpr auto lerp = lerp_span_scalar;
+            static constexpr auto blend = blend_span_scalar;
+        };
+
+#if defined(ALMOND_BLIT_SSE2)
+        struct FilterSse2
+        {
+            static constexpr auto fetch = fetch_bilinear_sse2;
+            static constexpr auto lerp = lerp_span_sse2;
+            static constexpr auto blend = blend_span_sse2;
+        };
+#endif
+
+        [[nodiscard]] inline bool valid_rect(const BlitSource& source, const BlitRect& src) noexcept
+        {
+            return source.pixels && src.width > 0 && src.height > 0 && src.x >= 0 && src.y >= 0
+                && static_cast<std::uint32_t>(src.x + src.width) <= source.width
+                && static_cast<std::uint32_t>(src.y + src.height) <= source.height;
+        }
+
+        // One source level mapped onto the destination rect.
+        struct FilterLevel
+        {
+            const std::uint8_t* base{ nullptr }; // first texel of the source rect
+            std::size_t stride{ 0 };
+            int width{ 0 };
+            int height{ 0 };
+            std::int64_t du{ 0 };
+            std::int64_t dv{ 0 };
+
+            FilterLevel(const BlitSource& source, const BlitRect& src, const BlitRect& dest) noexcept
+                : base(source.pixels + (static_cast<std::size_t>(src.y) * source.width + static_cast<std::size_t>(src.x)) * 4),
+                stride(static_cast<std::size_t>(source.width) * 4),
+                width(src.width),
+                height(src.height),
+                du((static_cast<std::int64_t>(src.width) << 16) / dest.width),
+                dv((static_cast<std::int64_t>(src.height) << 16) / dest.height)
+            {
+            }
+
+            // 16.16 sample position of the destination pixel at `offset`.
+            [[nodiscard]] static std::int64_t position(int offset, std::int64_t step) noexcept
+            {
+                return offset * step + step / 2 - 0x8000;
+            }
+
+            void fetch_row(auto fetch, std::uint32_t* out, int count, int offsetX, int offsetY) const noexcept
+            {
+                const Taps ty = taps(position(offsetY, dv), height);
+                fetch(out, count, base + static_cast<std::size_t>(ty.i0) * stride, base + static_cast<std::size_t>(ty.i1) * stride,
+                    position(offsetX, du), du, width, ty.f);
+            }
+        };
+
+        template<class Path>
+        void blit_filtered(const BlitTarget& target, const BlitSource& source, const BlitRect& src,
+            const BlitRect& dest, const SpriteSampling& sampling) noexcept
+        {
+            if (!target.pixels || dest.width <= 0 || dest.height <= 0 || !valid_rect(source, src))
+                return;
+
+            const bool trilinear = sampling.filter == SampleFilter::Trilinear && sampling.lodFrac > 0
+                && valid_rect(sampling.coarse, sampling.coarseSrc);
+
+            const int x0 = (std::max)(target.originX, dest.x);
+            const int y0 = (std::max)(target.originY, dest.y);
+            const int x1 = (std::min)(target.originX + target.width, dest.x + dest.width);
+            const int y1 = (std::min)(target.originY + target.height, dest.y + dest.height);
+            if (x0 >= x1 || y0 >= y1)
+                return;
+
+            const FilterLevel fine{ source, src, dest };
+            const FilterLevel coarse = trilinear ? FilterLevel{ sampling.coarse, sampling.coarseSrc, dest } : fine;
+            const std::size_t dstStride = static_cast<std::size_t>(target.stride > 0 ? target.stride : target.width);
+
+            constexpr int kChunk = 256;
+            alignas(16) std::uint32_t samples[kChunk];
+            alignas(16) std::uint32_t coarseSamples[kChunk];
+
+            for (int y = y0; y < y1; ++y) {
+                std::uint32_t* dstRow = target.pixels + static_cast<std::size_t>(y - target.originY) * dstStride;
+                for (int x = x0; x < x1; x += kChunk) {
+                    const int count = (std::min)(kChunk, x1 - x);
+                    fine.fetch_row(Path::fetch, samples, count, x - dest.x, y - dest.y);
+                    if (trilinear) {
+                        coarse.fetch_row(Path::fetch, coarseSamples, count, x - dest.x, y - dest.y);
+                        Path::lerp(samples, coarseSamples, count, sampling.lodFrac);
+                    }
+                    if (sampling.sdfGain != 0)
+                        distance_to_coverage(samples, count, sampling.sdfLo, sampling.sdfGain);
+                    Path::blend(dstRow + (x - target.originX), samples, count);
+                }
+            }
+        }
+
+        template<RowFn Row>
+        void blit(const BlitTarget& target, const BlitSource& source, const BlitRect& src, const BlitRect& dest) noexcept
+        {
+            if (!target.pixels || !source.pixels || src.width <= 0 || src.height <= 0
+                || dest.width <= 0 || dest.height <= 0)
+                return;
+            if (src.x < 0 || src.y < 0
+                || static_cast<std::uint32_t>(src.x + src.width) > source.width
+                || static_cast<std::uint32_t>(src.y + src.height) > source.height)
+                return;
+
+            const int x0 = (std::max)(target.originX, dest.x);
+            const int y0 = (std::max)(target.originY, dest.y);
+            const int x1 = (std::min)(target.originX + target.width, dest.x + dest.width);
+            const int y1 = (std::min)(target.originY + target.height, dest.y + dest.height);
+            if (x0 >= x1 || y0 >= y1)
+                return;
+
+            // 16.16 steps; sample = floor((p - dest) * srcExtent / destExtent).
+            const auto du = static_cast<std::uint32_t>((static_cast<std::uint64_t>(src.width) << 16) / dest.width);
+            const auto dv = static_cast<std::uint32_t>((static_cast<std::uint64_t>(src.height) << 16) / dest.height);
+            const auto u0 = static_cast<std::uint32_t>(static_cast<std::uint64_t>(x0 - dest.x) * du);
+
+            const std::size_t srcStride = static_cast<std::size_t>(source.width) * 4;
+            const std::size_t dstStride = static_cast<std::size_t>(target.stride > 0 ? target.stride : target.width);
+            const std::uint8_t* srcBase = source.pixels + static_cast<std::size_t>(src.x) * 4;
+
+            for (int y = y0; y < y1; ++y) {
+                const std::uint32_t v = static_cast<std::uint32_t>(static_cast<std::uint64_t>(y - dest.y) * dv) >> 16;
+                const std::uint8_t* srcRow = srcBase + (src.y + (std::min)(v, static_cast<std::uint32_t>(src.height - 1))) * srcStride;
+                Row(target.pixels + static_cast<std::size_t>(y - target.originY) * dstStride + (x0 - target.originX),
+                    x1 - x0, srcRow, u0, du);
+            }
+        }
+    }
+
+    // Reference path; also what non-x86 builds use.
+    inline void blit_sprite_scalar(const BlitTarget& target, const BlitSource& source,
+        const BlitRect& src, const BlitRect& dest) noexcept
+    {
+        detail::blit<detail::row_scalar>(target, source, src, dest);
+    }
+
+    // Widest path this build was compiled for.
+    inline void blit_sprite(const BlitTarget& target, const BlitSource& source,
+        const BlitRect& src, const BlitRect& dest) noexcept
+    {
+#if defined(ALMOND_BLIT_AVX2)
+        detail::blit<detail::row_avx2>(target, source, src, dest);
+#elif defined(ALMOND_BLIT_SSE2)
+        detail::blit<detail::row_sse2>(target, source, src, dest);
+#else
+        detail::blit<detail::row_scalar>(target, source, src, dest);
+#endif
+    }
+
+    // Nearest goes to blit_sprite(); the filtered paths blend the same way.
+    inline void blit_sprite(const BlitTarget& target, const BlitSource& source,
+        const BlitRect& src, const BlitRect& dest, const SpriteSampling& sampling) noexcept
+    {
+        if (sampling.filter == SampleFilter::Nearest) {
+            blit_sprite(target, source, src, dest);
+            return;
+        }
+#if defined(ALMOND_BLIT_SSE2)
+        detail::blit_filtered<detail::FilterSse2>(target, source, src, dest, sampling);
+#else
+        detail::blit_filtered<detail::FilterScalar>(target, source, src, dest, sampling);
+#endif
+    }
+
+    // Reference for the filtered paths.
+    inline void blit_sprite_scalar(const BlitTarget& target, const BlitSource& source,
+        const BlitRect& src, const BlitRect& dest, const SpriteSampling& sampling) noexcept
+    {
+        if (sampling.filter == SampleFilter::Nearest)
+            detail::blit<detail::row_scalar>(target, source, src, dest);
+        else
+            detail::blit_filtered<detail::FilterScalar>(target, source, src, dest, sampling);
+    }
+
+    [[nodiscard]] constexpr const char* blit_path_name() noexcept
+    {
+#if defined(ALMOND_BLIT_AVX2)
+        return "avx2";
+#elif defined(ALMOND_BLIT_SSE2)
+        return "sse2";
+#else
+        return "scalar";
+#endif
+    }
+}
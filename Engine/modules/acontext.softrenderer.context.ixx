@@ -50,12 +50,15 @@ export module acontext.softrenderer.context;
 import aengine.platform;
 
 import <algorithm>;
+import <atomic>;
 //import <chrono>;
 import <cstdint>;
 import <functional>;
 import <iostream>;
+import <limits>;
 import <memory>;
 import <mutex>;
+import <span>;
 import <utility>;
 import <vector>;
 
@@ -66,6 +69,12 @@ import acontext.softrenderer.state;      // s_softrendererstate, SoftRendState
 import acontext.softrenderer.textures;   // Texture, TexturePtr (as in your project)
 import acontext.softrenderer.renderer;   // SoftwareRenderer (as in your project)
 import aatlas.manager;                  // atlasmanager::atlas_vector (as in your header)
+import aatlas.packer;                   // PackerRect
+import amipmapatlas;                    // mip::MipView, mip::select_level
+import acontext.softrenderer.blit;      // blit::blit_sprite
+import acontext.softrenderer.tiles;     // TileRenderer
+import acontext.softrenderer.mesh;      // Mesh, MeshPipeline
+import aspritetable;                    // TileGrid
 import aengine.diagnostics;
 import aengine.telemetry;
 
@@ -76,6 +85,12 @@ namespace almondnamespace::anativecontext
     // These stay module-internal; nobody else should poke them directly.
     inline TexturePtr       cubeTexture{};
     inline SoftwareRenderer renderer{};
+    inline TileRenderer     tileRenderer{};
+    inline MeshPipeline     meshPipeline{};
+
+    // Set by softrenderer_invalidate() from any thread (window procedures
+    // included); the render thread picks it up before the next resolve.
+    inline std::atomic<bool> presentAll{ false };
 
 #if defined(_WIN32)
     // --- Optional accessors for HWND/HDC without assuming member names exist ---
@@ -140,6 +155,9 @@ export namespace almondnamespace::anativecontext
         sr.framebuffer.assign(
             std::size_t(sr.width) * std::size_t(sr.height),
             0xFF000000u);
+        sr.depthbuffer.assign(sr.framebuffer.size(), (std::numeric_limits<float>::infinity)());
+        sr.depthDirty = false;
+        tileRenderer.invalidate();
 
 #if defined(_WIN32)
         sr.bmi.bmiHeader.biWidth = sr.width;
@@ -188,14 +206,15 @@ export namespace almondnamespace::anativecontext
 
         // Allocate framebuffer
         sr.framebuffer.assign(std::size_t(w) * std::size_t(h), 0xFF000000u);
+        sr.depthbuffer.assign(sr.framebuffer.size(), (std::numeric_limits<float>::infinity)());
 
 #if defined(_WIN32)
         // Prefer explicit parentWnd from multiplexer; fall back to accessor if it exists.
         HWND resolvedParent = parentWnd;
-        if (!resolvedParent)
+        if (!resolvedParent && !sr.headless)
             resolvedParent = try_get_hwnd(*ctx);
 
-        if (!resolvedParent)
+        if (!resolvedParent && !sr.headless)
         {
             std::cerr << "[ SoftRenderer ] -  No parent HWND available. Pass parentWnd from multiplexer.\n";
             return false;
@@ -213,11 +232,15 @@ export namespace almondnamespace::anativecontext
         sr.bmi.bmiHeader.biBitCount = 32;
         sr.bmi.bmiHeader.biCompression = BI_RGB;
 
-        std::cout << "[ SoftRenderer ] -  Initialized. HWND=" << sr.hwnd
-            << " (" << sr.width << "x" << sr.height << ")\n";
+        if (sr.headless)
+            std::cout << "[ SoftRenderer ] -  Initialized headless ("
+                << sr.width << "x" << sr.height << ")\n";
+        else
+            std::cout << "[ SoftRenderer ] -  Initialized. HWND=" << sr.hwnd
+                << " (" << sr.width << "x" << sr.height << ")\n";
 #else
         (void)parentWnd;
-        std::cout << "[ SoftRenderer ] -  Initialized (non-Win32) "
+        std::cout << "[ SoftRenderer ] -  Initialized " << (sr.headless ? "(headless) " : "(non-Win32) ")
             << sr.width << "x" << sr.height << "\n";
 #endif
 
@@ -235,6 +258,10 @@ export namespace almondnamespace::anativecontext
             }
         }
 
+        // Sprites sample pixel_data in place, so there is nothing to upload;
+        // registering keeps retired atlas memory alive until our frame ends.
+        atlasmanager::register_backend_uploader(ctx->type, [](const TextureAtlas&) {});
+
         return true;
     }
 
@@ -282,31 +309,130 @@ export namespace almondnamespace::anativecontext
     }
 
 
-    inline void draw_sprite(
+    // Where a sprite's texels come from for one on-screen size: the atlas
+    // level(s) and source rect(s) the blitter reads.
+    struct SpriteSource
+    {
+        blit::BlitSource texels{};
+        blit::BlitRect src{};
+        blit::SpriteSampling sampling{};
+    };
+
+    inline bool resolve_sprite(
         SpriteHandle handle,
         std::span<const TextureAtlas* const> atlases,
-        float x, float y, float width, float height) noexcept
+        const TextureAtlas*& atlas,
+        AtlasRegion& region) noexcept
     {
         if (!handle.is_valid())
-            return;
+            return false;
 
         const int atlasIdx = static_cast<int>(handle.atlasIndex);
         const int localIdx = static_cast<int>(handle.localIndex);
 
         if (atlasIdx < 0 || atlasIdx >= static_cast<int>(atlases.size()))
-            return;
+            return false;
 
-        const TextureAtlas* atlas = atlases[atlasIdx];
+        atlas = atlases[atlasIdx];
         if (!atlas)
-            return;
+            return false;
 
-        AtlasRegion region{};
         if (!atlas->try_get_entry_info(localIdx, region))
-            return;
+            return false;
 
         // Ensure pixels exist
         if (atlas->pixel_data.empty())
             const_cast<TextureAtlas*>(atlas)->rebuild_pixels();
+        return true;
+    }
+
+    inline void sprite_source(
+        const TextureAtlas& atlas,
+        const AtlasRegion& region,
+        int destW, int destH,
+        blit::SampleFilter filter,
+        SpriteSource& out) noexcept
+    {
+        // Minified draws read the mip level closest to the on-screen size;
+        // trilinear reads the level above the footprint and the one below.
+        std::uint32_t level = 0;
+        std::uint32_t lodFrac = 0;
+        if (atlas.has_mipmaps && atlas.mip_level_count > 0)
+        {
+            atlas.ensure_mipmaps();
+            if (filter == blit::SampleFilter::Trilinear)
+            {
+                const float lod = (std::min)(
+                    mip::select_lod(static_cast<float>(region.width), static_cast<float>(destW), atlas.mip_level_count),
+                    mip::select_lod(static_cast<float>(region.height), static_cast<float>(destH), atlas.mip_level_count));
+                level = static_cast<std::uint32_t>(lod);
+                if (level < atlas.mip_level_count)
+                    lodFrac = static_cast<std::uint32_t>((lod - static_cast<float>(level)) * 256.0f);
+            }
+            else
+            {
+                level = (std::min)(
+                    mip::select_level(static_cast<float>(region.width), static_cast<float>(destW), atlas.mip_level_count),
+                    mip::select_level(static_cast<float>(region.height), static_cast<float>(destH), atlas.mip_level_count));
+            }
+        }
+
+        // Atlas texels are byte RGBA, matching softrenderer_draw_quad().
+        auto level_source = [&](std::uint32_t l, blit::BlitSource& texels, blit::BlitRect& src)
+            {
+                const mip::MipView view = atlas.mip_view(l);
+                const PackerRect source = mip::scale_rect({ region.x, region.y, region.width, region.height }, view.level);
+
+                // Odd-sized levels round down, so keep the outward-rounded rect inside them.
+                const std::uint32_t srcX0 = (std::min)(source.x, view.width);
+                const std::uint32_t srcY0 = (std::min)(source.y, view.height);
+                texels = { view.pixels, view.width, view.height, atlas.version };
+                src = {
+                    static_cast<int>(srcX0), static_cast<int>(srcY0),
+                    static_cast<int>((std::min)(source.x + (std::max)(1u, source.width), view.width) - srcX0),
+                    static_cast<int>((std::min)(source.y + (std::max)(1u, source.height), view.height) - srcY0) };
+            };
+
+        level_source(level, out.texels, out.src);
+
+        out.sampling = { filter };
+        if (lodFrac > 0)
+        {
+            level_source(level + 1, out.sampling.coarse, out.sampling.coarseSrc);
+            out.sampling.lodFrac = lodFrac;
+        }
+
+        if (atlas.sdf_scale > 0.0f && out.src.width > 0 && out.src.height > 0)
+        {
+            const float pixelsPerTexel = (std::min)(
+                static_cast<float>(destW) / static_cast<float>(out.src.width),
+                static_cast<float>(destH) / static_cast<float>(out.src.height));
+            blit::distance_field(out.sampling, atlas.sdf_scale, pixelsPerTexel);
+        }
+    }
+
+    inline void submit_sprite_source(const SpriteSource& source, const blit::BlitRect& dest) noexcept
+    {
+        auto& sr = s_softrendererstate;
+        if (tileRenderer.recording())
+            tileRenderer.submit_sprite(source.texels, source.src, dest, source.sampling);
+        else
+            blit::blit_sprite({ sr.framebuffer.data(), sr.width, sr.height }, source.texels, source.src, dest, source.sampling);
+    }
+
+    // draw_sprite() with a chosen filter. Bilinear smooths scaled sprites;
+    // Trilinear also blends between the two nearest mip levels when the
+    // atlas has them. Both cost more than the default nearest sampling.
+    inline void draw_sprite_filtered(
+        SpriteHandle handle,
+        std::span<const TextureAtlas* const> atlases,
+        float x, float y, float width, float height,
+        blit::SampleFilter filter) noexcept
+    {
+        const TextureAtlas* atlas = nullptr;
+        AtlasRegion region{};
+        if (!resolve_sprite(handle, atlases, atlas, region))
+            return;
 
         auto& sr = s_softrendererstate;
         if (sr.framebuffer.empty() || sr.width <= 0 || sr.height <= 0)
@@ -347,67 +473,112 @@ export namespace almondnamespace::anativecontext
         if (clipX0 >= clipX1 || clipY0 >= clipY1)
             return;
 
-        const int srcW = static_cast<int>((std::max)(1u, region.width));
-        const int srcH = static_cast<int>((std::max)(1u, region.height));
-
-        const float invDestW = 1.0f / static_cast<float>(destW);
-        const float invDestH = 1.0f / static_cast<float>(destH);
+        SpriteSource source{};
+        sprite_source(*atlas, region, destW, destH, filter, source);
+        submit_sprite_source(source, { destX, destY, destW, destH });
+    }
 
-        // atlas->pixel_data is byte RGBA, matching softrenderer_draw_quad().
-        for (int py = clipY0; py < clipY1; ++py)
-        {
-            const float v = (py - destY) * invDestH;
-            const int sampleY = std::clamp(static_cast<int>(std::floor(v * srcH)), 0, srcH - 1);
+    inline void draw_sprite(
+        SpriteHandle handle,
+        std::span<const TextureAtlas* const> atlases,
+        float x, float y, float width, float height) noexcept
+    {
+        draw_sprite_filtered(handle, atlases, x, y, width, height, blit::SampleFilter::Nearest);
+    }
 
-            for (int px = clipX0; px < clipX1; ++px)
-            {
-                const float u = (px - destX) * invDestW;
-                const int sampleX = std::clamp(static_cast<int>(std::floor(u * srcW)), 0, srcW - 1);
+    // Context::draw_tilemap. Each palette entry is resolved once per map;
+    // every cell then only costs its blit. Coordinates are in pixels, and
+    // cells land exactly where per-cell draw_sprite() calls would put them.
+    inline void draw_tilemap(
+        std::span<const SpriteHandle> palette,
+        std::span<const std::uint16_t> cells,
+        int cols, int rows,
+        const TileGrid& grid,
+        std::span<const TextureAtlas* const> atlases) noexcept
+    {
+        auto& sr = s_softrendererstate;
+        if (sr.framebuffer.empty() || sr.width <= 0 || sr.height <= 0)
+            return;
+        if (cols <= 0 || rows <= 0 || cells.size() < std::size_t(cols) * std::size_t(rows))
+            return;
+        if (!(grid.cellWidth > 0.f) || !(grid.cellHeight > 0.f))
+            return;
 
-                const int atlasX = static_cast<int>(region.x) + sampleX;
-                const int atlasY = static_cast<int>(region.y) + sampleY;
+        const int destW = (std::max)(1, static_cast<int>(std::lround(grid.cellWidth)));
+        const int destH = (std::max)(1, static_cast<int>(std::lround(grid.cellHeight)));
 
-                // bounds (no signed/unsigned mismatch)
-                if (static_cast<unsigned>(atlasX) >= static_cast<unsigned>(atlas->width) ||
-                    static_cast<unsigned>(atlasY) >= static_cast<unsigned>(atlas->height))
-                    continue;
+        // Render thread only, like the rest of the software state.
+        static std::vector<SpriteSource> tilemapSources{};
+        static std::vector<std::uint8_t> tilemapResolved{};
+        tilemapSources.resize(palette.size());
+        tilemapResolved.assign(palette.size(), 0);
+        for (std::size_t i = 0; i < palette.size(); ++i)
+        {
+            const TextureAtlas* atlas = nullptr;
+            AtlasRegion region{};
+            if (!resolve_sprite(palette[i], atlases, atlas, region))
+                continue;
+            sprite_source(*atlas, region, destW, destH, blit::SampleFilter::Nearest, tilemapSources[i]);
+            tilemapResolved[i] = 1;
+        }
 
-                const size_t srcIndex =
-                    (static_cast<size_t>(atlasY) * static_cast<size_t>(atlas->width) + static_cast<size_t>(atlasX)) * 4u;
+        for (int row = 0; row < rows; ++row)
+        {
+            const int destY = static_cast<int>(std::floor(grid.y + grid.cellHeight * float(row)));
+            if (destY >= sr.height || destY + destH <= 0)
+                continue;
 
-                if (srcIndex + 3u >= static_cast<size_t>(atlas->pixel_data.size()))
+            const std::uint16_t* line = cells.data() + std::size_t(row) * std::size_t(cols);
+            for (int col = 0; col < cols; ++col)
+            {
+                const std::uint16_t cell = line[col];
+                if (cell >= tilemapResolved.size() || !tilemapResolved[cell])
                     continue;
 
-                const uint8_t srcR = atlas->pixel_data[srcIndex + 0];
-                const uint8_t srcG = atlas->pixel_data[srcIndex + 1];
-                const uint8_t srcB = atlas->pixel_data[srcIndex + 2];
-                const uint8_t srcA = atlas->pixel_data[srcIndex + 3];
-                if (srcA == 0)
+                const int destX = static_cast<int>(std::floor(grid.x + grid.cellWidth * float(col)));
+                if (destX >= sr.width || destX + destW <= 0)
                     continue;
 
-                const size_t dstIndex =
-                    static_cast<size_t>(py) * static_cast<size_t>(sr.width) + static_cast<size_t>(px);
-
-                const uint32_t dst = sr.framebuffer[dstIndex];
+                submit_sprite_source(tilemapSources[cell], { destX, destY, destW, destH });
+            }
+        }
+    }
 
-                const float a = static_cast<float>(srcA) / 255.0f;
-                const float ia = 1.0f - a;
 
-                const uint8_t dstR = static_cast<uint8_t>((dst >> 16) & 0xFF);
-                const uint8_t dstG = static_cast<uint8_t>((dst >> 8) & 0xFF);
-                const uint8_t dstB = static_cast<uint8_t>(dst & 0xFF);
+    // Draws an indexed mesh, depth-tested against the frame's depth buffer.
+    // Inside a tiled frame the triangles are binned and drawn at resolve.
+    inline void draw_mesh(const Mesh& mesh, const MeshDrawParams& params)
+    {
+        auto& sr = s_softrendererstate;
+        if (sr.framebuffer.empty() || sr.width <= 0 || sr.height <= 0)
+            return;
 
-                const uint8_t outR = static_cast<uint8_t>(srcR * a + dstR * ia + 0.5f);
-                const uint8_t outG = static_cast<uint8_t>(srcG * a + dstG * ia + 0.5f);
-                const uint8_t outB = static_cast<uint8_t>(srcB * a + dstB * ia + 0.5f);
+        if (sr.depthbuffer.size() != sr.framebuffer.size())
+            sr.depthbuffer.assign(sr.framebuffer.size(), (std::numeric_limits<float>::infinity)());
+        sr.depthDirty = true;
 
-                sr.framebuffer[dstIndex] =
-                    (0xFFu << 24) | (uint32_t(outR) << 16) | (uint32_t(outG) << 8) | uint32_t(outB);
-            }
+        if (tileRenderer.recording())
+        {
+            meshPipeline.process(mesh, params, sr.width, sr.height,
+                [](const SoftwareRenderer::TriangleSetup& setup) { tileRenderer.submit_setup(setup); });
+        }
+        else
+        {
+            meshPipeline.draw(mesh, params,
+                { sr.framebuffer.data(), sr.depthbuffer.data(), 0, 0, sr.width, sr.height, sr.width },
+                sr.width, sr.height);
         }
     }
 
 
+    // Makes the next frame redraw and present everything, e.g. after the
+    // window was uncovered or something outside the tile renderer drew.
+    // Safe to call from the window thread.
+    inline void softrenderer_invalidate() noexcept
+    {
+        presentAll.store(true, std::memory_order_release);
+    }
+
     bool softrenderer_process(core::Context& ctx, core::CommandQueue& queue)
     {
         auto& sr = s_softrendererstate;
@@ -417,6 +588,7 @@ export namespace almondnamespace::anativecontext
             : 0;
 
         almond::diagnostics::FrameTiming frameTimer{ ctx.type, windowId, "Software" };
+        atlasmanager::mark_quiescent(ctx.type);
 
         // Clear
         const auto clearColor = core::clear_color_for_context(core::ContextType::Software);
@@ -433,7 +605,20 @@ export namespace almondnamespace::anativecontext
             | (std::uint32_t(clearR) << 16)
             | (std::uint32_t(clearG) << 8)
             | std::uint32_t(clearB);
-        std::fill(sr.framebuffer.begin(), sr.framebuffer.end(), packedColor);
+        // Tiled frames clear per tile, and only the tiles whose draws changed.
+        if (sr.tiledRendering)
+        {
+            tileRenderer.begin_frame(sr.width, sr.height, packedColor);
+        }
+        else
+        {
+            std::fill(sr.framebuffer.begin(), sr.framebuffer.end(), packedColor);
+            if (sr.depthDirty)
+            {
+                std::fill(sr.depthbuffer.begin(), sr.depthbuffer.end(), (std::numeric_limits<float>::infinity)());
+                sr.depthDirty = false;
+            }
+        }
 
         telemetry::emit_gauge(
             "renderer.framebuffer.size",
@@ -466,13 +651,34 @@ export namespace almondnamespace::anativecontext
         }
         queue.drain();
 
+        // A frame with no dirty tiles presents nothing, so a repaint request
+        // (expose, restore, resize) has to force the whole frame out.
+        if (presentAll.exchange(false, std::memory_order_acq_rel))
+            tileRenderer.invalidate();
+
+        const DirtyRect wholeFrame{ 0, 0, sr.width, sr.height };
+        std::span<const DirtyRect> dirty{ &wholeFrame, 1 };
+        if (tileRenderer.recording())
+        {
+            tileRenderer.resolve(sr.framebuffer, sr.depthbuffer);
+            dirty = tileRenderer.dirty_rects();
+            telemetry::emit_gauge(
+                "renderer.tiles.active",
+                static_cast<std::int64_t>(tileRenderer.tiles_touched()),
+                telemetry::RendererTelemetryTags{ ctx.type, windowId });
+            telemetry::emit_gauge(
+                "renderer.tiles.redrawn",
+                static_cast<std::int64_t>(tileRenderer.tiles_redrawn()),
+                telemetry::RendererTelemetryTags{ ctx.type, windowId });
+        }
+
 #if defined(_WIN32)
-        // Present
+        // Present only what changed; an unchanged frame skips presenting.
         // Prefer HDC accessor if it exists; otherwise use GetDC on the stored HWND.
-        HDC hdc = try_get_hdc(ctx);
+        HDC hdc = (sr.headless || dirty.empty()) ? nullptr : try_get_hdc(ctx);
         bool tempDC = false;
 
-        if (!hdc && sr.hwnd)
+        if (!hdc && sr.hwnd && !sr.headless && !dirty.empty())
         {
             hdc = GetDC(sr.hwnd);
             tempDC = (hdc != nullptr);
@@ -480,14 +686,18 @@ export namespace almondnamespace::anativecontext
 
         if (hdc)
         {
-            StretchDIBits(
-                hdc,
-                0, 0, sr.width, sr.height,
-                0, 0, sr.width, sr.height,
-                sr.framebuffer.data(),
-                &sr.bmi,
-                DIB_RGB_COLORS,
-                SRCCOPY);
+            for (const DirtyRect& r : dirty)
+            {
+                // The source y of a top-down DIB is still measured from the bottom.
+                StretchDIBits(
+                    hdc,
+                    r.x, r.y, r.width, r.height,
+                    r.x, sr.height - (r.y + r.height), r.width, r.height,
+                    sr.framebuffer.data(),
+                    &sr.bmi,
+                    DIB_RGB_COLORS,
+                    SRCCOPY);
+            }
 
             if (tempDC && sr.hwnd)
                 ReleaseDC(sr.hwnd, hdc);
@@ -498,12 +708,15 @@ export namespace almondnamespace::anativecontext
         return true;
     }
 
-    void softrenderer_cleanup(std::shared_ptr<core::Context>& /*ctx*/)
+    void softrenderer_cleanup(std::shared_ptr<core::Context>& ctx)
     {
         auto& sr = s_softrendererstate;
 
+        atlasmanager::unregister_backend_uploader(ctx ? ctx->type : core::ContextType::Software);
+
         sr.framebuffer.clear();
         cubeTexture.reset();
+        tileRenderer.shutdown();
 
         // DO NOT DestroyWindow here. This backend does not own the window.
         sr.hwnd = nullptr;
@@ -0,0 +1,200 @@
+/**************************************************************
+ *   AlmondShell - Modular C++ Framework
+ **************************************************************/
+ // acontext.softrenderer.headless.ixx
+ //
+ // Window-less mode for the software backend. Frames render into
+ // SoftRendState::framebuffer exactly as they would on screen but
+ // are never presented; instead each one can be hashed (for golden
+ // image checks) and/or written to disk through aimage.writer.
+ // run_headless_frames() drives N frames back to back, which gives
+ // deterministic rendering benchmarks on machines without a display.
+
+module;
+
+#include <include/aengine.config.hpp> // for ALMOND_USING Macros
+
+export module acontext.softrenderer.headless;
+
+#if defined(ALMOND_USING_SOFTWARE_RENDERER)
+
+import <algorithm>;
+import <chrono>;
+import <cstdint>;
+import <filesystem>;
+import <format>;
+import <functional>;
+import <iostream>;
+import <memory>;
+import <span>;
+import <string>;
+import <system_error>;
+import <vector>;
+
+import aengine.core.context;             // core::Context
+import aengine.context.commandqueue;     // core::CommandQueue
+import aimage.writer;                    // a_writeImage
+import acontext.softrenderer.state;      // s_softrendererstate
+import acontext.softrenderer.context;    // softrenderer_initialize / _process / _cleanup
+
+export namespace almondnamespace::anativecontext
+{
+    struct HeadlessOptions
+    {
+        int width{ 1280 };
+        int height{ 720 };
+        std::filesystem::path dumpDirectory{}; // empty = don't write frames
+        std::string dumpExtension{ ".tga" };   // .bmp, .tga or .ppm (see a_writeImage)
+        int dumpEvery{ 1 };                    // write every n-th frame
+        bool hashFrames{ true };
+    };
+
+    struct HeadlessStats
+    {
+        int frames{ 0 };
+        int dumped{ 0 };
+        double totalMs{ 0.0 };
+        std::uint64_t lastHash{ 0 };     // hash of the most recent frame
+        std::uint64_t sequenceHash{ 0 }; // all frame hashes so far, in order
+
+        [[nodiscard]] double ms_per_frame() const noexcept { return frames > 0 ? totalMs / frames : 0.0; }
+    };
+
+    // FNV-1a over the frame size and the 0xAARRGGBB pixel values, so the
+    // result does not depend on host byte order.
+    inline std::uint64_t frame_hash(std::span<const std::uint32_t> pixels, int width, int height) noexcept
+    {
+        constexpr std::uint64_t kPrime = 0x100000001B3ull;
+        std::uint64_t hash = 0xCBF29CE484222325ull;
+        hash = (hash ^ static_cast<std::uint32_t>(width)) * kPrime;
+        hash = (hash ^ static_cast<std::uint32_t>(height)) * kPrime;
+        for (const std::uint32_t pixel : pixels)
+            hash = (hash ^ pixel) * kPrime;
+        return hash;
+    }
+
+    // Writes the current software framebuffer; the format follows the extension.
+    inline bool dump_frame(const std::filesystem::path& path)
+    {
+        const auto& sr = s_softrendererstate;
+        if (sr.width <= 0 || sr.height <= 0 || sr.framebuffer.size() < std::size_t(sr.width) * std::size_t(sr.height))
+            return false;
+
+        std::vector<std::uint8_t> rgba(sr.framebuffer.size() * 4u);
+        for (std::size_t i = 0; i < sr.framebuffer.size(); ++i) {
+            const std::uint32_t p = sr.framebuffer[i];
+            rgba[i * 4 + 0] = static_cast<std::uint8_t>(p >> 16);
+            rgba[i * 4 + 1] = static_cast<std::uint8_t>(p >> 8);
+            rgba[i * 4 + 2] = static_cast<std::uint8_t>(p);
+            rgba[i * 4 + 3] = static_cast<std::uint8_t>(p >> 24);
+        }
+        return a_writeImage(path, rgba, sr.width, sr.height);
+    }
+}
+
+namespace almondnamespace::anativecontext
+{
+    inline HeadlessOptions headlessOptions{};
+    inline HeadlessStats   headlessStats{};
+
+    // Called after every headless frame has been rendered.
+    inline void record_headless_frame()
+    {
+        const auto& sr = s_softrendererstate;
+        const int frame = headlessStats.frames++;
+
+        if (headlessOptions.hashFrames) {
+            headlessStats.lastHash = frame_hash(sr.framebuffer, sr.width, sr.height);
+            headlessStats.sequenceHash = (headlessStats.sequenceHash ^ headlessStats.lastHash) * 0x100000001B3ull;
+        }
+
+        if (!headlessOptions.dumpDirectory.empty() && frame % (std::max)(1, headlessOptions.dumpEvery) == 0) {
+            const auto path = headlessOptions.dumpDirectory
+                / std::format("frame_{:05}{}", frame, headlessOptions.dumpExtension);
+            if (dump_frame(path))
+                ++headlessStats.dumped;
+            else
+                std::cerr << "[ SoftRenderer ] -  Failed to write " << path.string() << "\n";
+        }
+    }
+}
+
+export namespace almondnamespace::anativecontext
+{
+    // Must be called before headless_initialize() to take effect.
+    inline void configure_headless(const HeadlessOptions& options)
+    {
+        headlessOptions = options;
+    }
+
+    [[nodiscard]] inline const HeadlessStats& headless_stats() noexcept { return headlessStats; }
+
+    inline bool headless_initialize(std::shared_ptr<core::Context> ctx)
+    {
+        if (!ctx)
+            return false;
+
+        ctx->width = (std::max)(1, headlessOptions.width);
+        ctx->height = (std::max)(1, headlessOptions.height);
+
+        if (!headlessOptions.dumpDirectory.empty()) {
+            std::error_code ec;
+            std::filesystem::create_directories(headlessOptions.dumpDirectory, ec);
+            if (ec) {
+                std::cerr << "[ SoftRenderer ] -  Cannot create " << headlessOptions.dumpDirectory.string()
+                    << ": " << ec.message() << "\n";
+                return false;
+            }
+        }
+
+        headlessStats = {};
+        s_softrendererstate.headless = true;
+        if (!softrenderer_initialize(ctx, nullptr,
+            static_cast<unsigned>(ctx->width), static_cast<unsigned>(ctx->height)))
+        {
+            s_softrendererstate.headless = false;
+            return false;
+        }
+        // The frame size is fixed; nothing resizes a headless context.
+        ctx->onResize = nullptr;
+        s_softrendererstate.onResize = nullptr;
+        return true;
+    }
+
+    // Same signature as Context::ProcessFunc.
+    inline bool headless_process(std::shared_ptr<core::Context> ctx, core::CommandQueue& queue)
+    {
+        if (!ctx)
+            return false;
+
+        // Only rendering is timed; hashing and file output are not.
+        const auto start = std::chrono::steady_clock::now();
+        const bool running = softrenderer_process(*ctx, queue);
+        headlessStats.totalMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        record_headless_frame();
+        return running;
+    }
+
+    // Renders `frames` frames back to back. `enqueue(frame)` runs before each
+    // one and typically pushes that frame's draws onto `queue`.
+    inline HeadlessStats run_headless_frames(std::shared_ptr<core::Context> ctx, core::CommandQueue& queue,
+        int frames, const std::function<void(int)>& enqueue = {})
+    {
+        for (int frame = 0; frame < frames; ++frame) {
+            if (enqueue)
+                enqueue(frame);
+            if (!headless_process(ctx, queue))
+                break;
+        }
+        return headlessStats;
+    }
+
+    inline void headless_cleanup(std::shared_ptr<core::Context>& ctx)
+    {
+        softrenderer_cleanup(ctx); // also resets SoftRendState::headless
+    }
+}
+
+#else
+export namespace almondnamespace::anativecontext {}
+#endif // ALMOND_USING_SOFTWARE_RENDERER
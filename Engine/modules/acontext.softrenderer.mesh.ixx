@@ -0,0 +1,254 @@
+/**************************************************************
+ *   AlmondShell - Modular C++ Framework
+ **************************************************************/
+ // acontext.softrenderer.mesh.ixx
+ //
+ // Indexed mesh path for the software renderer: vertices are
+ // transformed to clip space in batches, triangles are clipped
+ // against the near plane, projected, and handed to the shared
+ // rasterizer setup, either drawn straight into a target or
+ // passed on (e.g. to the tile renderer).
+
+module;
+
+#include <include/aengine.config.hpp> // for ALMOND_USING Macros
+
+export module acontext.softrenderer.mesh;
+
+#if defined(ALMOND_USING_SOFTWARE_RENDERER)
+
+import <array>;
+import <cstddef>;
+import <cstdint>;
+import <span>;
+import <utility>;
+import <vector>;
+
+import acontext.softrenderer.blit;      // blit::SampleFilter
+import acontext.softrenderer.renderer;  // SoftwareRenderer, Vertex, Mat4
+import acontext.softrenderer.textures;  // TexturePtr
+
+export namespace almondnamespace::anativecontext
+{
+    struct Mesh
+    {
+        std::vector<Vertex> vertices;
+        std::vector<std::uint32_t> indices; // triangle list
+
+        // Copies any vertex layout with `pos` and `texCoord` (or `uv`) members,
+        // e.g. the Vulkan backend's Application::Vertex.
+        template<class V, class I>
+        static Mesh from_buffers(std::span<const V> vertices, std::span<const I> indices)
+        {
+            Mesh mesh{};
+            mesh.vertices.reserve(vertices.size());
+            for (const V& v : vertices) {
+                Vertex out{};
+                out.pos = { v.pos.x, v.pos.y, v.pos.z };
+                if constexpr (requires { v.texCoord.x; })
+                    out.uv = { v.texCoord.x, v.texCoord.y };
+                else
+                    out.uv = { v.uv.u, v.uv.v };
+                mesh.vertices.push_back(out);
+            }
+            mesh.indices.assign(indices.begin(), indices.end());
+            return mesh;
+        }
+    };
+
+    // The unit cube used by the Vulkan backend (acontext.vulkan.meshcube):
+    // 24 vertices with per-face uvs, counter-clockwise faces.
+    inline Mesh make_cube_mesh()
+    {
+        static constexpr std::array<Vertex, 24> kVertices = { {
+            {{-0.5f, -0.5f,  0.5f}, {0, 0}}, {{ 0.5f, -0.5f,  0.5f}, {1, 0}},
+            {{ 0.5f,  0.5f,  0.5f}, {1, 1}}, {{-0.5f,  0.5f,  0.5f}, {0, 1}},
+
+            {{ 0.5f, -0.5f, -0.5f}, {0, 0}}, {{-0.5f, -0.5f, -0.5f}, {1, 0}},
+            {{-0.5f,  0.5f, -0.5f}, {1, 1}}, {{ 0.5f,  0.5f, -0.5f}, {0, 1}},
+
+            {{-0.5f, -0.5f, -0.5f}, {0, 0}}, {{-0.5f, -0.5f,  0.5f}, {1, 0}},
+            {{-0.5f,  0.5f,  0.5f}, {1, 1}}, {{-0.5f,  0.5f, -0.5f}, {0, 1}},
+
+            {{ 0.5f, -0.5f,  0.5f}, {0, 0}}, {{ 0.5f, -0.5f, -0.5f}, {1, 0}},
+            {{ 0.5f,  0.5f, -0.5f}, {1, 1}}, {{ 0.5f,  0.5f,  0.5f}, {0, 1}},
+
+            {{-0.5f,  0.5f,  0.5f}, {0, 0}}, {{ 0.5f,  0.5f,  0.5f}, {1, 0}},
+            {{ 0.5f,  0.5f, -0.5f}, {1, 1}}, {{-0.5f,  0.5f, -0.5f}, {0, 1}},
+
+            {{-0.5f, -0.5f, -0.5f}, {0, 0}}, {{ 0.5f, -0.5f, -0.5f}, {1, 0}},
+            {{ 0.5f, -0.5f,  0.5f}, {1, 1}}, {{-0.5f, -0.5f,  0.5f}, {0, 1}},
+        } };
+
+        static constexpr std::array<std::uint32_t, 36> kIndices = { {
+            0, 1, 2,  0, 2, 3,
+            4, 5, 6,  4, 6, 7,
+            8, 9, 10,  8, 10, 11,
+            12, 13, 14,  12, 14, 15,
+            16, 17, 18,  16, 18, 19,
+            20, 21, 22,  20, 22, 23
+        } };
+
+        Mesh mesh{};
+        mesh.vertices.assign(kVertices.begin(), kVertices.end());
+        mesh.indices.assign(kIndices.begin(), kIndices.end());
+        return mesh;
+    }
+
+    struct MeshDrawParams
+    {
+        Mat4 model = SoftwareRenderer::identity();
+        Mat4 view = SoftwareRenderer::identity();
+        Mat4 proj = SoftwareRenderer::identity();
+        TexturePtr texture{};
+        std::uint32_t color = 0xFFFFFFFFu;
+        CullMode cull = CullMode::None;
+        blit::SampleFilter filter = blit::SampleFilter::Nearest;
+    };
+
+    class MeshPipeline
+    {
+    public:
+        // Transforms and clips `mesh`, calling `emit(const TriangleSetup&)` for
+        // every triangle that reaches a `width` x `height` frame, in index order.
+        template<class Emit>
+        std::size_t process(const Mesh& mesh, const MeshDrawParams& params, int width, int height, Emit&& emit)
+        {
+            if (mesh.vertices.empty() || mesh.indices.size() < 3 || width <= 0 || height <= 0)
+                return 0;
+
+            const Mat4 mvp = SoftwareRenderer::mul(params.proj, SoftwareRenderer::mul(params.view, params.model));
+            clip_.resize(mesh.vertices.size());
+            SoftwareRenderer::transform_points(mvp, &mesh.vertices.front().pos.x, sizeof(Vertex),
+                mesh.vertices.size(), clip_.data());
+
+            std::size_t emitted = 0;
+            SoftwareRenderer::TriangleSetup setup{};
+            const std::size_t vertexCount = mesh.vertices.size();
+            for (std::size_t t = 0; t + 2 < mesh.indices.size(); t += 3) {
+                const std::uint32_t i0 = mesh.indices[t];
+                const std::uint32_t i1 = mesh.indices[t + 1];
+                const std::uint32_t i2 = mesh.indices[t + 2];
+                if (i0 >= vertexCount || i1 >= vertexCount || i2 >= vertexCount)
+                    continue;
+
+                const ClipVertex tri[3] = {
+                    { clip_[i0], mesh.vertices[i0].uv },
+                    { clip_[i1], mesh.vertices[i1].uv },
+                    { clip_[i2], mesh.vertices[i2].uv },
+                };
+
+                ClipVertex poly[4]{};
+                const int count = clip_near(tri, poly);
+
+                ScreenVertex screen[4]{};
+                for (int i = 0; i < count; ++i)
+                    screen[i] = to_screen(poly[i], width, height);
+
+                // The clipped polygon is convex: fan it from the first vertex.
+                for (int i = 1; i + 1 < count; ++i) {
+                    const ScreenVertex fan[3] = { screen[0], screen[i], screen[i + 1] };
+                    if (SoftwareRenderer::setup_projected(fan, width, height, params.cull,
+                        params.texture, params.color, params.filter, setup)) {
+                        emit(std::as_const(setup));
+                        ++emitted;
+                    }
+                }
+            }
+            return emitted;
+        }
+
+        // Draws `mesh` into `target`, a window of a `width` x `height` frame.
+        std::size_t draw(const Mesh& mesh, const MeshDrawParams& params,
+            const SoftwareRenderer::RasterTarget& target, int width, int height)
+        {
+            return process(mesh, params, width, height, [&](const SoftwareRenderer::TriangleSetup& setup) {
+                SoftwareRenderer::rasterize_setup(setup, target);
+            });
+        }
+
+    private:
+        struct ClipVertex
+        {
+            Vec4 pos{};
+            Vec2 uv{};
+        };
+
+        // Sutherland-Hodgman against z >= -w. Triangles entirely outside one of
+        // the side planes are dropped here too. Returns 0, 3 or 4 vertices.
+        static int clip_near(const ClipVertex (&in)[3], ClipVertex (&out)[4])
+        {
+            auto outside_all = [&](auto&& outside) {
+                return outside(in[0].pos) && outside(in[1].pos) && outside(in[2].pos);
+            };
+            if (outside_all([](const Vec4& p) { return p.x > p.w; })
+                || outside_all([](const Vec4& p) { return p.x < -p.w; })
+                || outside_all([](const Vec4& p) { return p.y > p.w; })
+                || outside_all([](const Vec4& p) { return p.y < -p.w; }))
+                return 0;
+
+            float d[3]{};
+            bool allInside = true;
+            for (int i = 0; i < 3; ++i) {
+                d[i] = in[i].pos.z + in[i].pos.w;
+                allInside = allInside && d[i] >= 0.0f;
+            }
+            if (allInside) {
+                out[0] = in[0];
+                out[1] = in[1];
+                out[2] = in[2];
+                return 3;
+            }
+
+            int count = 0;
+            for (int i = 0; i < 3; ++i) {
+                const int j = (i + 1) % 3;
+                if (d[i] >= 0.0f)
+                    out[count++] = in[i];
+                if ((d[i] >= 0.0f) != (d[j] >= 0.0f)) {
+                    const float t = d[i] / (d[i] - d[j]);
+                    const ClipVertex& a = in[i];
+                    const ClipVertex& b = in[j];
+                    out[count++] = {
+                        { a.pos.x + (b.pos.x - a.pos.x) * t, a.pos.y + (b.pos.y - a.pos.y) * t,
+                          a.pos.z + (b.pos.z - a.pos.z) * t, a.pos.w + (b.pos.w - a.pos.w) * t },
+                        { a.uv.u + (b.uv.u - a.uv.u) * t, a.uv.v + (b.uv.v - a.uv.v) * t } };
+                }
+            }
+
+            for (int i = 0; i < count; ++i)
+                if (out[i].pos.w <= 0.0f)
+                    return 0;
+            return count;
+        }
+
+        // Clip space (y up) to pixels (y down).
+        static ScreenVertex to_screen(const ClipVertex& v, int width, int height)
+        {
+            const float invW = 1.0f / v.pos.w;
+            return {
+                (v.pos.x * invW * 0.5f + 0.5f) * float(width),
+                (0.5f - v.pos.y * invW * 0.5f) * float(height),
+                invW,
+                v.uv
+            };
+        }
+
+        std::vector<Vec4> clip_;
+    };
+
+    // Headless convenience: draws into `fb`, depth-tested against fb.depth.
+    // Call fb.clear_depth() once per frame; it is allocated here if missing.
+    inline std::size_t render_mesh(Framebuffer& fb, MeshPipeline& pipeline, const Mesh& mesh, const MeshDrawParams& params)
+    {
+        if (fb.depth.size() != fb.pixels.size())
+            fb.clear_depth();
+
+        return pipeline.draw(mesh, params,
+            { fb.pixels.data(), fb.depth.data(), 0, 0, fb.width, fb.height, fb.width }, fb.width, fb.height);
+    }
+}
+
+#else
+export namespace almondnamespace::anativecontext {}
+#endif // ALMOND_USING_SOFTWARE_RENDERER
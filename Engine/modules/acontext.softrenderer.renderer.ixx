@@ -29,6 +29,15 @@ module;
 //#include "aplatform.hpp"
 #include <include/aengine.config.hpp> // for ALMOND_USING Macros
 
+#if defined(__AVX2__)
+#   include <immintrin.h>
+#   define ALMOND_RASTER_AVX2 1
+#   define ALMOND_RASTER_SSE2 1
+#elif defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#   include <emmintrin.h>
+#   define ALMOND_RASTER_SSE2 1
+#endif
+
 export module acontext.softrenderer.renderer;
 
 #if defined(ALMOND_USING_SOFTWARE_RENDERER)
@@ -36,6 +45,8 @@ export module acontext.softrenderer.renderer;
 import aengine.platform;
 
 import <algorithm>;
+import <array>;
+import <bit>;
 import <cstdint>;
 import <cmath>;
 import <limits>;
@@ -44,10 +55,12 @@ import <vector>;
 // Provides TexturePtr / Texture (with sample(), width/height).
 // If your textures unit is named differently, change this import to match.
 import acontext.softrenderer.textures;
+import acontext.softrenderer.blit;      // blit::SampleFilter
 
 export namespace almondnamespace::anativecontext
 {
     struct Vec3 { float x = 0.0f, y = 0.0f, z = 0.0f; };
+    struct Vec4 { float x = 0.0f, y = 0.0f, z = 0.0f, w = 0.0f; };
     struct Vec2 { float u = 0.0f, v = 0.0f; };
     struct Mat4 { float m[4][4] = {}; };
     export struct Vertex { Vec3 pos; Vec2 uv; };
@@ -59,6 +72,19 @@ export namespace almondnamespace::anativecontext
         Vertex v2{};
         TexturePtr tex{};
         std::uint32_t color = 0xFFFFFFFFu;
+        blit::SampleFilter filter = blit::SampleFilter::Nearest; // Trilinear samples as Bilinear (no mips)
+    };
+
+    // Which screen-space winding is dropped. Front faces are counter-clockwise
+    // in clip space (y up), as in the Vulkan pipeline.
+    enum class CullMode : std::uint8_t { None, Back, Front };
+
+    // A vertex after projection: pixel position, 1/w and uv.
+    struct ScreenVertex
+    {
+        float x = 0.0f, y = 0.0f;
+        float invW = 0.0f;
+        Vec2 uv{};
     };
 
     export struct Camera
@@ -74,6 +100,7 @@ export namespace almondnamespace::anativecontext
         int width = 0;
         int height = 0;
         std::vector<std::uint32_t> pixels;
+        std::vector<float> depth; // allocated on first depth-tested draw, then reused
 
         Framebuffer() = default;
         Framebuffer(int w, int h) : width(w), height(h), pixels(std::size_t(w)* std::size_t(h), 0xFF101010u) {}
@@ -83,6 +110,12 @@ export namespace almondnamespace::anativecontext
             std::fill(pixels.begin(), pixels.end(), color);
         }
 
+        inline void clear_depth()
+        {
+            depth.resize(pixels.size());
+            std::fill(depth.begin(), depth.end(), (std::numeric_limits<float>::infinity)());
+        }
+
         inline void put_pixel(int x, int y, std::uint32_t color)
         {
             if (x < 0 || y < 0 || x >= width || y >= height) return;
@@ -138,23 +171,119 @@ export namespace almondnamespace::anativecontext
             return m;
         }
 
+        static Mat4 identity()
+        {
+            Mat4 m{};
+            m.m[0][0] = m.m[1][1] = m.m[2][2] = m.m[3][3] = 1.0f;
+            return m;
+        }
+
+        static Mat4 translation(const Vec3& t)
+        {
+            Mat4 m = identity();
+            m.m[0][3] = t.x;
+            m.m[1][3] = t.y;
+            m.m[2][3] = t.z;
+            return m;
+        }
+
+        // Right-handed, camera looking down -z, clip z in [-w, w] (GL style).
+        static Mat4 perspective(float fovY, float aspect, float nearZ, float farZ)
+        {
+            const float f = 1.0f / std::tan(fovY * 0.5f);
+            Mat4 m{};
+            m.m[0][0] = f / aspect;
+            m.m[1][1] = f;
+            m.m[2][2] = (farZ + nearZ) / (nearZ - farZ);
+            m.m[2][3] = (2.0f * farZ * nearZ) / (nearZ - farZ);
+            m.m[3][2] = -1.0f;
+            return m;
+        }
+
         static Mat4 mul(const Mat4& A, const Mat4& B)
         {
             Mat4 R{};
+#if defined(ALMOND_RASTER_SSE2)
+            // Row r of the product is a blend of B's rows weighted by A's row r.
+            const __m128 b0 = _mm_loadu_ps(B.m[0]);
+            const __m128 b1 = _mm_loadu_ps(B.m[1]);
+            const __m128 b2 = _mm_loadu_ps(B.m[2]);
+            const __m128 b3 = _mm_loadu_ps(B.m[3]);
+            for (int r = 0; r < 4; ++r)
+            {
+                __m128 row = _mm_mul_ps(_mm_set1_ps(A.m[r][0]), b0);
+                row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(A.m[r][1]), b1));
+                row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(A.m[r][2]), b2));
+                row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(A.m[r][3]), b3));
+                _mm_storeu_ps(R.m[r], row);
+            }
+#else
             for (int r = 0; r < 4; ++r)
                 for (int c = 0; c < 4; ++c)
                     for (int k = 0; k < 4; ++k)
                         R.m[r][c] += A.m[r][k] * B.m[k][c];
+#endif
             return R;
         }
 
         static Vec3 multiply(const Mat4& m, const Vec3& v)
         {
-            return {
-                m.m[0][0] * v.x + m.m[0][1] * v.y + m.m[0][2] * v.z + m.m[0][3],
-                m.m[1][0] * v.x + m.m[1][1] * v.y + m.m[1][2] * v.z + m.m[1][3],
-                m.m[2][0] * v.x + m.m[2][1] * v.y + m.m[2][2] * v.z + m.m[2][3]
+            Vec4 out{};
+            transform_points(m, &v.x, sizeof(Vec3), 1, &out);
+            return { out.x, out.y, out.z };
+        }
+
+        // out[i] = m * (p_i, 1) for `count` points read from `xyz` every
+        // `stride` bytes (so vertex structs can be read in place). Four points
+        // per step: positions are transposed to SoA, the matrix is broadcast.
+        static void transform_points(const Mat4& m, const float* xyz, std::size_t stride, std::size_t count, Vec4* out)
+        {
+            auto point = [&](std::size_t i) {
+                return reinterpret_cast<const float*>(reinterpret_cast<const unsigned char*>(xyz) + i * stride);
             };
+
+            std::size_t i = 0;
+#if defined(ALMOND_RASTER_SSE2)
+            __m128 rows[4][4];
+            for (int r = 0; r < 4; ++r)
+                for (int c = 0; c < 4; ++c)
+                    rows[r][c] = _mm_set1_ps(m.m[r][c]);
+
+            for (; i + 4 <= count; i += 4)
+            {
+                const float* p0 = point(i);
+                const float* p1 = point(i + 1);
+                const float* p2 = point(i + 2);
+                const float* p3 = point(i + 3);
+                const __m128 x = _mm_setr_ps(p0[0], p1[0], p2[0], p3[0]);
+                const __m128 y = _mm_setr_ps(p0[1], p1[1], p2[1], p3[1]);
+                const __m128 z = _mm_setr_ps(p0[2], p1[2], p2[2], p3[2]);
+
+                __m128 o[4];
+                for (int r = 0; r < 4; ++r)
+                {
+                    o[r] = _mm_add_ps(
+                        _mm_add_ps(_mm_mul_ps(rows[r][0], x), _mm_mul_ps(rows[r][1], y)),
+                        _mm_add_ps(_mm_mul_ps(rows[r][2], z), rows[r][3]));
+                }
+
+                _MM_TRANSPOSE4_PS(o[0], o[1], o[2], o[3]);
+                _mm_storeu_ps(&out[i].x, o[0]);
+                _mm_storeu_ps(&out[i + 1].x, o[1]);
+                _mm_storeu_ps(&out[i + 2].x, o[2]);
+                _mm_storeu_ps(&out[i + 3].x, o[3]);
+            }
+#endif
+            for (; i < count; ++i)
+            {
+                const float* p = point(i);
+                out[i] = {
+                    m.m[0][0] * p[0] + m.m[0][1] * p[1] + m.m[0][2] * p[2] + m.m[0][3],
+                    m.m[1][0] * p[0] + m.m[1][1] * p[1] + m.m[1][2] * p[2] + m.m[1][3],
+                    m.m[2][0] * p[0] + m.m[2][1] * p[1] + m.m[2][2] * p[2] + m.m[2][3],
+                    m.m[3][0] * p[0] + m.m[3][1] * p[1] + m.m[3][2] * p[2] + m.m[3][3]
+                };
+            }
         }
 
         static Mat4 transpose(const Mat4& a)
@@ -188,7 +317,43 @@ export namespace almondnamespace::anativecontext
         // =======================
         // Rasterization
         // =======================
-        static void rasterize_triangle(Framebuffer& fb, const Triangle& tri, std::vector<float>& zbuf)
+        // Per-triangle work done once, whatever part of the frame is drawn.
+        // Edges are exact integer functions over 1/16-pixel snapped vertices,
+        // evaluated at pixel centres: E(x, y) = e0 + x * stepX + y * stepY.
+        // A pixel is covered when all three are >= 0; the top-left bias is
+        // already folded into e0.
+        struct TriangleSetup
+        {
+            std::int64_t e0[3]{};
+            std::int64_t stepX[3]{};
+            std::int64_t stepY[3]{};
+            float invArea = 0.0f;           // 1 / (E0 + E1 + E2) before bias
+            float iz0 = 0.0f, iz1 = 0.0f, iz2 = 0.0f;
+            float u0o = 0.0f, v0o = 0.0f;
+            float u1o = 0.0f, v1o = 0.0f;
+            float u2o = 0.0f, v2o = 0.0f;
+            int minX = 0, minY = 0, maxX = -1, maxY = -1; // inclusive, inside the frame
+            TexturePtr tex{};
+            std::uint32_t color = 0xFFFFFFFFu;
+            bool bilinear = false;
+        };
+
+        // Window of the frame being written: colour and depth share the layout.
+        struct RasterTarget
+        {
+            std::uint32_t* color = nullptr;
+            float* depth = nullptr;
+            int originX = 0, originY = 0;
+            int width = 0, height = 0;
+            int stride = 0;
+        };
+
+        static constexpr int kSubpixelBits = 4;
+        static constexpr int kBlockSize = 8;
+
+        // Projects and culls `tri` for a `width` x `height` frame. False when
+        // nothing of it can reach the screen.
+        static bool setup_triangle(const Triangle& tri, int width, int height, TriangleSetup& out)
         {
             auto project = [&](const Vec3& v) -> Vec3
                 {
@@ -196,7 +361,7 @@ export namespace almondnamespace::anativecontext
                     float z = v.z + 3.0f;
                     if (z < 0.001f) z = 0.001f;
                     const float f = scale / z;
-                    return { v.x * f + fb.width * 0.5f, -v.y * f + fb.height * 0.5f, z };
+                    return { v.x * f + width * 0.5f, -v.y * f + height * 0.5f, z };
                 };
 
             const Vec3 v0 = tri.v0.pos;
@@ -213,74 +378,194 @@ export namespace almondnamespace::anativecontext
             };
             const Vec3 viewDir{ -v0.x, -v0.y, -v0.z }; // camera at origin
             const float dot = normal.x * viewDir.x + normal.y * viewDir.y + normal.z * viewDir.z;
-            if (dot >= 0.0f) return;
+            if (dot >= 0.0f) return false;
 
             const Vec3 p0 = project(v0);
             const Vec3 p1 = project(v1);
             const Vec3 p2 = project(v2);
+            const ScreenVertex screen[3] = {
+                { p0.x, p0.y, 1.0f / v0.z, tri.v0.uv },
+                { p1.x, p1.y, 1.0f / v1.z, tri.v1.uv },
+                { p2.x, p2.y, 1.0f / v2.z, tri.v2.uv },
+            };
+            return setup_projected(screen, width, height, CullMode::None, tri.tex, tri.color, tri.filter, out);
+        }
 
-            const int minX = (std::max)(0, int(std::floor((std::min)({ p0.x, p1.x, p2.x }))));
-            const int maxX = (std::min)(fb.width - 1, int(std::ceil((std::max)({ p0.x, p1.x, p2.x }))));
-            const int minY = (std::max)(0, int(std::floor((std::min)({ p0.y, p1.y, p2.y }))));
-            const int maxY = (std::min)(fb.height - 1, int(std::ceil((std::max)({ p0.y, p1.y, p2.y }))));
+        // Builds the setup for an already projected triangle; depth is the
+        // interpolated w. False when culled, degenerate or off screen.
+        static bool setup_projected(const ScreenVertex (&p)[3], int width, int height, CullMode cull,
+            const TexturePtr& tex, std::uint32_t color, blit::SampleFilter filter, TriangleSetup& out)
+        {
+            // Snap to the subpixel grid. The clamp keeps edge products well inside
+            // 64 bits for vertices projected from right at the near plane.
+            constexpr float guard = float(1 << 22);
+            constexpr float snap = float(1 << kSubpixelBits);
+            std::int64_t sx[3]{}, sy[3]{};
+            for (int i = 0; i < 3; ++i)
+            {
+                const float x = std::clamp(p[i].x, -guard, guard) * snap;
+                const float y = std::clamp(p[i].y, -guard, guard) * snap;
+                sx[i] = std::int64_t(x + (x < 0.0f ? -0.5f : 0.5f));
+                sy[i] = std::int64_t(y + (y < 0.0f ? -0.5f : 0.5f));
+            }
 
-            auto edge = [](const Vec3& a, const Vec3& b, float x, float y)
-                {
-                    return (b.x - a.x) * (y - a.y) - (b.y - a.y) * (x - a.x);
-                };
+            // Pixels whose centre (x + 0.5) can fall inside the snapped bounds.
+            constexpr std::int64_t half = std::int64_t(1) << (kSubpixelBits - 1);
+            auto first_centre = [](std::int64_t v) { return int(-((half - v) >> kSubpixelBits)); };
+            auto last_centre = [](std::int64_t v) { return int((v - half) >> kSubpixelBits); };
+            out.minX = (std::max)(0, first_centre((std::min)({ sx[0], sx[1], sx[2] })));
+            out.maxX = (std::min)(width - 1, last_centre((std::max)({ sx[0], sx[1], sx[2] })));
+            out.minY = (std::max)(0, first_centre((std::min)({ sy[0], sy[1], sy[2] })));
+            out.maxY = (std::min)(height - 1, last_centre((std::max)({ sy[0], sy[1], sy[2] })));
+            if (out.minX > out.maxX || out.minY > out.maxY) return false;
+
+            // Edge i is opposite vertex i, so E_i / area is that vertex's weight.
+            const std::int64_t area = (sx[1] - sx[0]) * (sy[2] - sy[0]) - (sy[1] - sy[0]) * (sx[2] - sx[0]);
+            if (area == 0) return false;
+            // Screen y points down, so counter-clockwise in clip space is negative here.
+            if ((cull == CullMode::Back && area > 0) || (cull == CullMode::Front && area < 0)) return false;
+            const std::int64_t sign = area > 0 ? 1 : -1;
+
+            constexpr std::int64_t one = std::int64_t(1) << kSubpixelBits;
+            for (int i = 0; i < 3; ++i)
+            {
+                const int a = (i + 1) % 3;
+                const int b = (i + 2) % 3;
+                const std::int64_t A = (sy[a] - sy[b]) * sign;
+                const std::int64_t B = (sx[b] - sx[a]) * sign;
+
+                // Samples exactly on an edge belong to the triangle only when the
+                // edge is a top or left one, so shared edges are drawn once.
+                const bool topLeft = A > 0 || (A == 0 && B > 0);
+                out.e0[i] = A * (half - sx[a]) + B * (half - sy[a]) - (topLeft ? 0 : 1);
+                out.stepX[i] = A * one;
+                out.stepY[i] = B * one;
+            }
+            out.invArea = 1.0f / float(area * sign);
 
-            const float area = edge(p0, p1, p2.x, p2.y);
-            if (std::fabs(area) < 1e-6f) return;
+            out.iz0 = p[0].invW;
+            out.iz1 = p[1].invW;
+            out.iz2 = p[2].invW;
 
-            const float iz0 = 1.0f / v0.z;
-            const float iz1 = 1.0f / v1.z;
-            const float iz2 = 1.0f / v2.z;
+            out.u0o = p[0].uv.u * out.iz0; out.v0o = p[0].uv.v * out.iz0;
+            out.u1o = p[1].uv.u * out.iz1; out.v1o = p[1].uv.v * out.iz1;
+            out.u2o = p[2].uv.u * out.iz2; out.v2o = p[2].uv.v * out.iz2;
 
-            const float u0o = tri.v0.uv.u * iz0, v0o = tri.v0.uv.v * iz0;
-            const float u1o = tri.v1.uv.u * iz1, v1o = tri.v1.uv.v * iz1;
-            const float u2o = tri.v2.uv.u * iz2, v2o = tri.v2.uv.v * iz2;
+            out.tex = tex;
+            out.color = color;
+            out.bilinear = filter != blit::SampleFilter::Nearest;
+            return true;
+        }
 
-            for (int y = minY; y <= maxY; ++y)
-            {
-                for (int x = minX; x <= maxX; ++x)
-                {
-                    const float px = float(x) + 0.5f;
-                    const float py = float(y) + 0.5f;
+        // Fills the part of `tri` inside `target`. Edge values are exact, so
+        // tiled and whole-frame draws produce the same pixels. The window is
+        // walked in 8x8 blocks: blocks outside an edge are skipped, blocks
+        // inside all three skip the coverage test, and the rest get an 8-wide
+        // coverage mask per row.
+        static void rasterize_setup(const TriangleSetup& tri, const RasterTarget& target)
+        {
+            const int minX = (std::max)(tri.minX, target.originX);
+            const int maxX = (std::min)(tri.maxX, target.originX + target.width - 1);
+            const int minY = (std::max)(tri.minY, target.originY);
+            const int maxY = (std::min)(tri.maxY, target.originY + target.height - 1);
+            if (minX > maxX || minY > maxY) return;
+
+            auto edge_at = [&](int i, int x, int y) {
+                return tri.e0[i] + std::int64_t(x) * tri.stepX[i] + std::int64_t(y) * tri.stepY[i];
+            };
 
-                    const float w0 = edge(p1, p2, px, py) / area;
-                    const float w1 = edge(p2, p0, px, py) / area;
-                    const float w2 = 1.0f - w0 - w1;
+            // Offsets from a block's top-left pixel to its lowest and highest
+            // edge values; blockStep moves one block to the right.
+            std::int64_t lowest[3]{}, highest[3]{}, blockStep[3]{};
+            for (int i = 0; i < 3; ++i)
+            {
+                const std::int64_t reachX = tri.stepX[i] * (kBlockSize - 1);
+                const std::int64_t reachY = tri.stepY[i] * (kBlockSize - 1);
+                lowest[i] = (std::min)(reachX, std::int64_t(0)) + (std::min)(reachY, std::int64_t(0));
+                highest[i] = (std::max)(reachX, std::int64_t(0)) + (std::max)(reachY, std::int64_t(0));
+                blockStep[i] = tri.stepX[i] * kBlockSize;
+            }
 
-                    if (w0 < 0.0f || w1 < 0.0f || w2 < 0.0f) continue;
+            auto shade = [&](int x, int y, std::int64_t e0, std::int64_t e1, std::int64_t e2)
+                {
+                    const float w0 = float(e0) * tri.invArea;
+                    const float w1 = float(e1) * tri.invArea;
+                    const float w2 = float(e2) * tri.invArea;
 
-                    const float invZ = w0 * iz0 + w1 * iz1 + w2 * iz2;
-                    if (invZ <= 0.0f) continue;
+                    const float invZ = w0 * tri.iz0 + w1 * tri.iz1 + w2 * tri.iz2;
+                    if (invZ <= 0.0f) return;
 
                     const float depth = 1.0f / invZ;
-                    const int idx = y * fb.width + x;
-                    if (depth >= zbuf[std::size_t(idx)]) continue;
+                    const std::size_t idx = std::size_t(y - target.originY) * std::size_t(target.stride)
+                        + std::size_t(x - target.originX);
+                    if (depth >= target.depth[idx]) return;
 
-                    zbuf[std::size_t(idx)] = depth;
-
-                    const float u = (w0 * u0o + w1 * u1o + w2 * u2o) / invZ;
-                    const float v = (w0 * v0o + w1 * v1o + w2 * v2o) / invZ;
+                    target.depth[idx] = depth;
 
                     if (tri.tex)
                     {
-                        fb.put_pixel(
-                            x, y,
-                            tri.tex->sample(int(u * float(tri.tex->width)), int(v * float(tri.tex->height)))
-                        );
+                        const float u = (w0 * tri.u0o + w1 * tri.u1o + w2 * tri.u2o) * depth;
+                        const float v = (w0 * tri.v0o + w1 * tri.v1o + w2 * tri.v2o) * depth;
+                        target.color[idx] = tri.bilinear
+                            ? tri.tex->sample_bilinear(u * float(tri.tex->width), v * float(tri.tex->height))
+                            : tri.tex->sample(int(u * float(tri.tex->width)), int(v * float(tri.tex->height)));
                     }
                     else
                     {
-                        fb.put_pixel(x, y, tri.color);
+                        target.color[idx] = tri.color;
+                    }
+                };
+
+            // Blocks sit on the absolute 8-pixel grid, clipped to the window.
+            const int firstBx = minX & ~(kBlockSize - 1);
+            for (int by = minY & ~(kBlockSize - 1); by <= maxY; by += kBlockSize)
+            {
+                const int y0 = (std::max)(by, minY);
+                const int y1 = (std::min)(by + kBlockSize - 1, maxY);
+
+                std::int64_t corner[3] = { edge_at(0, firstBx, by), edge_at(1, firstBx, by), edge_at(2, firstBx, by) };
+                for (int bx = firstBx; bx <= maxX; bx += kBlockSize,
+                    corner[0] += blockStep[0], corner[1] += blockStep[1], corner[2] += blockStep[2])
+                {
+                    if (corner[0] + highest[0] < 0 || corner[1] + highest[1] < 0 || corner[2] + highest[2] < 0)
+                        continue;
+                    const bool inside = corner[0] + lowest[0] >= 0 && corner[1] + lowest[1] >= 0 && corner[2] + lowest[2] >= 0;
+
+                    const int x0 = (std::max)(bx, minX);
+                    const int x1 = (std::min)(bx + kBlockSize - 1, maxX);
+                    const std::uint32_t columns = (0xFFu << (x0 - bx)) & (0xFFu >> (bx + kBlockSize - 1 - x1));
+
+                    std::int64_t e[3]{};
+                    for (int i = 0; i < 3; ++i)
+                        e[i] = corner[i] + std::int64_t(y0 - by) * tri.stepY[i];
+                    for (int y = y0; y <= y1; ++y, e[0] += tri.stepY[0], e[1] += tri.stepY[1], e[2] += tri.stepY[2])
+                    {
+                        std::uint32_t mask = columns & (inside ? 0xFFu : coverage8(e, tri.stepX));
+
+                        while (mask)
+                        {
+                            const int lane = std::countr_zero(mask);
+                            mask &= mask - 1;
+                            shade(bx + lane, y,
+                                e[0] + lane * tri.stepX[0],
+                                e[1] + lane * tri.stepX[1],
+                                e[2] + lane * tri.stepX[2]);
+                        }
                     }
                 }
             }
         }
 
-        static void render_cube(Framebuffer& fb, TexturePtr tex, float angle, const Camera& cam = Camera())
+        static void rasterize_triangle(Framebuffer& fb, const Triangle& tri, std::vector<float>& zbuf)
+        {
+            TriangleSetup setup{};
+            if (!setup_triangle(tri, fb.width, fb.height, setup)) return;
+
+            rasterize_setup(setup, { fb.pixels.data(), zbuf.data(), 0, 0, fb.width, fb.height, fb.width });
+        }
+
+        // The 12 view-space triangles of the spinning cube.
+        static std::array<Triangle, 12> cube_triangles(TexturePtr tex, float angle, const Camera& cam = Camera())
         {
             const Mat4 rx = rotationX(angle * 0.5f);
             const Mat4 ry = rotationY(angle);
@@ -299,12 +584,10 @@ export namespace almondnamespace::anativecontext
                 verts[i].uv = cubeVerts[i].uv;
             }
 
-            std::vector<float> zbuf(std::size_t(fb.width) * std::size_t(fb.height),
-                (std::numeric_limits<float>::infinity)());
-
+            std::array<Triangle, 12> tris{};
             for (int t = 0; t < 12; ++t)
             {
-                Triangle tri{};
+                Triangle& tri = tris[std::size_t(t)];
                 tri.v0.pos = verts[cubeTris[t][0]].viewPos;
                 tri.v1.pos = verts[cubeTris[t][1]].viewPos;
                 tri.v2.pos = verts[cubeTris[t][2]].viewPos;
@@ -315,9 +598,67 @@ export namespace almondnamespace::anativecontext
 
                 tri.tex = tex;
                 tri.color = faceColors[t / 2];
+            }
+            return tris;
+        }
+
+        static void render_cube(Framebuffer& fb, TexturePtr tex, float angle, const Camera& cam = Camera())
+        {
+            fb.clear_depth();
+
+            const RasterTarget target{ fb.pixels.data(), fb.depth.data(), 0, 0, fb.width, fb.height, fb.width };
+            for (const Triangle& tri : cube_triangles(std::move(tex), angle, cam))
+            {
+                TriangleSetup setup{};
+                if (setup_triangle(tri, fb.width, fb.height, setup))
+                    rasterize_setup(setup, target);
+            }
+        }
 
-                rasterize_triangle(fb, tri, zbuf);
+    private:
+        // Bit i set when all three edges are >= 0 at lane i of an 8-pixel row.
+        static std::uint32_t coverage8(const std::int64_t (&e)[3], const std::int64_t (&stepX)[3]) noexcept
+        {
+#if defined(ALMOND_RASTER_AVX2)
+            // Sign bits of (e0 | e1 | e2), four lanes per register.
+            __m256i orLo = _mm256_setzero_si256();
+            __m256i orHi = _mm256_setzero_si256();
+            for (int i = 0; i < 3; ++i)
+            {
+                const std::int64_t s = stepX[i];
+                const __m256i lo = _mm256_add_epi64(_mm256_set1_epi64x(e[i]), _mm256_setr_epi64x(0, s, 2 * s, 3 * s));
+                orLo = _mm256_or_si256(orLo, lo);
+                orHi = _mm256_or_si256(orHi, _mm256_add_epi64(lo, _mm256_set1_epi64x(4 * s)));
+            }
+            const int negative = _mm256_movemask_pd(_mm256_castsi256_pd(orLo))
+                | (_mm256_movemask_pd(_mm256_castsi256_pd(orHi)) << 4);
+            return ~static_cast<std::uint32_t>(negative) & 0xFFu;
+#elif defined(ALMOND_RASTER_SSE2)
+            // Sign bits of (e0 | e1 | e2), two lanes per register.
+            __m128i acc[4] = {};
+            for (int i = 0; i < 3; ++i)
+            {
+                const __m128i step2 = _mm_set1_epi64x(stepX[i] * 2);
+                __m128i lanes = _mm_set_epi64x(e[i] + stepX[i], e[i]);
+                for (int q = 0; q < 4; ++q)
+                {
+                    acc[q] = _mm_or_si128(acc[q], lanes);
+                    lanes = _mm_add_epi64(lanes, step2);
+                }
+            }
+            int negative = 0;
+            for (int q = 0; q < 4; ++q)
+                negative |= _mm_movemask_pd(_mm_castsi128_pd(acc[q])) << (2 * q);
+            return ~static_cast<std::uint32_t>(negative) & 0xFFu;
+#else
+            std::uint32_t mask = 0;
+            for (int lane = 0; lane < kBlockSize; ++lane)
+            {
+                const std::int64_t any = (e[0] + lane * stepX[0]) | (e[1] + lane * stepX[1]) | (e[2] + lane * stepX[2]);
+                mask |= std::uint32_t(any >= 0) << lane;
             }
+            return mask;
+#endif
         }
     };
 } // namespace almondnamespace::anativecontext
@@ -68,7 +68,11 @@ export namespace almondnamespace::anativecontext
         int width{ 400 };
         int height{ 300 };
         bool running{ false };
+        bool headless{ false };      // no window: frames are rendered but never presented
         std::vector<std::uint32_t> framebuffer{};
+        std::vector<float> depthbuffer{};  // same size as framebuffer, +inf = empty
+        bool depthDirty{ false };          // something was depth-tested since the last clear
+        bool tiledRendering{ true }; // bin draws into tiles and resolve them on worker threads
 
         struct MouseState
         {
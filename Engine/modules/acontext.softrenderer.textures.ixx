@@ -10,12 +10,14 @@ module;
 export module acontext.softrenderer.textures;
 
 import <algorithm>;
+import <cmath>;
 import <cstdint>;
 import <memory>;
 import <unordered_map>;
 import <vector>;
 
 import aatlas.texture;        // TextureAtlas
+import acontext.softrenderer.blit;    // blit::lerp_texel
 import acontext.softrenderer.state;   // SoftRendState
 import aengine.platform;    // almondnamespace
 import aengine.input;       // almondnamespace::input
@@ -44,6 +46,19 @@ export namespace almondnamespace::anativecontext
             y = std::clamp(y, 0, height - 1);
             return pixels[static_cast<size_t>(y) * width + x];
         }
+
+        // Bilinear between the four texels around (x, y), in texel units with
+        // texel centres at +0.5; edges clamp like sample().
+        uint32_t sample_bilinear(float x, float y) const
+        {
+            const int fx = static_cast<int>(std::floor((x - 0.5f) * 256.0f));
+            const int fy = static_cast<int>(std::floor((y - 0.5f) * 256.0f));
+            const int x0 = fx >> 8;
+            const int y0 = fy >> 8;
+            const uint32_t top = blit::lerp_texel(sample(x0, y0), sample(x0 + 1, y0), static_cast<uint32_t>(fx & 0xFF));
+            const uint32_t bottom = blit::lerp_texel(sample(x0, y0 + 1), sample(x0 + 1, y0 + 1), static_cast<uint32_t>(fx & 0xFF));
+            return blit::lerp_texel(top, bottom, static_cast<uint32_t>(fy & 0xFF));
+        }
     };
 
     using TexturePtr = std::shared_ptr<Texture>;
@@ -0,0 +1,511 @@
+/**************************************************************
+ *   AlmondShell - Modular C++ Framework
+ **************************************************************/
+ // acontext.softrenderer.tiles.ixx
+ //
+ // Binned tile renderer for the software backend. Draws recorded
+ // during a frame are sorted into 64x64 screen tiles; resolve()
+ // then rasterizes the touched tiles on the task graph, each into
+ // a small colour/depth scratch tile that stays in cache, and
+ // writes the result back. Commands keep their submission order
+ // inside a tile and use the same per-pixel code as the immediate
+ // path, so the output is identical to drawing serially.
+ //
+ // Frames begun with a clear colour are retained: every tile keeps
+ // a signature of the commands that drew it, and resolve() only
+ // clears and redraws tiles whose signature changed since the last
+ // frame. dirty_rects() reports what was rewritten, so presenting
+ // can skip the rest and an unchanged frame costs only the binning.
+
+module;
+
+#include <include/aengine.config.hpp> // for ALMOND_USING Macros
+
+export module acontext.softrenderer.tiles;
+
+#if defined(ALMOND_USING_SOFTWARE_RENDERER)
+
+import <algorithm>;
+import <array>;
+import <atomic>;
+import <bit>;
+import <cstdint>;
+import <limits>;
+import <memory>;
+import <span>;
+import <thread>;
+import <vector>;
+
+import aengine.systems;                 // Task
+import aengine.taskgraph.dotsystem;     // taskgraph::TaskGraph, Node
+import acontext.softrenderer.blit;      // blit::blit_sprite
+import acontext.softrenderer.renderer;  // SoftwareRenderer, Triangle
+
+export namespace almondnamespace::anativecontext
+{
+    // Pixel rectangle, inside the frame.
+    struct DirtyRect
+    {
+        int x{ 0 };
+        int y{ 0 };
+        int width{ 0 };
+        int height{ 0 };
+    };
+
+    class TileRenderer
+    {
+    public:
+        static constexpr int kTileSize = 64;
+
+        TileRenderer() = default;
+        TileRenderer(const TileRenderer&) = delete;
+        TileRenderer& operator=(const TileRenderer&) = delete;
+
+        // Starts recording a `width` x `height` frame drawn over the current
+        // framebuffer contents. Anything recorded but not resolved is dropped.
+        void begin_frame(int width, int height)
+        {
+            start(width, height);
+            retained_ = false;
+        }
+
+        // Starts recording a retained frame: tiles start from `clearColor` and
+        // +inf depth, and only tiles whose commands differ from the previous
+        // retained frame are redrawn. A new size or colour redraws everything.
+        void begin_frame(int width, int height, std::uint32_t clearColor)
+        {
+            start(width, height);
+            if (!retained_ || clearColor != clearColor_)
+                invalidate();
+            retained_ = true;
+            clearColor_ = clearColor;
+        }
+
+        // Forgets the previous frame so the next retained resolve redraws every
+        // tile. Needed after anything else writes to the framebuffer, or when a
+        // texture a triangle samples is modified in place.
+        void invalidate() noexcept { historyValid_ = false; }
+
+        [[nodiscard]] bool recording() const noexcept { return recording_; }
+        [[nodiscard]] std::size_t tiles_touched() const noexcept { return active_.size(); }
+        [[nodiscard]] std::size_t tile_count() const noexcept { return bins_.size(); }
+
+        // Tiles rewritten by the last resolve(), merged into rectangles. Empty
+        // when a retained frame was unchanged.
+        [[nodiscard]] std::span<const DirtyRect> dirty_rects() const noexcept { return dirtyRects_; }
+        [[nodiscard]] std::size_t tiles_redrawn() const noexcept { return work_.size(); }
+
+        void submit_sprite(const blit::BlitSource& source, const blit::BlitRect& src, const blit::BlitRect& dest,
+            const blit::SpriteSampling& sampling = {})
+        {
+            if (!recording_ || dest.width <= 0 || dest.height <= 0)
+                return;
+
+            const auto index = static_cast<std::uint32_t>(sprites_.size());
+            sprites_.push_back({ source, src, dest, sampling });
+            bin(dest.x, dest.y, dest.x + dest.width - 1, dest.y + dest.height - 1, { Kind::Sprite, index },
+                sprite_signature(sprites_.back()));
+        }
+
+        // Depth-tested against everything since the last depth clear, like
+        // SoftwareRenderer::rasterize_triangle with one z-buffer per frame.
+        void submit_triangle(const Triangle& tri)
+        {
+            if (!recording_)
+                return;
+
+            SoftwareRenderer::TriangleSetup setup{};
+            if (SoftwareRenderer::setup_triangle(tri, width_, height_, setup))
+                submit_setup(setup);
+        }
+
+        // A triangle already set up for this frame's size (e.g. by MeshPipeline).
+        void submit_setup(const SoftwareRenderer::TriangleSetup& setup)
+        {
+            if (!recording_)
+                return;
+
+            const auto index = static_cast<std::uint32_t>(triangles_.size());
+            triangles_.push_back(setup);
+            bin(setup.minX, setup.minY, setup.maxX, setup.maxY, { Kind::Triangle, index },
+                triangle_signature(setup));
+        }
+
+        // Resets depth for later triangles. Tiles first touched afterwards
+        // replay the clear before their own commands.
+        void submit_depth_clear()
+        {
+            if (!recording_)
+                return;
+
+            depthClear_ = static_cast<std::uint32_t>(commands_.size());
+            commands_.push_back({ Kind::DepthClear, 0 });
+            commandSignatures_.push_back(kDepthClearSignature);
+            for (auto tile : active_)
+                bins_[tile].push_back(depthClear_);
+        }
+
+        // Rasterizes the recorded frame into `framebuffer` (width * height,
+        // 0xAARRGGBB) and stops recording. Tiles nobody drew to are not touched
+        // (in retained frames: tiles that did not change).
+        // With a `depth` buffer of the same size, tiles write back their depth;
+        // non-retained frames also start from its values instead of cleared.
+        void resolve(std::span<std::uint32_t> framebuffer, std::span<float> depth = {}, bool parallel = true)
+        {
+            if (!recording_)
+                return;
+            recording_ = false;
+            work_.clear();
+            dirtyRects_.clear();
+
+            const std::size_t pixels = static_cast<std::size_t>(width_) * static_cast<std::size_t>(height_);
+            if (framebuffer.size() < pixels) {
+                invalidate();
+                return;
+            }
+
+            if (retained_)
+                collect_changed_tiles();
+            else
+                work_.assign(active_.begin(), active_.end());
+            if (work_.empty())
+                return;
+            if (retained_)
+                build_dirty_rects();
+            else
+                dirtyRects_.push_back({ 0, 0, width_, height_ });
+
+            depth_ = depth.size() >= pixels ? depth.data() : nullptr;
+
+            const std::size_t hw = (std::max)(1u, std::thread::hardware_concurrency());
+            const std::size_t helpers = parallel ? (std::min)(hw - 1, work_.size() - 1) : 0;
+
+            while (scratch_.size() < helpers + 1)
+                scratch_.push_back(std::make_unique<TileScratch>());
+
+            next_.store(0, std::memory_order_relaxed);
+            if (helpers == 0) {
+                drain(framebuffer.data(), *scratch_[0]);
+                return;
+            }
+
+            if (!graph_)
+                graph_ = std::make_unique<taskgraph::TaskGraph>(hw - 1);
+
+            for (std::size_t i = 0; i < helpers; ++i) {
+                auto node = std::make_unique<taskgraph::Node>(tile_worker(this, framebuffer.data(), scratch_[i + 1].get()));
+                node->Label = "softrenderer:tiles";
+                graph_->AddNode(std::move(node));
+            }
+            graph_->Execute();
+
+            drain(framebuffer.data(), *scratch_[0]);
+
+            graph_->WaitAll();
+            graph_->PruneFinished();
+        }
+
+        // Joins the worker threads and frees the scratch tiles.
+        void shutdown()
+        {
+            graph_.reset();
+            scratch_.clear();
+            bins_.clear();
+            active_.clear();
+            work_.clear();
+            commands_.clear();
+            commandSignatures_.clear();
+            sprites_.clear();
+            triangles_.clear();
+            signatures_.clear();
+            dirtyRects_.clear();
+            recording_ = false;
+            retained_ = false;
+            historyValid_ = false;
+        }
+
+    private:
+        static constexpr std::uint32_t kNoCommand = ~0u;
+        static constexpr std::uint64_t kEmptyTileSignature = 0x6A09E667F3BCC909ull;
+        static constexpr std::uint64_t kDepthClearSignature = 0xBB67AE8584CAA73Bull;
+
+        enum class Kind : std::uint8_t { Sprite, Triangle, DepthClear };
+
+        struct Command
+        {
+            Kind kind{ Kind::Sprite };
+            std::uint32_t index{ 0 }; // into sprites_ / triangles_
+        };
+
+        struct SpriteDraw
+        {
+            blit::BlitSource source{};
+            blit::BlitRect src{};
+            blit::BlitRect dest{};
+            blit::SpriteSampling sampling{};
+        };
+
+        struct TileScratch
+        {
+            alignas(64) std::array<std::uint32_t, kTileSize * kTileSize> color{};
+            alignas(64) std::array<float, kTileSize * kTileSize> depth{};
+        };
+
+        void start(int width, int height)
+        {
+            width_ = (std::max)(0, width);
+            height_ = (std::max)(0, height);
+            if (width_ != frameWidth_ || height_ != frameHeight_)
+                invalidate();
+            frameWidth_ = width_;
+            frameHeight_ = height_;
+            tilesX_ = (width_ + kTileSize - 1) / kTileSize;
+            tilesY_ = (height_ + kTileSize - 1) / kTileSize;
+
+            for (auto tile : active_)
+                bins_[tile].clear();
+            active_.clear();
+            bins_.resize(static_cast<std::size_t>(tilesX_) * static_cast<std::size_t>(tilesY_));
+
+            commands_.clear();
+            commandSignatures_.clear();
+            sprites_.clear();
+            triangles_.clear();
+            depthClear_ = kNoCommand;
+            recording_ = true;
+        }
+
+        // ---- Signatures ------------------------------------------------------
+        // Two frames give a tile the same signature when it received the same
+        // commands with the same inputs, in the same order.
+
+        [[nodiscard]] static std::uint64_t mix(std::uint64_t hash, std::uint64_t value) noexcept
+        {
+            hash = (hash ^ value) * 0x9E3779B97F4A7C15ull;
+            return hash ^ (hash >> 29);
+        }
+
+        [[nodiscard]] static std::uint64_t mix_rect(std::uint64_t hash, const blit::BlitRect& r) noexcept
+        {
+            hash = mix(hash, (std::uint64_t(std::uint32_t(r.x)) << 32) | std::uint32_t(r.y));
+            return mix(hash, (std::uint64_t(std::uint32_t(r.width)) << 32) | std::uint32_t(r.height));
+        }
+
+        [[nodiscard]] static std::uint64_t mix_source(std::uint64_t hash, const blit::BlitSource& s) noexcept
+        {
+            hash = mix(hash, reinterpret_cast<std::uintptr_t>(s.pixels));
+            hash = mix(hash, (std::uint64_t(s.width) << 32) | s.height);
+            return mix(hash, s.version);
+        }
+
+        [[nodiscard]] static std::uint64_t sprite_signature(const SpriteDraw& s) noexcept
+        {
+            std::uint64_t hash = mix_source(1, s.source);
+            hash = mix_rect(mix_rect(hash, s.src), s.dest);
+            hash = mix(hash, (std::uint64_t(s.sampling.filter) << 32) | s.sampling.lodFrac);
+            if (s.sampling.lodFrac > 0)
+                hash = mix_rect(mix_source(hash, s.sampling.coarse), s.sampling.coarseSrc);
+            if (s.sampling.sdfGain != 0)
+                hash = mix(hash, (std::uint64_t(s.sampling.sdfLo) << 32) | s.sampling.sdfGain);
+            return hash;
+        }
+
+        // Textures are identified by address; see invalidate().
+        [[nodiscard]] static std::uint64_t triangle_signature(const SoftwareRenderer::TriangleSetup& t) noexcept
+        {
+            std::uint64_t hash = 2;
+            for (int i = 0; i < 3; ++i) {
+                hash = mix(hash, static_cast<std::uint64_t>(t.e0[i]));
+                hash = mix(hash, static_cast<std::uint64_t>(t.stepX[i]));
+                hash = mix(hash, static_cast<std::uint64_t>(t.stepY[i]));
+            }
+            const float attributes[] = { t.invArea, t.iz0, t.iz1, t.iz2, t.u0o, t.v0o, t.u1o, t.v1o, t.u2o, t.v2o };
+            for (const float a : attributes)
+                hash = mix(hash, std::bit_cast<std::uint32_t>(a));
+            hash = mix(hash, reinterpret_cast<std::uintptr_t>(t.tex.get()));
+            return mix(hash, (std::uint64_t(t.color) << 1) | (t.bilinear ? 1u : 0u));
+        }
+
+        // Compares every tile's signature with the previous frame's; the ones
+        // that differ become this frame's work, in ascending order.
+        void collect_changed_tiles()
+        {
+            const bool history = historyValid_ && signatures_.size() == bins_.size();
+            signatures_.resize(bins_.size());
+
+            for (std::uint32_t tile = 0; tile < bins_.size(); ++tile) {
+                std::uint64_t signature = kEmptyTileSignature;
+                for (const auto index : bins_[tile])
+                    signature = mix(signature, commandSignatures_[index]);
+
+                if (!history || signatures_[tile] != signature)
+                    work_.push_back(tile);
+                signatures_[tile] = signature;
+            }
+            historyValid_ = true;
+        }
+
+        // Runs of rewritten tiles per tile row, each merged into a rect ending
+        // just above it when that rect spans the same columns.
+        void build_dirty_rects()
+        {
+            const auto tilesX = static_cast<std::uint32_t>(tilesX_);
+            for (std::size_t i = 0; i < work_.size(); ++i) {
+                const std::uint32_t first = work_[i];
+                const std::uint32_t row = first / tilesX;
+                std::uint32_t last = first;
+                while (i + 1 < work_.size() && work_[i + 1] == last + 1 && work_[i + 1] / tilesX == row)
+                    last = work_[++i];
+
+                const int x = static_cast<int>(first % tilesX) * kTileSize;
+                const int y = static_cast<int>(row) * kTileSize;
+                const DirtyRect rect{ x, y,
+                    (std::min)(width_, static_cast<int>(last % tilesX + 1) * kTileSize) - x,
+                    (std::min)(height_, y + kTileSize) - y };
+
+                const auto above = std::find_if(dirtyRects_.begin(), dirtyRects_.end(), [&](const DirtyRect& r) {
+                    return r.x == rect.x && r.width == rect.width && r.y + r.height == rect.y;
+                });
+                if (above != dirtyRects_.end())
+                    above->height += rect.height;
+                else
+                    dirtyRects_.push_back(rect);
+            }
+        }
+
+        // Inclusive pixel bounds; clipped to the frame here.
+        void bin(int minX, int minY, int maxX, int maxY, Command command, std::uint64_t signature)
+        {
+            minX = (std::max)(minX, 0);
+            minY = (std::max)(minY, 0);
+            maxX = (std::min)(maxX, width_ - 1);
+            maxY = (std::min)(maxY, height_ - 1);
+            if (minX > maxX || minY > maxY)
+                return;
+
+            const auto index = static_cast<std::uint32_t>(commands_.size());
+            commands_.push_back(command);
+            commandSignatures_.push_back(signature);
+
+            for (int ty = minY / kTileSize; ty <= maxY / kTileSize; ++ty) {
+                for (int tx = minX / kTileSize; tx <= maxX / kTileSize; ++tx) {
+                    const auto tile = static_cast<std::uint32_t>(ty * tilesX_ + tx);
+                    auto& cell = bins_[tile];
+                    if (cell.empty()) {
+                        active_.push_back(tile);
+                        if (depthClear_ != kNoCommand)
+                            cell.push_back(depthClear_);
+                    }
+                    cell.push_back(index);
+                }
+            }
+        }
+
+        void drain(std::uint32_t* framebuffer, TileScratch& scratch)
+        {
+            for (std::size_t i = next_.fetch_add(1, std::memory_order_relaxed); i < work_.size();
+                i = next_.fetch_add(1, std::memory_order_relaxed))
+                render_tile(work_[i], framebuffer, scratch);
+        }
+
+        void render_tile(std::uint32_t tile, std::uint32_t* framebuffer, TileScratch& scratch)
+        {
+            const int originX = static_cast<int>(tile % static_cast<std::uint32_t>(tilesX_)) * kTileSize;
+            const int originY = static_cast<int>(tile / static_cast<std::uint32_t>(tilesX_)) * kTileSize;
+            const int w = (std::min)(kTileSize, width_ - originX);
+            const int h = (std::min)(kTileSize, height_ - originY);
+            const std::size_t frameStride = static_cast<std::size_t>(width_);
+
+            auto frameRow = [&](int y) {
+                return framebuffer + static_cast<std::size_t>(originY + y) * frameStride + static_cast<std::size_t>(originX);
+            };
+
+            auto depthRow = [&](int y) {
+                return depth_ + static_cast<std::size_t>(originY + y) * frameStride + static_cast<std::size_t>(originX);
+            };
+
+            if (retained_) {
+                scratch.color.fill(clearColor_);
+            }
+            else {
+                for (int y = 0; y < h; ++y)
+                    std::copy_n(frameRow(y), w, scratch.color.data() + y * kTileSize);
+            }
+
+            if (depth_ && !retained_) {
+                for (int y = 0; y < h; ++y)
+                    std::copy_n(depthRow(y), w, scratch.depth.data() + y * kTileSize);
+            }
+            else {
+                scratch.depth.fill((std::numeric_limits<float>::infinity)());
+            }
+
+            const blit::BlitTarget blitTarget{ scratch.color.data(), w, h, kTileSize, originX, originY };
+            const SoftwareRenderer::RasterTarget rasterTarget{
+                scratch.color.data(), scratch.depth.data(), originX, originY, w, h, kTileSize };
+
+            for (const auto index : bins_[tile]) {
+                const Command& command = commands_[index];
+                switch (command.kind) {
+                case Kind::Sprite: {
+                    const auto& s = sprites_[command.index];
+                    blit::blit_sprite(blitTarget, s.source, s.src, s.dest, s.sampling);
+                    break;
+                }
+                case Kind::Triangle:
+                    SoftwareRenderer::rasterize_setup(triangles_[command.index], rasterTarget);
+                    break;
+                case Kind::DepthClear:
+                    scratch.depth.fill((std::numeric_limits<float>::infinity)());
+                    break;
+                }
+            }
+
+            for (int y = 0; y < h; ++y)
+                std::copy_n(scratch.color.data() + y * kTileSize, w, frameRow(y));
+            if (depth_) {
+                for (int y = 0; y < h; ++y)
+                    std::copy_n(scratch.depth.data() + y * kTileSize, w, depthRow(y));
+            }
+        }
+
+        static Task tile_worker(TileRenderer* self, std::uint32_t* framebuffer, TileScratch* scratch)
+        {
+            self->drain(framebuffer, *scratch);
+            co_return;
+        }
+
+        int width_{ 0 };
+        int height_{ 0 };
+        int tilesX_{ 0 };
+        int tilesY_{ 0 };
+        bool recording_{ false };
+        std::uint32_t depthClear_{ kNoCommand };        // latest depth clear this frame
+
+        std::vector<Command> commands_;
+        std::vector<std::uint64_t> commandSignatures_;  // parallel to commands_
+        std::vector<SpriteDraw> sprites_;
+        std::vector<SoftwareRenderer::TriangleSetup> triangles_;
+        std::vector<std::vector<std::uint32_t>> bins_;  // command indices per tile, in submission order
+        std::vector<std::uint32_t> active_;             // tiles with at least one command
+        std::vector<std::uint32_t> work_;               // tiles resolve() renders
+
+        // Retained frames
+        bool retained_{ false };
+        bool historyValid_{ false };
+        std::uint32_t clearColor_{ 0 };
+        int frameWidth_{ 0 };
+        int frameHeight_{ 0 };
+        std::vector<std::uint64_t> signatures_;         // per tile, as of the last retained resolve
+        std::vector<DirtyRect> dirtyRects_;
+
+        float* depth_{ nullptr };                       // set for the duration of resolve()
+        std::atomic<std::size_t> next_{ 0 };
+        std::vector<std::unique_ptr<TileScratch>> scratch_;
+        std::unique_ptr<taskgraph::TaskGraph> graph_;
+    };
+}
+
+#else
+export namespace almondnamespace::anativecontext {}
+#endif // ALMOND_USING_SOFTWARE_RENDERER
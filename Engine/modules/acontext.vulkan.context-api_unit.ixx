@@ -142,6 +142,7 @@ namespace almondnamespace::vulkancontext
 
         auto& app = vulkan_app();
         app.set_active_context(ctx.get());
+        atlasmanager::mark_quiescent(core::ContextType::Vulkan);
         atlasmanager::process_pending_uploads(core::ContextType::Vulkan);
 
         const bool result = app.process(ctx, queue);
@@ -228,7 +228,8 @@ namespace almondnamespace::vulkancontext
         vk::Extent2D chooseSwapExtent(const vk::SurfaceCapabilitiesKHR& capabilities);
 
         void createSwapChain();
-        vk::UniqueImageView createImageViewUnique(vk::Image image, vk::Format format, vk::ImageAspectFlags aspectFlags);
+        vk::UniqueImageView createImageViewUnique(vk::Image image, vk::Format format, vk::ImageAspectFlags aspectFlags,
+            std::uint32_t mipLevels = 1);
         void createImageViews();
 
         void createRenderPass();
@@ -246,9 +247,12 @@ namespace almondnamespace::vulkancontext
 
         void createTextureImage();
         void transitionImageLayout(vk::Image image, vk::Format format,
-            vk::ImageLayout oldLayout, vk::ImageLayout newLayout);
+            vk::ImageLayout oldLayout, vk::ImageLayout newLayout, std::uint32_t levelCount = 1);
         void copyBufferToImage(vk::Buffer buffer, vk::Image image,
             std::uint32_t width, std::uint32_t height);
+        void copyBufferToImageRegion(vk::Buffer buffer, vk::Image image,
+            std::int32_t x, std::int32_t y, std::uint32_t width, std::uint32_t height,
+            std::uint32_t mipLevel = 0);
         void createTextureImageView();
         void createTextureSampler();
 
@@ -320,6 +324,7 @@ namespace almondnamespace::vulkancontext
             std::uint64_t version{ 0 };
             std::uint32_t width{ 0 };
             std::uint32_t height{ 0 };
+            std::uint32_t mipLevels{ 1 }; // base level included
         };
 
         struct GuiContextState
@@ -152,13 +152,14 @@ namespace almondnamespace::vulkancontext
     vk::UniqueImageView Application::createImageViewUnique(
         vk::Image image,
         vk::Format format,
-        vk::ImageAspectFlags aspectFlags)
+        vk::ImageAspectFlags aspectFlags,
+        std::uint32_t mipLevels)
     {
         vk::ImageViewCreateInfo viewInfo{};
         viewInfo.image = image;
         viewInfo.viewType = vk::ImageViewType::e2D;
         viewInfo.format = format;
-        viewInfo.subresourceRange = vk::ImageSubresourceRange(aspectFlags, 0, 1, 0, 1);
+        viewInfo.subresourceRange = vk::ImageSubresourceRange(aspectFlags, 0, mipLevels, 0, 1);
 
         auto [ivRes, iv] = device->createImageViewUnique(viewInfo);
         if (ivRes != vk::Result::eSuccess)
@@ -22,7 +22,7 @@ export namespace almondnamespace::vulkantextures
 namespace almondnamespace::vulkancontext
 {
     void Application::transitionImageLayout(vk::Image image, vk::Format /*format*/,
-        vk::ImageLayout oldLayout, vk::ImageLayout newLayout)
+        vk::ImageLayout oldLayout, vk::ImageLayout newLayout, std::uint32_t levelCount)
     {
         vk::UniqueCommandBuffer commandBuffer = beginSingleTimeCommands();
 
@@ -34,7 +34,7 @@ namespace almondnamespace::vulkancontext
         barrier.image = image;
         barrier.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
         barrier.subresourceRange.baseMipLevel = 0;
-        barrier.subresourceRange.levelCount = 1;
+        barrier.subresourceRange.levelCount = levelCount;
         barrier.subresourceRange.baseArrayLayer = 0;
         barrier.subresourceRange.layerCount = 1;
 
@@ -57,6 +57,15 @@ namespace almondnamespace::vulkancontext
             sourceStage = vk::PipelineStageFlagBits::eTransfer;
             destinationStage = vk::PipelineStageFlagBits::eFragmentShader;
         }
+        else if (oldLayout == vk::ImageLayout::eShaderReadOnlyOptimal &&
+            newLayout == vk::ImageLayout::eTransferDstOptimal)
+        {
+            // Partial re-upload of an image that is already being sampled.
+            barrier.srcAccessMask = vk::AccessFlagBits::eShaderRead;
+            barrier.dstAccessMask = vk::AccessFlagBits::eTransferWrite;
+            sourceStage = vk::PipelineStageFlagBits::eFragmentShader;
+            destinationStage = vk::PipelineStageFlagBits::eTransfer;
+        }
         else
         {
             throw std::runtime_error("Unsupported layout transition!");
@@ -101,6 +110,34 @@ namespace almondnamespace::vulkancontext
         endSingleTimeCommands(commandBuffer);
     }
 
+    void Application::copyBufferToImageRegion(vk::Buffer buffer, vk::Image image,
+        std::int32_t x, std::int32_t y, std::uint32_t width, std::uint32_t height,
+        std::uint32_t mipLevel)
+    {
+        vk::UniqueCommandBuffer commandBuffer = beginSingleTimeCommands();
+
+        vk::BufferImageCopy region{};
+        region.bufferOffset = 0;
+        region.bufferRowLength = 0;
+        region.bufferImageHeight = 0;
+        region.imageSubresource.aspectMask = vk::ImageAspectFlagBits::eColor;
+        region.imageSubresource.mipLevel = mipLevel;
+        region.imageSubresource.baseArrayLayer = 0;
+        region.imageSubresource.layerCount = 1;
+        region.imageOffset = vk::Offset3D{ x, y, 0 };
+        region.imageExtent = vk::Extent3D{ width, height, 1u };
+
+        commandBuffer->copyBufferToImage(
+            buffer,
+            image,
+            vk::ImageLayout::eTransferDstOptimal,
+            1,
+            &region
+        );
+
+        endSingleTimeCommands(commandBuffer);
+    }
+
     void Application::createTextureImageView()
     {
         textureImageView = createImageViewUnique(
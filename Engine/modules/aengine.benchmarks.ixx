@@ -0,0 +1,1071 @@
+/**************************************************************
+ *   AlmondShell - Modular C++ Framework
+ **************************************************************/
+ // aengine.benchmarks.ixx
+ //
+ // Headless micro-benchmarks reachable through `--bench <name>`.
+ // Each benchmark prints one line per variant so results can be
+ // diffed between builds.
+
+module;
+
+#include <include/aengine.config.hpp> // for ALMOND_USING Macros
+
+export module aengine.benchmarks;
+
+import <algorithm>;
+import <array>;
+import <atomic>;
+import <chrono>;
+import <cstdint>;
+import <format>;
+import <iomanip>;
+import <iostream>;
+import <limits>;
+import <memory>;
+import <span>;
+import <string>;
+import <string_view>;
+import <thread>;
+import <unordered_map>;
+import <utility>;
+import <vector>;
+
+import aatlas.packer;
+import aatlas.texture;
+import acellularsim.life;
+import acontext.softrenderer.blit;
+import aengine.core.commandline;
+import aengine.gui;
+import amipmapatlas;
+import asandsim.world;
+import asprite.pool;
+import aspritehandle;
+import atexture;
+#if defined(ALMOND_USING_SOFTWARE_RENDERER)
+import aengine.context.commandqueue;
+import aengine.context.type;
+import aengine.core.context;
+import acontext.softrenderer.context;
+import acontext.softrenderer.headless;
+import acontext.softrenderer.mesh;
+import acontext.softrenderer.renderer;
+import acontext.softrenderer.state;
+import acontext.softrenderer.textures;
+import acontext.softrenderer.tiles;
+import aspritetable;
+#endif
+
+export namespace almondnamespace::benchmarks
+{
+    namespace detail
+    {
+        using Clock = std::chrono::steady_clock;
+
+        inline double elapsed_ms(Clock::time_point start) noexcept
+        {
+            return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        }
+
+        // Deterministic LCG so every run packs the same sprite set.
+        struct Lcg
+        {
+            std::uint32_t state{ 0x2545F491u };
+            std::uint32_t next() noexcept
+            {
+                state = state * 1664525u + 1013904223u;
+                return state >> 8;
+            }
+            std::uint32_t range(std::uint32_t lo, std::uint32_t hi) noexcept
+            {
+                return lo + next() % (hi - lo + 1);
+            }
+        };
+
+        // Mostly glyph-sized entries, some UI icons and a few large sprites.
+        inline std::vector<std::pair<std::uint32_t, std::uint32_t>> mixed_sprite_sizes(std::size_t count)
+        {
+            Lcg rng{};
+            std::vector<std::pair<std::uint32_t, std::uint32_t>> sizes;
+            sizes.reserve(count);
+            for (std::size_t i = 0; i < count; ++i) {
+                const std::uint32_t bucket = rng.next() % 100;
+                if (bucket < 70)
+                    sizes.emplace_back(rng.range(8, 31), rng.range(12, 31));
+                else if (bucket < 95)
+                    sizes.emplace_back(rng.range(16, 63), rng.range(16, 63));
+                else
+                    sizes.emplace_back(rng.range(64, 191), rng.range(64, 191));
+            }
+            return sizes;
+        }
+
+        // The sprite pool's previous allocator: claim the first free flag at or
+        // after the last allocation, scanning round the whole pool.
+        struct RoundRobinPool
+        {
+            std::vector<std::uint8_t> used;
+            std::atomic<std::size_t> last{ 0 };
+
+            explicit RoundRobinPool(std::size_t capacity) : used(capacity, 0) {}
+
+            std::size_t allocate() noexcept
+            {
+                const std::size_t start = last.load(std::memory_order_relaxed);
+                for (std::size_t offset = 0; offset < used.size(); ++offset) {
+                    const std::size_t idx = (start + offset) % used.size();
+                    std::uint8_t expected = 0;
+                    if (std::atomic_ref<std::uint8_t>(used[idx]).compare_exchange_strong(expected, 1, std::memory_order_acquire)) {
+                        last.store((idx + 1) % used.size(), std::memory_order_relaxed);
+                        return idx;
+                    }
+                }
+                return used.size();
+            }
+
+            void free(std::size_t idx) noexcept
+            {
+                std::atomic_ref<std::uint8_t>(used[idx]).store(0, std::memory_order_release);
+            }
+        };
+
+        inline const char* packer_name(AtlasPackerKind kind) noexcept
+        {
+            switch (kind) {
+            case AtlasPackerKind::Scan:     return "scan";
+            case AtlasPackerKind::Skyline:  return "skyline";
+            case AtlasPackerKind::MaxRects: return "maxrects";
+            }
+            return "unknown";
+        }
+    }
+
+    // Packs 10k mixed-size sprites into a 4096² atlas with every packer.
+    // The legacy scan packer is capped because it needs minutes for the full set.
+    inline int run_atlas_packers(std::size_t spriteCount = 10000, std::uint32_t atlasSize = 4096,
+        std::size_t scanLimit = 1000)
+    {
+        const auto sizes = detail::mixed_sprite_sizes(spriteCount);
+        const double atlasArea = static_cast<double>(atlasSize) * atlasSize;
+
+        std::cout << "[ Bench ] atlas_packers: " << spriteCount << " sprites into "
+            << atlasSize << "x" << atlasSize << "\n";
+
+        for (auto kind : { AtlasPackerKind::Skyline, AtlasPackerKind::MaxRects, AtlasPackerKind::Scan })
+        {
+            const std::size_t count = (kind == AtlasPackerKind::Scan)
+                ? (std::min)(scanLimit, sizes.size())
+                : sizes.size();
+
+            AtlasPacker packer{};
+            packer.reset(kind, atlasSize, atlasSize);
+
+            std::size_t packed = 0;
+            std::uint32_t extent = 0;
+
+            const auto start = detail::Clock::now();
+            for (std::size_t i = 0; i < count; ++i) {
+                const auto [w, h] = sizes[i];
+                if (auto pos = packer.pack(w, h)) {
+                    ++packed;
+                    extent = (std::max)(extent, pos->second + h);
+                }
+            }
+            const double ms = detail::elapsed_ms(start);
+
+            // Density inside the rows actually touched tells the packers apart
+            // when all of them fit the whole set.
+            const double used = static_cast<double>(packer.used_area());
+            const double density = extent ? used / (static_cast<double>(extent) * atlasSize) : 0.0;
+
+            std::cout << std::fixed << std::setprecision(2)
+                << "  " << std::setw(8) << detail::packer_name(kind)
+                << "  packed " << packed << "/" << count
+                << "  " << ms << " ms"
+                << "  occupancy " << (used / atlasArea) * 100.0 << "%"
+                << "  extent " << extent << " rows"
+                << "  density " << density * 100.0 << "%\n";
+        }
+
+        return 0;
+    }
+
+    // CPU mip chain of an atlas of small sprites: the full build, then the
+    // refilter after one entry is rewritten. Checks that level 1 of two
+    // adjacent, differently coloured entries does not mix.
+    inline int run_mipmaps(std::size_t spriteCount = 4000, std::uint32_t atlasSize = 2048)
+    {
+        auto solid = [](std::uint32_t w, std::uint32_t h, std::uint8_t r, std::uint8_t g, std::uint8_t b) {
+            Texture tex{};
+            tex.width = w;
+            tex.height = h;
+            tex.pixels.resize(static_cast<std::size_t>(w) * h * 4);
+            for (std::size_t i = 0; i < tex.pixels.size(); i += 4) {
+                tex.pixels[i + 0] = r;
+                tex.pixels[i + 1] = g;
+                tex.pixels[i + 2] = b;
+                tex.pixels[i + 3] = 255;
+            }
+            return tex;
+        };
+
+        std::cout << "[ Bench ] mipmaps: " << spriteCount << " sprites in " << atlasSize << "x" << atlasSize << "\n";
+
+        // Default padding and odd sizes: without a gutter a level 1 texel
+        // would cover both entries.
+        {
+            AtlasConfig config{};
+            config.name = "bench:mip_gutter";
+            config.width = 64;
+            config.height = 64;
+            config.generate_mipmaps = true;
+
+            TextureAtlas atlas;
+            atlas.init(config);
+            const auto red = atlas.add_entry("red", solid(5, 5, 255, 0, 0));
+            const auto blue = atlas.add_entry("blue", solid(5, 5, 0, 0, 255));
+            if (!red || !blue || atlas.mip_level_count == 0) {
+                std::cerr << "[ Bench ] mipmaps: gutter atlas has no mip levels\n";
+                return 1;
+            }
+
+            atlas.ensure_mipmaps();
+            const mip::MipView level = atlas.mip_view(1);
+            auto mixed = [&](const AtlasRegion& region, std::size_t foreignChannel) {
+                const PackerRect rect = mip::scale_rect({ region.x, region.y, region.width, region.height }, 1);
+                for (std::uint32_t y = rect.y; y < rect.y + rect.height; ++y) {
+                    for (std::uint32_t x = rect.x; x < rect.x + rect.width; ++x) {
+                        if (level.pixels[(static_cast<std::size_t>(y) * level.width + x) * 4 + foreignChannel] != 0)
+                            return true;
+                    }
+                }
+                return false;
+            };
+
+            if (mixed(red->region, 2) || mixed(blue->region, 0)) {
+                std::cerr << "[ Bench ] mipmaps: level 1 mixes adjacent entries\n";
+                return 1;
+            }
+        }
+
+        AtlasConfig config{};
+        config.name = "bench:mipmaps";
+        config.width = atlasSize;
+        config.height = atlasSize;
+        config.generate_mipmaps = true;
+
+        TextureAtlas atlas;
+        atlas.init(config);
+
+        detail::Lcg rng{};
+        std::size_t added = 0;
+        std::string lastId;
+        for (std::size_t i = 0; i < spriteCount; ++i) {
+            const auto shade = static_cast<std::uint8_t>(rng.next());
+            std::string id = "sprite" + std::to_string(i);
+            if (atlas.add_entry(id, solid(rng.range(8, 40), rng.range(8, 40), shade, 255 - shade, 128))) {
+                ++added;
+                lastId = std::move(id);
+            }
+        }
+
+        auto start = detail::Clock::now();
+        atlas.ensure_mipmaps();
+        const double fullMs = detail::elapsed_ms(start);
+
+        double partialMs = 0.0;
+        if (const auto region = atlas.get_region(lastId)) {
+            const Texture tex = solid(region->width, region->height, 0, 0, 0);
+            atlas.write_entry(lastId, tex.pixels);
+            start = detail::Clock::now();
+            atlas.ensure_mipmaps();
+            partialMs = detail::elapsed_ms(start);
+        }
+
+        std::cout << std::fixed << std::setprecision(2)
+            << "  " << added << " entries, " << atlas.mip_level_count << " levels"
+            << "  full build " << fullMs << " ms"
+            << "  one entry rewritten " << partialMs << " ms\n";
+        return 0;
+    }
+
+    // Scaled sprite draws into a 1024x768 framebuffer: the scalar reference
+    // against the SIMD path this build selected. Sprites mix opaque, fully
+    // transparent and translucent texels like typical cut-out art.
+    inline int run_sprite_blit(std::size_t drawCount = 20000, int frameW = 1024, int frameH = 768)
+    {
+        using namespace anativecontext::blit;
+
+        constexpr std::uint32_t texSize = 256;
+        detail::Lcg rng{};
+        std::vector<std::uint8_t> texels(static_cast<std::size_t>(texSize) * texSize * 4);
+        for (std::size_t i = 0; i < texels.size(); i += 4) {
+            texels[i + 0] = static_cast<std::uint8_t>(rng.next());
+            texels[i + 1] = static_cast<std::uint8_t>(rng.next());
+            texels[i + 2] = static_cast<std::uint8_t>(rng.next());
+            const std::uint32_t bucket = rng.next() % 10;
+            texels[i + 3] = bucket < 3 ? 0 : bucket < 9 ? 255 : static_cast<std::uint8_t>(rng.next());
+        }
+
+        // Half-size level for the trilinear variant.
+        constexpr std::uint32_t coarseSize = texSize / 2;
+        std::vector<std::uint8_t> coarseTexels(static_cast<std::size_t>(coarseSize) * coarseSize * 4);
+        for (std::uint32_t y = 0; y < coarseSize; ++y)
+            for (std::uint32_t x = 0; x < coarseSize; ++x)
+                for (std::uint32_t c = 0; c < 4; ++c) {
+                    auto at = [&](std::uint32_t sx, std::uint32_t sy) { return static_cast<std::uint32_t>(texels[(sy * texSize + sx) * 4 + c]); };
+                    coarseTexels[(y * coarseSize + x) * 4 + c] = static_cast<std::uint8_t>(
+                        (at(2 * x, 2 * y) + at(2 * x + 1, 2 * y) + at(2 * x, 2 * y + 1) + at(2 * x + 1, 2 * y + 1) + 2) / 4);
+                }
+
+        struct Draw { BlitRect src, dest; };
+        std::vector<Draw> draws;
+        draws.reserve(drawCount);
+        for (std::size_t i = 0; i < drawCount; ++i) {
+            const int sw = static_cast<int>(rng.range(8, 64));
+            const int sh = static_cast<int>(rng.range(8, 64));
+            const int sx = static_cast<int>(rng.range(0, texSize - static_cast<std::uint32_t>(sw)));
+            const int sy = static_cast<int>(rng.range(0, texSize - static_cast<std::uint32_t>(sh)));
+            const bool unit = rng.next() % 2 == 0;
+            const int dw = unit ? sw : static_cast<int>(rng.range(4, 128));
+            const int dh = unit ? sh : static_cast<int>(rng.range(4, 128));
+            draws.push_back({ { sx, sy, sw, sh },
+                { static_cast<int>(rng.range(0, static_cast<std::uint32_t>(frameW))) - dw / 2, static_cast<int>(rng.range(0, static_cast<std::uint32_t>(frameH))) - dh / 2, dw, dh } });
+        }
+
+        std::cout << "[ Bench ] sprite_blit: " << drawCount << " draws into "
+            << frameW << "x" << frameH << "\n";
+
+        constexpr const char* filterNames[] = { "nearest", "bilinear", "trilinear" };
+        for (const SampleFilter filter : { SampleFilter::Nearest, SampleFilter::Bilinear, SampleFilter::Trilinear }) {
+            std::vector<std::uint32_t> reference;
+            for (const bool simd : { false, true }) {
+                std::vector<std::uint32_t> frame(static_cast<std::size_t>(frameW) * frameH, 0xFF202020u);
+                const BlitTarget target{ frame.data(), frameW, frameH };
+                const BlitSource source{ texels.data(), texSize, texSize };
+
+                std::uint64_t pixels = 0;
+                const auto start = detail::Clock::now();
+                for (const auto& d : draws) {
+                    SpriteSampling sampling{ filter };
+                    if (filter == SampleFilter::Trilinear) {
+                        sampling.coarse = { coarseTexels.data(), coarseSize, coarseSize };
+                        sampling.coarseSrc = { d.src.x / 2, d.src.y / 2, d.src.width / 2, d.src.height / 2 };
+                        sampling.lodFrac = 128;
+                    }
+                    if (simd)
+                        blit_sprite(target, source, d.src, d.dest, sampling);
+                    else
+                        blit_sprite_scalar(target, source, d.src, d.dest, sampling);
+                    pixels += static_cast<std::uint64_t>(d.dest.width) * d.dest.height;
+                }
+                const double ms = detail::elapsed_ms(start);
+
+                if (!simd)
+                    reference = frame;
+
+                std::cout << std::fixed << std::setprecision(2)
+                    << "  " << std::setw(9) << filterNames[static_cast<int>(filter)]
+                    << "  " << std::setw(8) << (simd ? blit_path_name() : "scalar")
+                    << "  " << ms << " ms"
+                    << "  " << (ms > 0.0 ? static_cast<double>(pixels) / (ms * 1000.0) : 0.0) << " Mpix/s"
+                    << (simd ? (frame == reference ? "  matches scalar" : "  MISMATCH") : "") << "\n";
+
+                if (simd && frame != reference) {
+                    std::cerr << "[ Bench ] sprite_blit: " << blit_path_name() << " "
+                        << filterNames[static_cast<int>(filter)] << " output differs from scalar\n";
+                    return 1;
+                }
+            }
+        }
+
+        return 0;
+    }
+
+#if defined(ALMOND_USING_SOFTWARE_RENDERER)
+    // Triangle throughput of the software rasterizer at 1280x720: the spinning
+    // textured cube (few large triangles), a grid of cube meshes through the
+    // mesh pipeline, and a field of small triangles drawn both serially and
+    // through the tile renderer.
+    inline int run_triangles(int cubeFrames = 300, std::size_t fieldCount = 50000, int fieldFrames = 10)
+    {
+        using namespace anativecontext;
+        constexpr int frameW = 1280;
+        constexpr int frameH = 720;
+
+        detail::Lcg rng{};
+        auto texture = create_texture(64, 64);
+        for (auto& texel : texture->pixels)
+            texel = 0xFF000000u | rng.next();
+
+        std::cout << "[ Bench ] triangles: " << frameW << "x" << frameH << "\n";
+
+        auto report = [](const char* name, double ms, std::size_t triangles, int frames) {
+            std::cout << std::fixed << std::setprecision(2)
+                << "  " << std::setw(12) << name
+                << "  " << ms / frames << " ms/frame"
+                << "  " << (ms > 0.0 ? static_cast<double>(triangles) / ms : 0.0) << " ktri/s\n";
+        };
+
+        {
+            Framebuffer fb(frameW, frameH);
+            const auto start = detail::Clock::now();
+            for (int f = 0; f < cubeFrames; ++f) {
+                fb.clear(0xFF101010u);
+                SoftwareRenderer::render_cube(fb, texture, f * 0.02f);
+            }
+            report("cube", detail::elapsed_ms(start), static_cast<std::size_t>(cubeFrames) * 12, cubeFrames);
+        }
+
+        {
+            constexpr int grid = 8;
+            const Mesh cube = make_cube_mesh();
+            MeshPipeline pipeline{};
+            MeshDrawParams params{};
+            params.texture = texture;
+            params.cull = CullMode::Back;
+            params.proj = SoftwareRenderer::perspective(0.8f, static_cast<float>(frameW) / frameH, 0.1f, 100.0f);
+            params.view = SoftwareRenderer::translation({ 0.0f, 0.0f, -12.0f });
+
+            Framebuffer fb(frameW, frameH);
+            std::size_t triangles = 0;
+            const auto start = detail::Clock::now();
+            for (int f = 0; f < cubeFrames; ++f) {
+                fb.clear(0xFF101010u);
+                fb.clear_depth();
+                const Mat4 spin = SoftwareRenderer::mul(SoftwareRenderer::rotationY(f * 0.02f), SoftwareRenderer::rotationX(f * 0.01f));
+                for (int gy = 0; gy < grid; ++gy) {
+                    for (int gx = 0; gx < grid; ++gx) {
+                        params.model = SoftwareRenderer::mul(
+                            SoftwareRenderer::translation({ (gx - grid / 2 + 0.5f) * 1.5f, (gy - grid / 2 + 0.5f) * 1.5f, 0.0f }), spin);
+                        render_mesh(fb, pipeline, cube, params);
+                        triangles += cube.indices.size() / 3;
+                    }
+                }
+            }
+            report("mesh_cubes", detail::elapsed_ms(start), triangles, cubeFrames);
+        }
+
+        // Small triangles in front of the camera, 2-40 px across on screen.
+        std::vector<Triangle> field;
+        field.reserve(fieldCount);
+        for (std::size_t i = 0; i < fieldCount; ++i) {
+            const float z = 1.0f + static_cast<float>(rng.range(0, 1000)) / 250.0f;
+            const float scale = (z + 3.0f) / 200.0f;
+            const float cx = (static_cast<float>(rng.range(0, frameW)) - frameW * 0.5f) * scale;
+            const float cy = (static_cast<float>(rng.range(0, frameH)) - frameH * 0.5f) * scale;
+            auto corner = [&] {
+                const float r = static_cast<float>(rng.range(1, 20)) * scale;
+                const float dx = (static_cast<float>(rng.range(0, 200)) / 100.0f - 1.0f) * r;
+                const float dy = (static_cast<float>(rng.range(0, 200)) / 100.0f - 1.0f) * r;
+                return Vertex{ { cx + dx, cy + dy, z }, { dx > 0.0f ? 1.0f : 0.0f, dy > 0.0f ? 1.0f : 0.0f } };
+            };
+
+            Triangle tri{};
+            tri.v0 = corner();
+            tri.v1 = corner();
+            tri.v2 = corner();
+            // Face the camera so the field is not half culled.
+            const float cross = (tri.v1.pos.x - tri.v0.pos.x) * (tri.v2.pos.y - tri.v0.pos.y)
+                - (tri.v1.pos.y - tri.v0.pos.y) * (tri.v2.pos.x - tri.v0.pos.x);
+            if (cross < 0.0f)
+                std::swap(tri.v1, tri.v2);
+            tri.tex = (i % 2) ? texture : nullptr;
+            tri.color = 0xFF000000u | rng.next();
+            field.push_back(std::move(tri));
+        }
+
+        Framebuffer serial(frameW, frameH);
+        {
+            std::vector<float> zbuf(static_cast<std::size_t>(frameW) * frameH);
+            const auto start = detail::Clock::now();
+            for (int f = 0; f < fieldFrames; ++f) {
+                serial.clear(0xFF101010u);
+                std::fill(zbuf.begin(), zbuf.end(), (std::numeric_limits<float>::infinity)());
+                for (const auto& tri : field)
+                    SoftwareRenderer::rasterize_triangle(serial, tri, zbuf);
+            }
+            report("field", detail::elapsed_ms(start), field.size() * fieldFrames, fieldFrames);
+        }
+
+        {
+            Framebuffer tiled(frameW, frameH);
+            TileRenderer tiles{};
+            const auto start = detail::Clock::now();
+            for (int f = 0; f < fieldFrames; ++f) {
+                tiled.clear(0xFF101010u);
+                tiles.begin_frame(frameW, frameH);
+                for (const auto& tri : field)
+                    tiles.submit_triangle(tri);
+                tiles.resolve(tiled.pixels);
+            }
+            report("field/tiled", detail::elapsed_ms(start), field.size() * fieldFrames, fieldFrames);
+            tiles.shutdown();
+
+            if (tiled.pixels != serial.pixels) {
+                std::cerr << "[ Bench ] triangles: tiled output differs from serial\n";
+                return 1;
+            }
+        }
+
+        // The same static field as retained frames: after the first frame
+        // every tile matches its previous signature and nothing is redrawn.
+        {
+            Framebuffer retained(frameW, frameH);
+            TileRenderer tiles{};
+            std::size_t redrawn = 0;
+            const auto start = detail::Clock::now();
+            for (int f = 0; f < fieldFrames; ++f) {
+                tiles.begin_frame(frameW, frameH, 0xFF101010u);
+                for (const auto& tri : field)
+                    tiles.submit_triangle(tri);
+                tiles.resolve(retained.pixels);
+                redrawn += tiles.tiles_redrawn();
+            }
+            report("field/retain", detail::elapsed_ms(start), field.size() * fieldFrames, fieldFrames);
+            std::cout << "  " << std::setw(12) << "" << "  " << redrawn << " of "
+                << tiles.tile_count() * static_cast<std::size_t>(fieldFrames) << " tiles redrawn\n";
+            tiles.shutdown();
+
+            if (retained.pixels != serial.pixels) {
+                std::cerr << "[ Bench ] triangles: retained output differs from serial\n";
+                return 1;
+            }
+        }
+
+        return 0;
+    }
+#endif
+
+#if defined(ALMOND_USING_SOFTWARE_RENDERER)
+    // A sand-sim style board of 8x8 cells at 1280x720, drawn the way the grid
+    // games used to (a name lookup and a draw_sprite per cell) and with one
+    // draw_tilemap call per frame. Both must produce the same frame.
+    inline int run_tilemap(int frames = 100)
+    {
+        constexpr int frameW = 1280;
+        constexpr int frameH = 720;
+        constexpr int cols = 160;
+        constexpr int rows = 90;
+        constexpr float cellSize = 8.0f;
+        constexpr std::array<std::string_view, 4> materialNames{ "sand", "water", "stone", "wood" };
+
+        TextureAtlas atlas{};
+        atlas.init({ .name = "bench_tilemap", .width = 64, .height = 64 });
+
+        detail::Lcg rng{};
+        SpriteTable table{};
+        std::unordered_map<std::string, SpriteHandle> byName{};
+        for (std::uint32_t i = 0; i < materialNames.size(); ++i) {
+            Texture texture{};
+            texture.width = 8;
+            texture.height = 8;
+            texture.pixels.resize(8 * 8 * 4);
+            for (auto& texel : texture.pixels)
+                texel = static_cast<std::uint8_t>(rng.next());
+            if (!atlas.add_entry(std::string(materialNames[i]), texture))
+                return 1;
+
+            const SpriteHandle handle{ i, 0, 0, i };
+            table.set(i, handle);
+            byName[std::string(materialNames[i])] = handle;
+        }
+        atlas.rebuild_pixels();
+
+        const TextureAtlas* atlasList[] = { &atlas };
+        const std::span<const TextureAtlas* const> atlases(atlasList);
+
+        std::vector<int> grid(static_cast<std::size_t>(cols) * rows);
+        std::vector<std::uint16_t> cells(grid.size());
+        for (std::size_t i = 0; i < grid.size(); ++i) {
+            grid[i] = static_cast<int>(rng.next() % 5) - 1; // -1 = empty
+            cells[i] = grid[i] < 0 ? kNoTile : static_cast<std::uint16_t>(grid[i]);
+        }
+
+        auto& sr = anativecontext::s_softrendererstate;
+        anativecontext::softrenderer_resize(frameW, frameH);
+
+        std::cout << "[ Bench ] tilemap: " << cols << "x" << rows << " cells into "
+            << frameW << "x" << frameH << "\n";
+
+        auto report = [&](const char* name, double ms) {
+            std::cout << std::fixed << std::setprecision(3)
+                << "  " << std::setw(8) << name
+                << "  " << ms / frames << " ms/frame"
+                << "  " << (ms > 0.0 ? static_cast<double>(grid.size()) * frames / (ms * 1000.0) : 0.0) << " Mcells/s\n";
+        };
+
+        auto start = detail::Clock::now();
+        for (int f = 0; f < frames; ++f) {
+            for (int row = 0; row < rows; ++row) {
+                for (int col = 0; col < cols; ++col) {
+                    const int material = grid[static_cast<std::size_t>(row * cols + col)];
+                    if (material < 0)
+                        continue;
+                    auto it = byName.find(std::string(materialNames[static_cast<std::size_t>(material)]));
+                    if (it == byName.end())
+                        continue;
+                    anativecontext::draw_sprite(it->second, atlases,
+                        cellSize * float(col), cellSize * float(row), cellSize, cellSize);
+                }
+            }
+        }
+        report("per-cell", detail::elapsed_ms(start));
+        const std::vector<std::uint32_t> reference = sr.framebuffer;
+
+        std::fill(sr.framebuffer.begin(), sr.framebuffer.end(), 0xFF000000u);
+        start = detail::Clock::now();
+        for (int f = 0; f < frames; ++f)
+            anativecontext::draw_tilemap(table.entries(), cells, cols, rows, { 0.0f, 0.0f, cellSize, cellSize }, atlases);
+        report("tilemap", detail::elapsed_ms(start));
+
+        if (sr.framebuffer != reference) {
+            std::cerr << "[ Bench ] tilemap: output differs from per-cell draws\n";
+            return 1;
+        }
+        return 0;
+    }
+
+    // Full software frames through the headless context: a grid of textured
+    // cubes drawn with draw_mesh, cleared, tiled and resolved like a windowed
+    // frame. The scene only depends on the frame number, so the final hash is
+    // a golden value for --expect-hash. --frames, --width/--height and
+    // --dump-frames apply.
+    inline int run_headless(int defaultFrames = 120)
+    {
+        using namespace anativecontext;
+        namespace cli = core::cli;
+
+        HeadlessOptions options{};
+        if (cli::window_width_overridden) options.width = cli::window_width;
+        if (cli::window_height_overridden) options.height = cli::window_height;
+        options.dumpDirectory = cli::frame_dump_dir;
+        configure_headless(options);
+
+        auto ctx = std::make_shared<core::Context>();
+        ctx->type = core::ContextType::SoftwareHeadless;
+        ctx->backendName = "SoftwareHeadless";
+        if (!headless_initialize(ctx))
+            return 1;
+
+        detail::Lcg rng{};
+        auto texture = create_texture(64, 64);
+        for (auto& texel : texture->pixels)
+            texel = 0xFF000000u | rng.next();
+
+        constexpr int grid = 8;
+        const Mesh cube = make_cube_mesh();
+        MeshDrawParams params{};
+        params.texture = texture;
+        params.cull = CullMode::Back;
+        params.proj = SoftwareRenderer::perspective(0.8f, static_cast<float>(options.width) / options.height, 0.1f, 100.0f);
+        params.view = SoftwareRenderer::translation({ 0.0f, 0.0f, -12.0f });
+
+        core::CommandQueue queue{};
+        const int frames = cli::bench_frames > 0 ? cli::bench_frames : defaultFrames;
+        const HeadlessStats stats = run_headless_frames(ctx, queue, frames, [&](int f) {
+            queue.enqueue([&, f] {
+                const Mat4 spin = SoftwareRenderer::mul(SoftwareRenderer::rotationY(f * 0.02f), SoftwareRenderer::rotationX(f * 0.01f));
+                for (int gy = 0; gy < grid; ++gy) {
+                    for (int gx = 0; gx < grid; ++gx) {
+                        params.model = SoftwareRenderer::mul(
+                            SoftwareRenderer::translation({ (gx - grid / 2 + 0.5f) * 1.5f, (gy - grid / 2 + 0.5f) * 1.5f, 0.0f }), spin);
+                        draw_mesh(cube, params);
+                    }
+                }
+            });
+        });
+        headless_cleanup(ctx);
+
+        const std::string hash = std::format("{:016x}", stats.lastHash);
+        std::cout << "[ Bench ] headless: " << options.width << "x" << options.height << "\n"
+            << std::fixed << std::setprecision(2)
+            << "  " << stats.frames << " frames  " << stats.ms_per_frame() << " ms/frame"
+            << "  " << (stats.totalMs > 0.0 ? stats.frames * 1000.0 / stats.totalMs : 0.0) << " fps"
+            << "  last frame hash " << hash;
+        if (stats.dumped > 0)
+            std::cout << "  (" << stats.dumped << " frames written to " << options.dumpDirectory.string() << ")";
+        std::cout << "\n";
+
+        if (!cli::expected_frame_hash.empty() && cli::expected_frame_hash != hash) {
+            std::cerr << "[ Bench ] headless: frame hash " << hash << " != expected " << cli::expected_frame_hash << "\n";
+            return 1;
+        }
+        return 0;
+    }
+#endif
+
+    // Falling sand on a 1024² world: stone shelves under blocks of sand
+    // and water, ticked on one thread and on all of them. Both runs must
+    // end in the same world; --frames sets the tick count.
+    inline int run_sandsim(int defaultTicks = 600, int size = 1024)
+    {
+        using sandsim::Material;
+        using sandsim::SandWorld;
+        namespace cli = core::cli;
+
+        const int ticks = cli::bench_frames > 0 ? cli::bench_frames : defaultTicks;
+
+        auto build = [size](SandWorld& world) {
+            world.resize(size, size);
+            detail::Lcg rng{};
+            for (int shelf = 0; shelf < 24; ++shelf) {
+                const int x = static_cast<int>(rng.range(0, static_cast<std::uint32_t>(size - 128)));
+                const int y = static_cast<int>(rng.range(static_cast<std::uint32_t>(size / 4), static_cast<std::uint32_t>(size - 4)));
+                world.fill_rect(x, y, static_cast<int>(rng.range(32, 128)), 3, Material::Stone);
+            }
+            for (int block = 0; block < 16; ++block) {
+                const int x = static_cast<int>(rng.range(0, static_cast<std::uint32_t>(size - 96)));
+                const int y = static_cast<int>(rng.range(0, static_cast<std::uint32_t>(size / 4)));
+                world.fill_rect(x, y, 96, 96, block % 2 ? Material::Water : Material::Sand);
+            }
+        };
+
+        std::cout << "[ Bench ] sandsim: " << size << "x" << size << " cells, "
+            << ticks << " ticks\n";
+
+        std::uint64_t hashes[2]{};
+        for (int parallel = 0; parallel < 2; ++parallel) {
+            SandWorld world{};
+            build(world);
+            world.set_parallel(parallel != 0);
+
+            std::size_t awake = 0;
+            const auto start = detail::Clock::now();
+            for (int t = 0; t < ticks; ++t) {
+                world.tick();
+                awake += world.awake_chunks();
+            }
+            const double ms = detail::elapsed_ms(start);
+            hashes[parallel] = world.hash();
+
+            std::cout << std::fixed << std::setprecision(2)
+                << "  " << std::setw(8) << (parallel ? "parallel" : "serial")
+                << "  " << (ms > 0.0 ? ticks * 1000.0 / ms : 0.0) << " ticks/s"
+                << "  " << ms / ticks << " ms/tick"
+                << "  " << static_cast<double>(awake) / ticks << " of "
+                << world.chunks_x() * world.chunks_y() << " chunks awake\n";
+        }
+
+        std::cout << "  world hash " << std::format("{:016x}", hashes[0]) << "\n";
+        if (hashes[0] != hashes[1]) {
+            std::cerr << "[ Bench ] sandsim: parallel world differs from serial\n";
+            return 1;
+        }
+        return 0;
+    }
+
+    // Life on a 4096² board at one third density: a byte per cell (the
+    // reference), then BitLife on one thread and on all of them. All
+    // three must agree. HashLife then runs scattered acorns across a
+    // 65536² area in one power-of-two jump; a packed 64k² board would
+    // need 1 GiB. --frames sets the BitLife generation count.
+    inline int run_life(int defaultGenerations = 100, int size = 4096, int sparseSize = 65536)
+    {
+        using cellularsim::BitLife;
+        using cellularsim::HashLife;
+        namespace cli = core::cli;
+
+        const int generations = cli::bench_frames > 0 ? cli::bench_frames : defaultGenerations;
+        const int referenceGenerations = (std::min)(generations, 4);
+        const std::size_t cells = static_cast<std::size_t>(size) * static_cast<std::size_t>(size);
+
+        std::vector<std::uint8_t> bytes(cells);
+        detail::Lcg rng{};
+        for (auto& cell : bytes)
+            cell = rng.next() % 3 == 0;
+
+        auto seed = [&](BitLife& life) {
+            life.resize(size, size);
+            for (int y = 0; y < size; ++y)
+                for (int x = 0; x < size; ++x)
+                    life.set(x, y, bytes[static_cast<std::size_t>(y) * static_cast<std::size_t>(size) + static_cast<std::size_t>(x)] != 0);
+        };
+
+        std::cout << "[ Bench ] life: " << size << "x" << size << " cells, "
+            << generations << " generations\n";
+
+        auto report = [&](const char* name, int gens, double ms) {
+            std::cout << std::fixed << std::setprecision(2)
+                << "  " << std::setw(10) << name
+                << "  " << (ms > 0.0 ? gens * 1000.0 / ms : 0.0) << " gen/s"
+                << "  " << (ms > 0.0 ? static_cast<double>(cells) * gens / (ms * 1000.0) : 0.0) << " Mcells/s\n";
+        };
+
+        BitLife check{};
+        seed(check);
+        check.set_parallel(false);
+        check.step(static_cast<std::uint64_t>(referenceGenerations));
+
+        {
+            std::vector<std::uint8_t> next(cells);
+            const auto start = detail::Clock::now();
+            for (int g = 0; g < referenceGenerations; ++g) {
+                for (int y = 0; y < size; ++y) {
+                    for (int x = 0; x < size; ++x) {
+                        int count = 0;
+                        for (int dy = -1; dy <= 1; ++dy) {
+                            for (int dx = -1; dx <= 1; ++dx) {
+                                const int nx = x + dx, ny = y + dy;
+                                if ((dx || dy) && nx >= 0 && ny >= 0 && nx < size && ny < size)
+                                    count += bytes[static_cast<std::size_t>(ny) * static_cast<std::size_t>(size) + static_cast<std::size_t>(nx)];
+                            }
+                        }
+                        const std::size_t i = static_cast<std::size_t>(y) * static_cast<std::size_t>(size) + static_cast<std::size_t>(x);
+                        next[i] = count == 3 || (bytes[i] && count == 2);
+                    }
+                }
+                bytes.swap(next);
+            }
+            report("bytes", referenceGenerations, detail::elapsed_ms(start));
+
+            for (int y = 0; y < size; ++y) {
+                for (int x = 0; x < size; ++x) {
+                    if (check.get(x, y) != (bytes[static_cast<std::size_t>(y) * static_cast<std::size_t>(size) + static_cast<std::size_t>(x)] != 0)) {
+                        std::cerr << "[ Bench ] life: BitLife differs from the byte-per-cell reference\n";
+                        return 1;
+                    }
+                }
+            }
+        }
+
+        std::uint64_t hashes[2]{};
+        for (int parallel = 0; parallel < 2; ++parallel) {
+            // Reseed from the reference's starting board.
+            BitLife life{};
+            rng = {};
+            for (auto& cell : bytes)
+                cell = rng.next() % 3 == 0;
+            seed(life);
+            life.set_parallel(parallel != 0);
+
+            const auto start = detail::Clock::now();
+            life.step(static_cast<std::uint64_t>(generations));
+            report(parallel ? "bitlife mt" : "bitlife", generations, detail::elapsed_ms(start));
+            hashes[parallel] = life.hash();
+        }
+        if (hashes[0] != hashes[1]) {
+            std::cerr << "[ Bench ] life: parallel BitLife differs from serial\n";
+            return 1;
+        }
+
+        // Acorns grow for ~5000 generations and throw gliders, which
+        // HashLife keeps as a handful of repeating squares.
+        HashLife hash{};
+        constexpr int kAcorn[][2] = { { 1, 0 }, { 3, 1 }, { 0, 2 }, { 1, 2 }, { 4, 2 }, { 5, 2 }, { 6, 2 } };
+        const std::uint32_t extent = static_cast<std::uint32_t>(sparseSize - 8);
+        for (int i = 0; i < 16; ++i) {
+            const std::int64_t ox = static_cast<std::int64_t>(rng.range(0, extent)) - sparseSize / 2;
+            const std::int64_t oy = static_cast<std::int64_t>(rng.range(0, extent)) - sparseSize / 2;
+            for (const auto& cell : kAcorn)
+                hash.set(ox + cell[0], oy + cell[1], true);
+        }
+
+        const std::uint64_t jump = std::uint64_t{ 1 } << 16;
+        const auto start = detail::Clock::now();
+        hash.step(jump);
+        const double ms = detail::elapsed_ms(start);
+        std::cout << std::fixed << std::setprecision(2)
+            << "  " << std::setw(10) << "hashlife"
+            << "  " << (ms > 0.0 ? static_cast<double>(jump) * 1000.0 / ms : 0.0) << " gen/s"
+            << "  " << jump << " generations of 16 acorns over " << sparseSize << "x" << sparseSize
+            << ", population " << hash.population() << ", " << hash.node_count() << " nodes\n";
+        return 0;
+    }
+
+    // Sprite pool allocate/free pairs: a nearly full pool on one thread
+    // against the old round-robin scan, then 1..N threads hammering the
+    // free list, and a check that no slot is ever handed out twice.
+    // Reinitializes the global pool.
+    inline int run_sprite_pool(std::size_t capacity = 65536, std::size_t ops = 1u << 20)
+    {
+        namespace pool = spritepool;
+
+        auto mops = [](std::size_t count, double ms) {
+            return ms > 0.0 ? static_cast<double>(count) / (ms * 1000.0) : 0.0;
+        };
+
+        std::cout << "[ Bench ] sprite_pool: " << capacity << " slots\n";
+
+        // 64 free slots left; each pair allocates one and frees it again.
+        {
+            constexpr std::size_t kFreeSlots = 64;
+            const std::size_t fullOps = ops / 64;
+
+            detail::RoundRobinPool roundRobin(capacity);
+            for (std::size_t i = 0; i + kFreeSlots < capacity; ++i)
+                roundRobin.allocate();
+            auto start = detail::Clock::now();
+            for (std::size_t i = 0; i < fullOps; ++i)
+                roundRobin.free(roundRobin.allocate());
+            const double scanMs = detail::elapsed_ms(start);
+
+            pool::initialize(capacity);
+            for (std::size_t i = 0; i + kFreeSlots < capacity; ++i)
+                pool::allocate();
+            start = detail::Clock::now();
+            for (std::size_t i = 0; i < fullOps; ++i)
+                pool::free(pool::allocate());
+            const double listMs = detail::elapsed_ms(start);
+
+            std::cout << std::fixed << std::setprecision(2)
+                << "  nearly full  round-robin " << mops(fullOps, scanMs) << " Mops/s"
+                << "  free list " << mops(fullOps, listMs) << " Mops/s\n";
+        }
+
+        const std::size_t hw = (std::max)(1u, std::thread::hardware_concurrency());
+        std::vector<std::size_t> threadCounts{ 1, 2, 4 };
+        if (hw > 4)
+            threadCounts.push_back(hw);
+
+        for (const std::size_t threads : threadCounts) {
+            pool::initialize(capacity);
+            const std::size_t perThread = ops / threads;
+            std::vector<std::thread> workers;
+            const auto start = detail::Clock::now();
+            for (std::size_t t = 0; t < threads; ++t) {
+                workers.emplace_back([perThread] {
+                    std::array<SpriteHandle, 8> held{};
+                    for (std::size_t i = 0; i < perThread; i += held.size()) {
+                        for (auto& handle : held)
+                            handle = pool::allocate();
+                        for (const auto& handle : held)
+                            pool::free(handle);
+                    }
+                });
+            }
+            for (auto& worker : workers)
+                worker.join();
+            const double ms = detail::elapsed_ms(start);
+
+            std::cout << std::fixed << std::setprecision(2)
+                << "  " << std::setw(2) << threads << " thread" << (threads == 1 ? " " : "s")
+                << "  " << mops(perThread * threads, ms) << " Mops/s\n";
+        }
+
+        // Every live handle must be unique and the pool must drain back to full.
+        pool::initialize(capacity);
+        std::vector<std::atomic<std::uint8_t>> owned(capacity);
+        std::atomic<bool> duplicate{ false };
+        {
+            std::vector<std::thread> workers;
+            for (std::size_t t = 0; t < 4; ++t) {
+                workers.emplace_back([&] {
+                    std::array<SpriteHandle, 32> held{};
+                    for (int round = 0; round < 2000; ++round) {
+                        for (auto& handle : held) {
+                            handle = pool::allocate();
+                            if (handle.is_valid() && owned[handle.id].exchange(1) != 0)
+                                duplicate = true;
+                        }
+                        for (const auto& handle : held) {
+                            if (!handle.is_valid())
+                                continue;
+                            owned[handle.id].store(0);
+                            pool::free(handle);
+                            pool::free(handle); // stale, must be ignored
+                        }
+                    }
+                });
+            }
+            for (auto& worker : workers)
+                worker.join();
+        }
+
+        std::size_t available = 0;
+        for (SpriteHandle handle = pool::allocate(); handle.is_valid(); handle = pool::allocate())
+            ++available;
+        pool::clear();
+
+        if (duplicate || available != capacity) {
+            std::cerr << "[ Bench ] sprite_pool: " << (duplicate ? "slot handed out twice" : "free list lost slots") << "\n";
+            return 1;
+        }
+        return 0;
+    }
+
+    // Console scrollback: pushing lines through a full ring with layout every
+    // 64 lines, then finding the line at random scroll offsets through the
+    // prefix sums. Checks that scrolling to each line's offset finds it.
+    inline int run_console_scrollback(std::size_t capacity = 65536, std::size_t pushes = 1u << 18)
+    {
+        // One to four wrapped rows; 16.6 is inexact so float offsets round.
+        constexpr auto measure = [](std::string_view text, float, float) noexcept {
+            return 16.6f * static_cast<float>(1 + text.size() % 4);
+        };
+
+        std::cout << "[ Bench ] console_scrollback: " << capacity << " lines, " << pushes << " pushes\n";
+
+        gui::ConsoleScrollback scrollback(capacity);
+        std::string line;
+        auto start = detail::Clock::now();
+        for (std::size_t i = 0; i < pushes; ++i) {
+            line.assign(1 + i % 61, 'x');
+            scrollback.push(line);
+            if (i % 64 == 63)
+                scrollback.update_layout(800.0f, 1.0f, nullptr, measure, 600.0f);
+        }
+        scrollback.update_layout(800.0f, 1.0f, nullptr, measure, 600.0f);
+        const double pushMs = detail::elapsed_ms(start);
+
+        constexpr std::size_t kLookups = 1u << 20;
+        const float height = scrollback.content_height();
+        detail::Lcg rng{};
+        std::size_t checksum = 0;
+        start = detail::Clock::now();
+        for (std::size_t i = 0; i < kLookups; ++i)
+            checksum += scrollback.line_at(height * (static_cast<float>(rng.next()) / 16777216.0f));
+        const double lookupMs = detail::elapsed_ms(start);
+
+        std::cout << std::fixed << std::setprecision(2)
+            << "  push+layout " << pushMs << " ms"
+            << "  line_at " << (lookupMs * 1.0e6 / kLookups) << " ns"
+            << "  content " << height << " px  (checksum " << checksum << ")\n";
+
+        std::size_t wrong = 0;
+        for (std::size_t i = 0; i < scrollback.size(); ++i) {
+            scrollback.scroll_to_line(i);
+            const float middle = 0.5f * (scrollback.line_top(i) + scrollback.line_top(i + 1));
+            if (scrollback.line_at(scrollback.scroll_offset()) != i || scrollback.line_at(middle) != i)
+                ++wrong;
+        }
+        if (wrong != 0) {
+            std::cerr << "[ Bench ] console_scrollback: " << wrong << " lines not found at their scroll offset\n";
+            return 1;
+        }
+        return 0;
+    }
+
+    inline int run(std::string_view name)
+    {
+        if (name == "atlas_packers")
+            return run_atlas_packers();
+        if (name == "sprite_blit")
+            return run_sprite_blit();
+        if (name == "sandsim")
+            return run_sandsim();
+        if (name == "life")
+            return run_life();
+        if (name == "sprite_pool")
+            return run_sprite_pool();
+        if (name == "console_scrollback")
+            return run_console_scrollback();
+        if (name == "mipmaps")
+            return run_mipmaps();
+#if defined(ALMOND_USING_SOFTWARE_RENDERER)
+        if (name == "triangles")
+            return run_triangles();
+        if (name == "headless")
+            return run_headless();
+        if (name == "tilemap")
+            return run_tilemap();
+#endif
+
+        std::cerr << "[ Bench ] Unknown benchmark '" << name << "'. Available: atlas_packers, sprite_blit, sandsim, life, sprite_pool, console_scrollback, mipmaps"
+#if defined(ALMOND_USING_SOFTWARE_RENDERER)
+            << ", triangles, headless, tilemap"
+#endif
+            << "\n";
+        return 1;
+    }
+}
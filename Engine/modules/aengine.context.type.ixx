@@ -19,6 +19,7 @@ export namespace almondnamespace::core
         DirectX,
         Software,
         Custom,
-        Noop
+        Noop,
+        SoftwareHeadless
     };
 }
\ No newline at end of file
@@ -7,6 +7,7 @@ export module aengine.core.commandline;
 import <algorithm>;
 import <filesystem>;
 import <iostream>;
+import <string>;
 import <string_view>;
 
 //import aengine;
@@ -25,12 +26,16 @@ export namespace almondnamespace::core::cli
     inline bool trace_menu_button0_rect = true;
     inline bool trace_raylib_design_metrics = false;
     inline bool run_menu_loop = false;
+    inline int  bench_frames = 0;                  // 0 = benchmark default
+    inline std::filesystem::path frame_dump_dir;   // headless frame dumps
+    inline std::string expected_frame_hash;        // hex; headless bench fails on mismatch
     inline std::filesystem::path exe_path;
 
     struct ParseResult {
         bool update_requested = false;
         bool force_update = false;
         bool editor_requested = false;
+        std::string benchmark{};
     };
 
     inline void print_engine_info() {
@@ -66,6 +71,10 @@ export namespace almondnamespace::core::cli
                     "  --trace-raylib-design Log framebuffer vs design canvas dimensions\n"
                     "  --editor              Start the editor interface\n"
                     "  --menu                Start the menu + games loop\n"
+                    "  --bench <name>        Run a headless benchmark and exit\n"
+                    "  --frames <n>          Frames to render in frame-based benchmarks\n"
+                    "  --dump-frames <dir>   Write headless benchmark frames to <dir>\n"
+                    "  --expect-hash <hex>   Fail the headless benchmark on a different frame hash\n"
                     "  --update, -u          Check for a newer AlmondShell build\n"
                     "  --force               Apply the available update immediately\n";
             }
@@ -98,6 +107,18 @@ export namespace almondnamespace::core::cli
             else if (arg == "--menu"sv) {
                 run_menu_loop = true;
             }
+            else if (arg == "--bench"sv && i + 1 < argc) {
+                result.benchmark = argv[++i];
+            }
+            else if (arg == "--frames"sv && i + 1 < argc) {
+                bench_frames = (std::max)(0, std::stoi(argv[++i]));
+            }
+            else if (arg == "--dump-frames"sv && i + 1 < argc) {
+                frame_dump_dir = argv[++i];
+            }
+            else if (arg == "--expect-hash"sv && i + 1 < argc) {
+                expected_frame_hash = argv[++i];
+            }
             else if (arg == "--force"sv) {
                 result.force_update = true;
             }
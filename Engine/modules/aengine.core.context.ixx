@@ -46,6 +46,7 @@ import aengine.input;
 import aatlas.texture;
 import aatlas.manager;   // reacquire atlas vector inside queued draw
 import aspritehandle;
+import aspritetable;    // TileGrid, kNoTile
 import aimage.loader;
 import acontext.raylib.api; // for ImageData
 
@@ -125,6 +126,12 @@ export namespace almondnamespace::core
             std::span<const TextureAtlas* const>,
             float, float, float, float);
 
+        // palette[cell] is drawn for each cell of a cols x rows map;
+        // cells without a valid palette entry are skipped.
+        using DrawTilemapFunc = void(*)(std::span<const SpriteHandle>,
+            std::span<const std::uint16_t>, int, int, const TileGrid&,
+            std::span<const TextureAtlas* const>);
+
         using AddTextureFunc = std::uint32_t(*)(TextureAtlas&, std::string, const ImageData&);
         using AddAtlasFunc = std::uint32_t(*)(const TextureAtlas&);
         using AddModelFunc = int(*)(const char*, const char*);
@@ -300,6 +307,51 @@ export namespace almondnamespace::core
                 }, renderPath);
         }
 
+        // Draws a whole board in one call: `cells` is row-major, `cols` x `rows`,
+        // each value an index into `palette` (kNoTile or a dead entry = empty).
+        // Backends without draw_tilemap get one draw_sprite per cell.
+        void draw_tilemap_safe(
+            std::span<const SpriteHandle> palette,
+            std::span<const std::uint16_t> cells,
+            int cols, int rows,
+            const TileGrid& grid,
+            std::span<const TextureAtlas* const> atlases) const noexcept
+        {
+            if (!draw_tilemap && !draw_sprite) return;
+            if (cols <= 0 || rows <= 0 || cells.size() < std::size_t(cols) * std::size_t(rows)) return;
+            cells = cells.first(std::size_t(cols) * std::size_t(rows));
+
+            if (auto cur = core::get_current_render_context(); cur && cur.get() == this)
+            {
+                draw_tilemap_now(palette, cells, cols, rows, grid, atlases);
+                return;
+            }
+
+            if (!windowData) return;
+
+            const core::RenderPath renderPath =
+                (type == core::ContextType::OpenGL) ? core::RenderPath::OpenGL
+                : (type == core::ContextType::SFML) ? core::RenderPath::SFML
+                : (type == core::ContextType::Vulkan) ? core::RenderPath::Vulkan
+                : core::RenderPath::Unknown;
+
+            std::weak_ptr<Context> weak = windowData->context;
+
+            // One queued command per board; the cells and palette are copied.
+            windowData->commandQueue.enqueue([weak,
+                palette = std::vector<SpriteHandle>(palette.begin(), palette.end()),
+                cells = std::vector<std::uint16_t>(cells.begin(), cells.end()),
+                cols, rows, grid]()
+                {
+                    auto self = weak.lock();
+                    if (!self) return;
+
+                    auto av = almondnamespace::atlasmanager::get_atlas_vector_snapshot();
+                    std::span<const TextureAtlas* const> span(av.data(), av.size());
+                    self->draw_tilemap_now(palette, cells, cols, rows, grid, span);
+                }, renderPath);
+        }
+
         std::uint32_t add_texture_safe(TextureAtlas& atlas,
             std::string name,
             const ImageData& img) const noexcept
@@ -319,6 +371,36 @@ export namespace almondnamespace::core
             return add_model ? add_model(name, path) : -1;
         }
 
+        // Render thread only.
+        void draw_tilemap_now(
+            std::span<const SpriteHandle> palette,
+            std::span<const std::uint16_t> cells,
+            int cols, int rows,
+            const TileGrid& grid,
+            std::span<const TextureAtlas* const> atlases) const noexcept
+        {
+            if (draw_tilemap)
+            {
+                draw_tilemap(palette, cells, cols, rows, grid, atlases);
+                return;
+            }
+            if (!draw_sprite) return;
+
+            for (int row = 0; row < rows; ++row)
+            {
+                for (int col = 0; col < cols; ++col)
+                {
+                    const std::uint16_t cell = cells[std::size_t(row) * std::size_t(cols) + std::size_t(col)];
+                    if (cell >= palette.size() || !palette[cell].is_valid()) continue;
+
+                    draw_sprite(palette[cell], atlases,
+                        grid.x + grid.cellWidth * float(col),
+                        grid.y + grid.cellHeight * float(row),
+                        grid.cellWidth, grid.cellHeight);
+                }
+            }
+        }
+
 #if defined(_WIN32) && !defined(ALMOND_MAIN_HEADLESS)
         HWND  get_hwnd()  const noexcept { return hwnd; }
         HDC   get_hdc()   const noexcept { return hdc; }
@@ -365,6 +447,7 @@ export namespace almondnamespace::core
         GetHeightFunc   get_height = nullptr;
         RegistryGetFunc registry_get = nullptr;
         DrawSpriteFunc  draw_sprite = nullptr;
+        DrawTilemapFunc draw_tilemap = nullptr;  // optional, see draw_tilemap_safe()
         AddModelFunc    add_model = nullptr;
 
         // Input hooks
@@ -183,6 +183,7 @@ export namespace almond::diagnostics {
         case ContextType::Software: return "Software";
         case ContextType::Custom:   return "Custom";
         case ContextType::Noop:     return "Noop";
+        case ContextType::SoftwareHeadless: return "SoftwareHeadless";
         case ContextType::None:
         default:
             return "None";
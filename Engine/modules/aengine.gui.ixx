@@ -54,6 +54,62 @@ export namespace almondnamespace::gui
         bool submitted = false;
     };
 
+    // Console history for console_window(): a ring of the newest `capacity`
+    // lines plus the running height before each one, so a frame lays out only
+    // the lines in view and the line at a scroll offset is a binary search.
+    // It follows the newest line until scroll_to() or scroll_to_line().
+    class ConsoleScrollback
+    {
+    public:
+        using LineMeasure = float (*)(std::string_view text, float width, float scale);
+
+        explicit ConsoleScrollback(std::size_t capacity = 65536);
+
+        void push(std::string line);
+        void clear() noexcept;
+
+        [[nodiscard]] std::size_t size() const noexcept { return count_; }
+        [[nodiscard]] std::size_t capacity() const noexcept { return capacity_; }
+
+        // 0 is the oldest line still held.
+        [[nodiscard]] const std::string& line(std::size_t index) const noexcept { return lines_[slot(index)]; }
+
+        // Heights and offsets cover the lines console_window() has laid out.
+        [[nodiscard]] std::size_t measured() const noexcept { return count_ - unmeasured_; }
+        [[nodiscard]] float content_height() const noexcept;
+        [[nodiscard]] float line_top(std::size_t index) const noexcept;
+        [[nodiscard]] std::size_t line_at(float offset) const noexcept;
+
+        [[nodiscard]] float scroll_offset() const noexcept { return offset_; }
+        [[nodiscard]] bool following() const noexcept { return follow_; }
+        void scroll_to(float offset) noexcept;
+        void scroll_to_line(std::size_t index) noexcept;
+        void scroll_to_end() noexcept;
+
+        // For console_window(): measures the lines pushed since the last call,
+        // or every line when the width, scale or font changed, then clamps the
+        // scroll offset to a view `view_height` tall.
+        void update_layout(float width, float scale, const void* font, LineMeasure measure, float view_height);
+
+    private:
+        [[nodiscard]] std::size_t slot(std::size_t index) const noexcept { return (head_ + index) % capacity_; }
+
+        std::size_t capacity_ = 1;
+        std::vector<std::string> lines_{};
+        std::vector<double> tops_{};   // running height before each line, in the slots of lines_
+        std::size_t head_ = 0;         // slot of the oldest line
+        std::size_t count_ = 0;
+        std::size_t unmeasured_ = 0;   // newest lines not laid out yet
+        double end_ = 0.0;             // running height after the newest measured line
+
+        float layoutWidth_ = -1.0f;
+        float layoutScale_ = 0.0f;
+        const void* layoutFont_ = nullptr;
+
+        float offset_ = 0.0f;
+        bool follow_ = true;
+    };
+
     struct ConsoleWindowOptions
     {
         std::string_view title{};
@@ -64,6 +120,9 @@ export namespace almondnamespace::gui
         std::span<const std::string> lines{};
         std::size_t max_visible_lines = 64;
 
+        // Used instead of `lines` when set; drawn from its scroll offset.
+        ConsoleScrollback* scrollback = nullptr;
+
         // Input
         std::string* input = nullptr;      // optional (legacy)
         std::size_t max_input_chars = 1024;
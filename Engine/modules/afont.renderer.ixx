@@ -34,9 +34,15 @@ module;
 
 export module afont.renderer;
 
+import <algorithm>;
+import <atomic>;
 import <string>;
 import <unordered_map>;
 import <cstdint>;
+import <memory>;
+import <mutex>;
+import <optional>;
+import <span>;
 import <vector>;
 
 import aspritehandle;
@@ -73,15 +79,154 @@ export namespace almondnamespace::font
         SpriteHandle handle{};
     };
 
+    // One kerned pair; FontAsset keeps them sorted by key.
+    export struct KerningPair
+    {
+        std::uint64_t key{}; // left codepoint << 32 | right codepoint
+        float advance{};
+    };
+
+    // Bitmap: coverage rasterised at the font's size, drawn texel for pixel.
+    // DistanceField: a signed distance field baked once at a fixed height
+    // (GlyphCache::kDistanceFieldHeight); the atlas carries sdf_scale and the
+    // backends turn it into a sharp edge at any draw size.
+    export enum class GlyphBake : std::uint8_t
+    {
+        Bitmap,
+        DistanceField
+    };
+
+    // Glyphs rasterised on first use into a single atlas page. The page is
+    // packed in shelves (rows of glyphs of similar height); once it is full
+    // the least recently used shelf is evicted whole, its atlas entries are
+    // reused and generation() is bumped. Shelves used in the current frame
+    // (see begin_frame()) are never evicted. Any thread may call in: stb state
+    // is behind the cache mutex, texels go through the atlas lock and reach
+    // the backends as dirty-rect uploads.
+    export class GlyphCache
+    {
+    public:
+        static constexpr std::uint32_t kDefaultPageSize = 1024;
+        static constexpr float kDistanceFieldHeight = 48.0f;
+
+        GlyphCache();
+        ~GlyphCache();
+        GlyphCache(const GlyphCache&) = delete;
+        GlyphCache& operator=(const GlyphCache&) = delete;
+
+        // Takes the font file bytes. Glyphs are `pixel_height` tall and live in
+        // atlas `atlas_name`, created if missing; entries left there by an
+        // earlier cache are recycled.
+        bool init(std::vector<unsigned char> font_data,
+            float pixel_height,
+            const std::string& atlas_name,
+            GlyphBake bake = GlyphBake::Bitmap,
+            std::uint32_t page_size = kDefaultPageSize);
+
+        // nullopt when the font has no glyph for `codepoint`, it cannot fit
+        // the page at all, or every shelf it could use is pinned this frame.
+        [[nodiscard]] std::optional<Glyph> find(char32_t codepoint);
+
+        // Starts a frame. Until the next call, shelves holding `in_use` or any
+        // glyph find() returns are pinned, so glyph copies a frame draws from
+        // stay valid for the whole frame. Glyphs turned away because the page
+        // was full of pinned shelves bump generation() here so callers retry
+        // them. A cache nobody calls this on evicts by plain LRU.
+        void begin_frame(std::span<const char32_t> in_use = {});
+
+        [[nodiscard]] std::uint64_t generation() const noexcept
+        {
+            return generation_.load(std::memory_order_acquire);
+        }
+
+        [[nodiscard]] std::size_t resident_count() const;
+        [[nodiscard]] int atlas_index() const noexcept;
+        [[nodiscard]] GlyphBake bake() const noexcept { return bake_; }
+
+    private:
+        struct Source; // stb font state, kept out of the interface
+
+        static constexpr std::uint32_t kNoShelf = ~0u;
+
+        struct Slot
+        {
+            Glyph glyph{};
+            std::uint32_t shelf = kNoShelf; // kNoShelf: blank or missing, never evicted
+            int entry = -1;
+            bool present = false;
+            bool deferred = false; // no unpinned room this frame; not cached
+        };
+
+        struct Shelf
+        {
+            std::uint32_t y = 0;
+            std::uint32_t height = 0;
+            std::uint32_t cursor = 0;
+            std::uint64_t last_use = 0;
+            std::uint64_t frame = 0; // last frame a glyph here was handed out
+            std::vector<char32_t> codepoints{};
+        };
+
+        bool rasterise_locked(char32_t codepoint, Slot& slot);
+        std::uint32_t reserve_locked(std::uint32_t cell_w, std::uint32_t cell_h, std::uint32_t& out_x, bool& out_pinned);
+        void evict_locked(std::uint32_t shelf);
+
+        std::unique_ptr<Source> source_;
+        TextureAtlas* atlas_ = nullptr;
+        std::string atlas_name_;
+        std::uint32_t page_size_ = 0;
+        GlyphBake bake_ = GlyphBake::Bitmap;
+        std::unordered_map<char32_t, Slot> slots_;
+        std::vector<Shelf> shelves_;
+        std::uint32_t next_shelf_y_ = 0;
+        std::vector<int> free_entries_;
+        std::uint64_t clock_ = 0;
+        std::uint64_t frame_ = 0;      // 0: begin_frame() never called, nothing pinned
+        std::uint64_t full_frame_ = 0; // last frame a glyph was deferred
+        std::atomic<std::uint64_t> generation_{ 0 };
+        mutable std::mutex mutex_;
+    };
+
     export struct FontAsset
     {
         std::string name;
         std::string path;
         float size_pt{};
-        std::unordered_map<char32_t, Glyph> glyphs{};
+        std::shared_ptr<GlyphCache> glyph_cache{};
+        float glyph_scale = 1.0f; // cache pixels to font pixels; != 1 for shared distance-field caches
         int atlas_index = -1;
         FontMetrics metrics{};
-        std::unordered_map<std::uint64_t, float> kerning_pairs{};
+        std::vector<KerningPair> kerning_pairs{}; // sorted by key
+
+        // Rasterises the glyph on first use; see GlyphCache::find().
+        [[nodiscard]] std::optional<Glyph> find_glyph(char32_t codepoint) const
+        {
+            if (!glyph_cache)
+                return std::nullopt;
+
+            auto glyph = glyph_cache->find(codepoint);
+            if (glyph && glyph_scale != 1.0f)
+            {
+                glyph->size_px = { glyph->size_px.x * glyph_scale, glyph->size_px.y * glyph_scale };
+                glyph->offset_px = { glyph->offset_px.x * glyph_scale, glyph->offset_px.y * glyph_scale };
+                glyph->advance *= glyph_scale;
+            }
+            return glyph;
+        }
+
+        // Glyph copies taken under an older generation may point at atlas
+        // space that has since been given to another glyph.
+        [[nodiscard]] std::uint64_t glyph_generation() const noexcept
+        {
+            return glyph_cache ? glyph_cache->generation() : 0;
+        }
+
+        // See GlyphCache::begin_frame().
+        void begin_glyph_frame(std::span<const char32_t> in_use = {}) const
+        {
+            if (glyph_cache)
+                glyph_cache->begin_frame(in_use);
+        }
 
         [[nodiscard]] float get_kerning(char32_t left, char32_t right) const noexcept
         {
@@ -90,10 +235,11 @@ export namespace almondnamespace::font
 
             const std::uint64_t key = (static_cast<std::uint64_t>(left) << 32)
                 | static_cast<std::uint64_t>(right);
-            const auto it = kerning_pairs.find(key);
-            if (it == kerning_pairs.end())
+            const auto it = std::lower_bound(kerning_pairs.begin(), kerning_pairs.end(), key,
+                [](const KerningPair& pair, std::uint64_t k) { return pair.key < k; });
+            if (it == kerning_pairs.end() || it->key != key)
                 return 0.0f;
-            return it->second;
+            return it->advance;
         }
     };
 
@@ -102,9 +248,12 @@ export namespace almondnamespace::font
     public:
         explicit FontRenderer(logger::Logger* log = nullptr);
 
+        // DistanceField fonts from the same file share one glyph cache and
+        // atlas whatever their size.
         bool load_font(const std::string& name,
             const std::string& path,
-            float size_pt);
+            float size_pt,
+            GlyphBake bake = GlyphBake::Bitmap);
 
         [[nodiscard]] const FontAsset* get_font(const std::string& name) const noexcept;
 
@@ -117,23 +266,14 @@ export namespace almondnamespace::font
         void unload_font(const std::string& name);
 
     private:
-        struct BakedGlyph
-        {
-            Glyph glyph{};
-            int x0 = 0;
-            int y0 = 0;
-            int x1 = 0;
-            int y1 = 0;
-        };
-
-        bool load_and_bake_font(const std::string& ttf_path,
+        bool load_font_metrics(const std::vector<unsigned char>& font_data,
+            const std::string& ttf_path,
             float size_pt,
-            std::vector<std::pair<char32_t, BakedGlyph>>& out_glyphs,
             FontMetrics& out_metrics,
-            std::unordered_map<std::uint64_t, float>& out_kerning,
-            Texture& out_texture);
+            std::vector<KerningPair>& out_kerning);
 
         logger::Logger* logger_{};
         std::unordered_map<std::string, FontAsset> loaded_fonts_;
+        std::unordered_map<std::string, std::shared_ptr<GlyphCache>> distance_field_caches_; // by font path
     };
 }
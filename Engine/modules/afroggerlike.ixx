@@ -7,15 +7,18 @@ import aengine.core.context;      // core::Context
 import aengine.context.window;    // core::WindowData
 import aengine.input;             // input::Key
 import aatlas.manager;            // atlasmanager
+import aatlas.cache;              // atlascache::asset_paths
 import aimage.loader;             // a_loadImage
 import aspritehandle;             // SpriteHandle
 import asprite.pool;              // spritepool
+import aspritetable;              // SpriteTable
 import ascene;                    // scene::Scene
 import aengine.core.logger;       // logger::Logger
 import aengine.core.time;         // timing::Timer
 
 // C++ std
 import <algorithm>;
+import <array>;
 import <cmath>;
 import <cstdint>;
 import <span>;
@@ -23,7 +26,6 @@ import <stdexcept>;
 import <string>;
 import <string_view>;
 import <tuple>;
-import <unordered_map>;
 import <utility>;
 import <vector>;
 
@@ -54,9 +56,9 @@ export namespace almondnamespace::froggerlike
             auto atlasVec = atlasmanager::get_atlas_vector_snapshot(); // by value
             std::span<const TextureAtlas* const> atlasSpan(atlasVec.data(), atlasVec.size());
 
-            if (auto it = sprites.find("bg"); it != sprites.end() && spritepool::is_alive(it->second))
+            if (const SpriteHandle background = sprites.live(SpriteBg); background.is_valid())
             {
-                ctx->draw_sprite_safe(it->second, atlasSpan, 0.0f, 0.0f,
+                ctx->draw_sprite_safe(background, atlasSpan, 0.0f, 0.0f,
                     float(ctx->get_width_safe()), float(ctx->get_height_safe()));
             }
 
@@ -65,28 +67,28 @@ export namespace almondnamespace::froggerlike
             const float laneHeight = height / 5.0f;
             const float spriteSize = (std::min)(width / 6.0f, laneHeight);
 
-            auto drawRow = [&](std::string_view name, int lane, int count, float offset)
+            auto drawRow = [&](SpriteId id, int lane, int count, float offset)
                 {
-                    auto it = sprites.find(std::string(name));
-                    if (it == sprites.end() || !spritepool::is_alive(it->second))
+                    const SpriteHandle sprite = sprites.live(id);
+                    if (!sprite.is_valid())
                         return;
 
                     const float y = laneHeight * lane + (laneHeight - spriteSize) * 0.5f;
                     for (int i = 0; i < count; ++i)
                     {
                         const float x = std::fmod(offset + i * (spriteSize * 1.5f), width);
-                        ctx->draw_sprite_safe(it->second, atlasSpan, x, y, spriteSize, spriteSize);
+                        ctx->draw_sprite_safe(sprite, atlasSpan, x, y, spriteSize, spriteSize);
                     }
                 };
 
-            drawRow("water", 0, 3, 0.0f);
-            drawRow("log", 1, 3, spriteSize * 0.5f);
-            drawRow("car", 3, 3, spriteSize);
+            drawRow(SpriteWater, 0, 3, 0.0f);
+            drawRow(SpriteLog, 1, 3, spriteSize * 0.5f);
+            drawRow(SpriteCar, 3, 3, spriteSize);
 
-            if (auto it = sprites.find("frog"); it != sprites.end() && spritepool::is_alive(it->second))
+            if (const SpriteHandle frog = sprites.live(SpriteFrog); frog.is_valid())
             {
                 const float frogY = laneHeight * 4 + (laneHeight - spriteSize) * 0.5f;
-                ctx->draw_sprite_safe(it->second, atlasSpan, (width - spriteSize) * 0.5f, frogY, spriteSize, spriteSize);
+                ctx->draw_sprite_safe(frog, atlasSpan, (width - spriteSize) * 0.5f, frogY, spriteSize, spriteSize);
             }
 
             ctx->present_safe();
@@ -115,9 +117,12 @@ export namespace almondnamespace::froggerlike
                 throw std::runtime_error("[FroggerLike] Missing atlas registrar");
 
             TextureAtlas& atlas = registrar->atlas;
+
+            static constexpr std::array<std::string_view, 5> kSpriteIds{ "bg", "frog", "car", "log", "water" };
+
             bool registered = false;
 
-            auto ensureSprite = [&](std::string_view id)
+            auto ensureSprite = [&](std::size_t index, std::string_view id)
             {
                 std::string name(id);
 
@@ -126,7 +131,7 @@ export namespace almondnamespace::froggerlike
                     auto handle = std::get<0>(*existing);
                     if (spritepool::is_alive(handle))
                     {
-                        sprites[name] = handle;
+                        sprites.set(index, handle);
                         return;
                     }
                 }
@@ -140,17 +145,18 @@ export namespace almondnamespace::froggerlike
 
                 if (handleOpt && spritepool::is_alive(*handleOpt))
                 {
-                    sprites[name] = *handleOpt;
+                    sprites.set(index, *handleOpt);
                     registered = true;
                 }
             };
 
-            // Always try to load a background sprite if available
-            ensureSprite("bg");
-            ensureSprite("frog");
-            ensureSprite("car");
-            ensureSprite("log");
-            ensureSprite("water");
+            atlasmanager::load_or_bake_atlas(atlas.name,
+                atlascache::asset_paths("assets/games/afroggerlike/", kSpriteIds), [&]
+                {
+                    // Always try to load a background sprite if available
+                    for (std::size_t i = 0; i < kSpriteIds.size(); ++i)
+                        ensureSprite(i, kSpriteIds[i]);
+                });
 
             if (createdAtlas || registered)
             {
@@ -159,7 +165,10 @@ export namespace almondnamespace::froggerlike
             }
         }
 
-        std::unordered_map<std::string, SpriteHandle> sprites{};
+        // Positions in kSpriteIds (setupSprites()).
+        enum SpriteId : std::uint16_t { SpriteBg, SpriteFrog, SpriteCar, SpriteLog, SpriteWater };
+
+        SpriteTable sprites{};
     };
 
     export bool run_froggerlike(std::shared_ptr<core::Context> ctx)
@@ -7,9 +7,11 @@ import aengine.core.context;      // core::Context
 import aengine.context.window;    // core::WindowData
 import aengine.input;             // input::Key
 import aatlas.manager;            // atlasmanager
+import aatlas.cache;              // atlascache::asset_paths
 import aimage.loader;             // a_loadImage
 import aspritehandle;             // SpriteHandle
 import asprite.pool;              // spritepool
+import aspritetable;              // SpriteTable, TileGrid
 import ascene;                    // scene::Scene
 import aengine.core.logger;       // logger::Logger
 import aengine.core.time;         // timing::Timer
@@ -23,7 +25,6 @@ import <stdexcept>;
 import <string>;
 import <string_view>;
 import <tuple>;
-import <unordered_map>;
 import <utility>;
 import <vector>;
 
@@ -55,9 +56,9 @@ export namespace almondnamespace::match3like
             auto atlasVec = atlasmanager::get_atlas_vector_snapshot(); // by value
             std::span<const TextureAtlas* const> atlasSpan(atlasVec.data(), atlasVec.size());
 
-            if (auto it = sprites.find("bg"); it != sprites.end() && spritepool::is_alive(it->second))
+            if (const SpriteHandle background = sprites.live(SpriteBg); background.is_valid())
             {
-                ctx->draw_sprite_safe(it->second, atlasSpan, 0.0f, 0.0f,
+                ctx->draw_sprite_safe(background, atlasSpan, 0.0f, 0.0f,
                     float(ctx->get_width_safe()), float(ctx->get_height_safe()));
             }
 
@@ -66,29 +67,18 @@ export namespace almondnamespace::match3like
             const float cellSize = std::min(width / float(kCols), height / float(kRows));
             const float offsetX = (width - cellSize * float(kCols)) * 0.5f;
             const float offsetY = (height - cellSize * float(kRows)) * 0.5f;
-            constexpr std::array<std::string_view, 6> gemNames = {
-                "gem0", "gem1", "gem2", "gem3", "gem4", "gem5"
-            };
 
-            for (int row = 0; row < kRows; ++row)
+            for (std::size_t i = 0; i < grid.size(); ++i)
             {
-                for (int col = 0; col < kCols; ++col)
-                {
-                    const int gemIndex = grid[static_cast<size_t>(row * kCols + col)];
-                    if (gemIndex < 0 || gemIndex >= static_cast<int>(gemNames.size()))
-                        continue;
-
-                    auto it = sprites.find(std::string(gemNames[static_cast<size_t>(gemIndex)]));
-                    if (it == sprites.end() || !spritepool::is_alive(it->second))
-                        continue;
-
-                    ctx->draw_sprite_safe(it->second, atlasSpan,
-                        offsetX + cellSize * float(col),
-                        offsetY + cellSize * float(row),
-                        cellSize, cellSize);
-                }
+                const int gemIndex = grid[i];
+                cells[i] = (gemIndex >= 0 && gemIndex < kGemKinds)
+                    ? static_cast<std::uint16_t>(SpriteGem0 + gemIndex)
+                    : kNoTile;
             }
 
+            ctx->draw_tilemap_safe(sprites.palette(), cells, kCols, kRows,
+                { offsetX, offsetY, cellSize, cellSize }, atlasSpan);
+
             ctx->present_safe();
             return true;
         }
@@ -115,9 +105,12 @@ export namespace almondnamespace::match3like
                 throw std::runtime_error("[Match3Like] Missing atlas registrar");
 
             TextureAtlas& atlas = registrar->atlas;
+
+            static constexpr std::array<std::string_view, 7> kSpriteIds{ "bg", "gem0", "gem1", "gem2", "gem3", "gem4", "gem5" };
+
             bool registered = false;
 
-            auto ensureSprite = [&](std::string_view id)
+            auto ensureSprite = [&](std::size_t index, std::string_view id)
             {
                 std::string name(id);
 
@@ -126,7 +119,7 @@ export namespace almondnamespace::match3like
                     auto handle = std::get<0>(*existing);
                     if (spritepool::is_alive(handle))
                     {
-                        sprites[name] = handle;
+                        sprites.set(index, handle);
                         return;
                     }
                 }
@@ -140,19 +133,18 @@ export namespace almondnamespace::match3like
 
                 if (handleOpt && spritepool::is_alive(*handleOpt))
                 {
-                    sprites[name] = *handleOpt;
+                    sprites.set(index, *handleOpt);
                     registered = true;
                 }
             };
 
-            // Always try to load a background sprite if available
-            ensureSprite("bg");
-            ensureSprite("gem0");
-            ensureSprite("gem1");
-            ensureSprite("gem2");
-            ensureSprite("gem3");
-            ensureSprite("gem4");
-            ensureSprite("gem5");
+            atlasmanager::load_or_bake_atlas(atlas.name,
+                atlascache::asset_paths("assets/games/amatch3like/", kSpriteIds), [&]
+                {
+                    // Always try to load a background sprite if available
+                    for (std::size_t i = 0; i < kSpriteIds.size(); ++i)
+                        ensureSprite(i, kSpriteIds[i]);
+                });
 
             if (createdAtlas || registered)
             {
@@ -161,14 +153,20 @@ export namespace almondnamespace::match3like
             }
         }
 
-        std::unordered_map<std::string, SpriteHandle> sprites{};
+        // Positions in kSpriteIds (setupSprites()), which are also the tile-map cell values.
+        enum SpriteId : std::uint16_t { SpriteBg, SpriteGem0 };  // gem n is SpriteGem0 + n
+
+        SpriteTable sprites{};
         static constexpr int kRows = 8;
         static constexpr int kCols = 8;
+        static constexpr int kGemKinds = 6;
         std::vector<int> grid{};
+        std::vector<std::uint16_t> cells{};
 
         void initializeGrid()
         {
             grid.resize(static_cast<size_t>(kRows * kCols));
+            cells.resize(grid.size());
             for (int row = 0; row < kRows; ++row)
             {
                 for (int col = 0; col < kCols; ++col)
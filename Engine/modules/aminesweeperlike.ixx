@@ -11,9 +11,11 @@ import aengine.context.window;    // WindowData
 import aengine.input;             // input
 import agamecore;                 // grid helpers
 import aatlas.manager;            // atlas manager
+import aatlas.cache;              // atlascache::asset_paths
 import aimage.loader;             // a_loadImage / ImageData
 import aspritehandle;             // SpriteHandle
 import asprite.pool;              // spritepool
+import aspritetable;              // SpriteTable, TileGrid
 import ascene;                    // scene::Scene
 
 // ------------------------------------------------------------
@@ -26,6 +28,7 @@ import aengine.core.logger;
 // C++ standard library modules
 // ------------------------------------------------------------
 import <algorithm>;
+import <array>;
 import <chrono>;
 import <cstddef>;
 import <cstdint>;
@@ -35,7 +38,6 @@ import <stdexcept>;
 import <string>;
 import <string_view>;
 import <tuple>;
-import <unordered_map>;
 import <utility>;
 import <vector>;
 
@@ -155,24 +157,17 @@ export namespace almondnamespace::minesweeperlike
             auto atlasVec = atlasmanager::get_atlas_vector_snapshot(); // by value
             std::span<const TextureAtlas* const> atlasSpan(atlasVec.data(), atlasVec.size());
 
-            for (int y = 0; y < GRID_H; ++y)
+            // Revealed cells show their count (sprites "0".."8") or a mine.
+            for (std::size_t idx = 0; idx < cells.size(); ++idx)
             {
-                for (int x = 0; x < GRID_W; ++x)
-                {
-                    const size_t idx = gamecore::idx(GRID_W, x, y);
-                    const std::string key = !state.revealed[idx]
-                        ? "covered"
-                        : (state.mine[idx] ? "mine" : std::to_string(state.count[idx]));
-
-                    auto it = sprites.find(key);
-                    if (it != sprites.end() && spritepool::is_alive(it->second))
-                    {
-                        ctx->draw_sprite_safe(it->second, atlasSpan,
-                            x * cellW, y * cellH, cellW, cellH);
-                    }
-                }
+                cells[idx] = !state.revealed[idx] ? SpriteCovered
+                    : state.mine[idx] ? SpriteMine
+                    : static_cast<std::uint16_t>(SpriteCount0 + state.count[idx]);
             }
 
+            ctx->draw_tilemap_safe(sprites.palette(), cells, GRID_W, GRID_H,
+                { 0.0f, 0.0f, cellW, cellH }, atlasSpan);
+
             ctx->present_safe();
 
             if (gameOver) return false;
@@ -205,9 +200,13 @@ export namespace almondnamespace::minesweeperlike
                 throw std::runtime_error("[Minesweeper] Missing atlas registrar");
 
             TextureAtlas& atlas = registrar->atlas;
+
+            static constexpr std::array<std::string_view, 11> kSpriteIds{
+                "0", "1", "2", "3", "4", "5", "6", "7", "8", "covered", "mine" };
+
             bool registeredSprite = false;
 
-            auto ensureSprite = [&](std::string_view id)
+            auto ensureSprite = [&](std::size_t index, std::string_view id)
             {
                 std::string name(id);
 
@@ -216,7 +215,7 @@ export namespace almondnamespace::minesweeperlike
                     auto handle = std::get<0>(*existing);
                     if (spritepool::is_alive(handle))
                     {
-                        sprites[name] = handle;
+                        sprites.set(index, handle);
                         return;
                     }
                 }
@@ -231,15 +230,16 @@ export namespace almondnamespace::minesweeperlike
                 if (!handleOpt || !spritepool::is_alive(*handleOpt))
                     throw std::runtime_error("[Minesweeper] Failed to register sprite " + name);
 
-                sprites[name] = *handleOpt;
+                sprites.set(index, *handleOpt);
                 registeredSprite = true;
             };
 
-            for (int i = 0; i <= 8; ++i)
-                ensureSprite(std::to_string(i));
-
-            ensureSprite("covered");
-            ensureSprite("mine");
+            atlasmanager::load_or_bake_atlas(atlas.name,
+                atlascache::asset_paths("assets/games/minesweeperlike/", kSpriteIds), [&]
+                {
+                    for (std::size_t i = 0; i < kSpriteIds.size(); ++i)
+                        ensureSprite(i, kSpriteIds[i]);
+                });
 
             if (createdAtlas || registeredSprite)
             {
@@ -248,8 +248,12 @@ export namespace almondnamespace::minesweeperlike
             }
         }
 
+        // Positions in kSpriteIds (setupSprites()), which are also the tile-map cell values.
+        enum SpriteId : std::uint16_t { SpriteCount0, SpriteCovered = 9, SpriteMine = 10 };
+
         GameState state{};
-        std::unordered_map<std::string, SpriteHandle> sprites{};
+        SpriteTable sprites{};
+        std::vector<std::uint16_t> cells = std::vector<std::uint16_t>(std::size_t(GRID_W) * std::size_t(GRID_H));
         bool gameOver = false;
         bool mouseWasDown = false;
     };
@@ -1,4 +1,266 @@
+/**************************************************************
+ *   AlmondShell - Modular C++ Framework
+ **************************************************************/
+ // amipmapatlas.ixx
+ //
+ // CPU mip chain for RGBA8 atlases. Levels are built with a 2x2
+ // box filter; texels on the border of a packed entry are refiltered
+ // with samples clamped to that entry so neighbours never bleed in.
+
 module;
 
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#   include <emmintrin.h>
+#   define ALMOND_MIP_SSE2 1
+#endif
 
 export module amipmapatlas;
+
+// ────────────────────────────────────────────────────────────
+// STANDARD LIBRARY IMPORTS
+// ────────────────────────────────────────────────────────────
+
+import <algorithm>;
+import <bit>;
+import <cmath>;
+import <cstddef>;
+import <cstdint>;
+import <span>;
+import <vector>;
+
+// ────────────────────────────────────────────────────────────
+// ENGINE DEPENDENCIES
+// ────────────────────────────────────────────────────────────
+
+import aatlas.packer;   // PackerRect
+
+// ────────────────────────────────────────────────────────────
+// MODULE EXPORTS
+// ────────────────────────────────────────────────────────────
+
+export namespace almondnamespace::mip
+{
+    struct MipLevel
+    {
+        std::uint32_t width{ 0 };
+        std::uint32_t height{ 0 };
+        std::vector<std::uint8_t> pixels; // tightly packed RGBA8
+    };
+
+    // Read-only view of one level; level 0 is the atlas itself.
+    struct MipView
+    {
+        const std::uint8_t* pixels{ nullptr };
+        std::uint32_t width{ 0 };
+        std::uint32_t height{ 0 };
+        std::uint32_t level{ 0 };
+    };
+
+    [[nodiscard]] constexpr std::uint32_t level_extent(std::uint32_t base, std::uint32_t level) noexcept
+    {
+        return (std::max)(1u, base >> level);
+    }
+
+    // Number of levels below the base until both sides reach one texel.
+    [[nodiscard]] constexpr std::uint32_t full_chain_length(std::uint32_t w, std::uint32_t h) noexcept
+    {
+        const std::uint32_t largest = (std::max)(w, h);
+        return largest ? static_cast<std::uint32_t>(std::bit_width(largest)) - 1u : 0u;
+    }
+
+    // Deepest level at which entries separated by `padding` on each side are
+    // still at least one texel apart, so bilinear taps stay inside the gutter.
+    // 0 without padding: level 1 texels would already straddle two entries.
+    [[nodiscard]] constexpr std::uint32_t gutter_safe_levels(std::uint32_t padding) noexcept
+    {
+        return static_cast<std::uint32_t>(std::bit_width(padding));
+    }
+
+    // `rect` scaled to `level`, rounded outwards.
+    [[nodiscard]] constexpr PackerRect scale_rect(const PackerRect& rect, std::uint32_t level) noexcept
+    {
+        const std::uint32_t x0 = rect.x >> level;
+        const std::uint32_t y0 = rect.y >> level;
+        const std::uint32_t round = (1u << level) - 1u;
+        const std::uint32_t x1 = (rect.x + rect.width + round) >> level;
+        const std::uint32_t y1 = (rect.y + rect.height + round) >> level;
+        return { x0, y0, x1 - x0, y1 - y0 };
+    }
+
+    namespace detail
+    {
+        inline void box_row(
+            const std::uint8_t* row0, const std::uint8_t* row1, std::uint32_t srcW,
+            std::uint8_t* dst, std::uint32_t x0, std::uint32_t x1) noexcept
+        {
+            std::uint32_t x = x0;
+
+#if defined(ALMOND_MIP_SSE2)
+            // Two destination texels per iteration: 4 source texels from each row,
+            // widened to 16 bits so the 2x2 sum is exact before the rounding shift.
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i two = _mm_set1_epi16(2);
+            for (; x + 2 <= x1 && 2 * x + 4 <= srcW; x += 2) {
+                const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + 8 * static_cast<std::size_t>(x)));
+                const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + 8 * static_cast<std::size_t>(x)));
+                const __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+                const __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+                const __m128i loPair = _mm_add_epi16(lo, _mm_srli_si128(lo, 8));
+                const __m128i hiPair = _mm_add_epi16(hi, _mm_srli_si128(hi, 8));
+                const __m128i sum = _mm_unpacklo_epi64(loPair, hiPair);
+                const __m128i avg = _mm_srli_epi16(_mm_add_epi16(sum, two), 2);
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + 4 * static_cast<std::size_t>(x)), _mm_packus_epi16(avg, zero));
+            }
+#endif
+
+            for (; x < x1; ++x) {
+                const std::uint32_t sx0 = (std::min)(2 * x, srcW - 1);
+                const std::uint32_t sx1 = (std::min)(2 * x + 1, srcW - 1);
+                for (std::uint32_t c = 0; c < 4; ++c) {
+                    const std::uint32_t sum = row0[sx0 * 4 + c] + row0[sx1 * 4 + c]
+                        + row1[sx0 * 4 + c] + row1[sx1 * 4 + c];
+                    dst[4 * static_cast<std::size_t>(x) + c] = static_cast<std::uint8_t>((sum + 2) >> 2);
+                }
+            }
+        }
+
+        // 2x2 average with source coordinates clamped to [lo, hi] on each axis.
+        inline void clamped_texel(
+            const std::uint8_t* src, std::uint32_t srcW,
+            const PackerRect& bounds, std::uint32_t x, std::uint32_t y,
+            std::uint8_t* out) noexcept
+        {
+            const std::uint32_t maxX = bounds.x + bounds.width - 1;
+            const std::uint32_t maxY = bounds.y + bounds.height - 1;
+            const std::uint32_t sx0 = std::clamp(2 * x, bounds.x, maxX);
+            const std::uint32_t sx1 = std::clamp(2 * x + 1, bounds.x, maxX);
+            const std::uint32_t sy0 = std::clamp(2 * y, bounds.y, maxY);
+            const std::uint32_t sy1 = std::clamp(2 * y + 1, bounds.y, maxY);
+
+            const std::size_t stride = static_cast<std::size_t>(srcW) * 4;
+            const std::uint8_t* t00 = src + sy0 * stride + sx0 * 4;
+            const std::uint8_t* t01 = src + sy0 * stride + sx1 * 4;
+            const std::uint8_t* t10 = src + sy1 * stride + sx0 * 4;
+            const std::uint8_t* t11 = src + sy1 * stride + sx1 * 4;
+            for (std::uint32_t c = 0; c < 4; ++c)
+                out[c] = static_cast<std::uint8_t>((t00[c] + t01[c] + t10[c] + t11[c] + 2) >> 2);
+        }
+
+        [[nodiscard]] inline bool intersect(const PackerRect& a, const PackerRect& b, PackerRect& out) noexcept
+        {
+            const std::uint32_t x0 = (std::max)(a.x, b.x);
+            const std::uint32_t y0 = (std::max)(a.y, b.y);
+            const std::uint32_t x1 = (std::min)(a.x + a.width, b.x + b.width);
+            const std::uint32_t y1 = (std::min)(a.y + a.height, b.y + b.height);
+            if (x0 >= x1 || y0 >= y1)
+                return false;
+            out = { x0, y0, x1 - x0, y1 - y0 };
+            return true;
+        }
+    }
+
+    // Downsamples `area` (in destination texels) of `src` into `dst`.
+    inline void downsample(
+        const std::uint8_t* src, std::uint32_t srcW, std::uint32_t srcH,
+        std::uint8_t* dst, std::uint32_t dstW, const PackerRect& area) noexcept
+    {
+        const std::size_t srcStride = static_cast<std::size_t>(srcW) * 4;
+        const std::size_t dstStride = static_cast<std::size_t>(dstW) * 4;
+        for (std::uint32_t y = area.y; y < area.y + area.height; ++y) {
+            const std::uint8_t* row0 = src + (std::min)(2 * y, srcH - 1) * srcStride;
+            const std::uint8_t* row1 = src + (std::min)(2 * y + 1, srcH - 1) * srcStride;
+            detail::box_row(row0, row1, srcW, dst + y * dstStride, area.x, area.x + area.width);
+        }
+    }
+
+    // Rebuilds the part of `levels` covering `dirty` (base-level texels). `levels`
+    // is resized to `levelCount` entries when its shape does not match, in which
+    // case the whole chain is rebuilt. `entries` are the packed rects in base
+    // texels; their borders are refiltered without reaching into neighbours.
+    inline void build_levels(
+        const std::uint8_t* base, std::uint32_t width, std::uint32_t height,
+        std::span<const PackerRect> entries, std::uint32_t levelCount,
+        PackerRect dirty, std::vector<MipLevel>& levels)
+    {
+        levelCount = (std::min)(levelCount, full_chain_length(width, height));
+
+        bool reshaped = levels.size() != levelCount;
+        if (!reshaped) {
+            for (std::uint32_t l = 0; l < levelCount; ++l) {
+                if (levels[l].width != level_extent(width, l + 1) || levels[l].height != level_extent(height, l + 1)) {
+                    reshaped = true;
+                    break;
+                }
+            }
+        }
+
+        if (reshaped) {
+            levels.resize(levelCount);
+            for (std::uint32_t l = 0; l < levelCount; ++l) {
+                auto& level = levels[l];
+                level.width = level_extent(width, l + 1);
+                level.height = level_extent(height, l + 1);
+                level.pixels.assign(static_cast<std::size_t>(level.width) * level.height * 4, 0);
+            }
+            dirty = { 0, 0, width, height };
+        }
+
+        for (std::uint32_t l = 0; l < levelCount; ++l) {
+            const std::uint8_t* src = (l == 0) ? base : levels[l - 1].pixels.data();
+            const std::uint32_t srcW = level_extent(width, l);
+            const std::uint32_t srcH = level_extent(height, l);
+            auto& dst = levels[l];
+
+            PackerRect area{};
+            if (!detail::intersect(scale_rect(dirty, l + 1), { 0, 0, dst.width, dst.height }, area))
+                break;
+
+            downsample(src, srcW, srcH, dst.pixels.data(), dst.width, area);
+
+            // Only border texels can pull from a neighbour; interior ones already
+            // average four texels of the same entry.
+            const std::size_t dstStride = static_cast<std::size_t>(dst.width) * 4;
+            for (const auto& entry : entries) {
+                const PackerRect srcBounds = scale_rect(entry, l);
+                PackerRect touched{};
+                if (!detail::intersect(scale_rect(entry, l + 1), area, touched))
+                    continue;
+
+                const std::uint32_t x1 = touched.x + touched.width;
+                const std::uint32_t y1 = touched.y + touched.height;
+                for (std::uint32_t y = touched.y; y < y1; ++y) {
+                    const bool edgeRow = 2 * y < srcBounds.y || 2 * y + 1 >= srcBounds.y + srcBounds.height;
+                    for (std::uint32_t x = touched.x; x < x1;) {
+                        detail::clamped_texel(src, srcW, srcBounds, x, y, dst.pixels.data() + y * dstStride + x * 4);
+                        // Skip to the right border once past the left one on interior rows.
+                        if (!edgeRow && x == touched.x && x1 > touched.x + 2)
+                            x = x1 - 1;
+                        else
+                            ++x;
+                    }
+                }
+            }
+        }
+    }
+
+    // Picks the level whose texel footprint best matches a `srcExtent` to
+    // `destExtent` minification, clamped to the levels that exist.
+    [[nodiscard]] inline std::uint32_t select_level(float srcExtent, float destExtent, std::uint32_t available) noexcept
+    {
+        if (destExtent <= 0.0f || srcExtent <= destExtent)
+            return 0;
+        const auto ratio = static_cast<std::uint32_t>(srcExtent / destExtent);
+        const auto level = static_cast<std::uint32_t>(std::bit_width(ratio)) - 1u;
+        return (std::min)(level, available);
+    }
+
+    // Continuous level of detail, log2(srcExtent / destExtent), clamped to
+    // [0, available]; the fractional part weights the next level down when
+    // filtering between levels.
+    [[nodiscard]] inline float select_lod(float srcExtent, float destExtent, std::uint32_t available) noexcept
+    {
+        if (destExtent <= 0.0f || srcExtent <= destExtent)
+            return 0.0f;
+        return (std::min)(std::log2(srcExtent / destExtent), static_cast<float>(available));
+    }
+}
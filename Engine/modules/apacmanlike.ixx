@@ -10,6 +10,7 @@ import aengine.context.window;    // core::WindowData
 import aengine.input;             // input::Key
 import agamecore;                 // grid helpers
 import aatlas.manager;            // atlas manager + registry
+import aatlas.cache;              // atlascache::asset_paths
 import aimage.loader;             // a_loadImage / ImageData
 import aspritehandle;             // SpriteHandle
 import asprite.pool;              // spritepool
@@ -25,6 +26,7 @@ import aengine.core.logger;       // logger::Logger
 // C++ standard library modules
 // ------------------------------------------------------------
 import <algorithm>;
+import <array>;
 import <cstddef>;
 import <deque>;
 import <memory>;
@@ -186,6 +188,9 @@ export namespace almondnamespace::pacmanlike
                 throw std::runtime_error("[Pacman] Failed to get atlas registrar");
 
             TextureAtlas& atlas = registrar->atlas;
+
+            static constexpr std::array<std::string_view, 4> kSpriteIds{ "pacman", "ghost", "pellet", "wall" };
+
             bool registeredAny = false;
 
             auto ensureSprite = [&](std::string_view name, SpriteHandle& outHandle)
@@ -215,10 +220,14 @@ export namespace almondnamespace::pacmanlike
                     registeredAny = true;
                 };
 
-            ensureSprite("pacman", pacmanHandle);
-            ensureSprite("ghost", ghostHandle);
-            ensureSprite("pellet", pelletHandle);
-            ensureSprite("wall", wallHandle);
+            atlasmanager::load_or_bake_atlas(atlas.name,
+                atlascache::asset_paths("assets/games/apacmanlike/", kSpriteIds), [&]
+                {
+                    ensureSprite("pacman", pacmanHandle);
+                    ensureSprite("ghost", ghostHandle);
+                    ensureSprite("pellet", pelletHandle);
+                    ensureSprite("wall", wallHandle);
+                });
 
             if (createdAtlas || registeredAny)
             {
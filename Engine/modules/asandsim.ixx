@@ -7,9 +7,12 @@ import aengine.core.context;      // core::Context
 import aengine.context.window;    // core::WindowData
 import aengine.input;             // input::Key
 import aatlas.manager;            // atlasmanager
+import aatlas.cache;              // atlascache::asset_paths
 import aimage.loader;             // a_loadImage
 import aspritehandle;             // SpriteHandle
 import asprite.pool;              // spritepool
+import aspritetable;              // SpriteTable, TileGrid
+import asandsim.world;            // SandWorld, Material
 import ascene;                    // scene::Scene
 import aengine.core.logger;       // logger::Logger
 import aengine.core.time;         // timing::Timer
@@ -17,13 +20,13 @@ import aengine.core.time;         // timing::Timer
 // C++ std
 import <algorithm>;
 import <array>;
+import <cstddef>;
 import <cstdint>;
 import <span>;
 import <stdexcept>;
 import <string>;
 import <string_view>;
 import <tuple>;
-import <unordered_map>;
 import <utility>;
 import <vector>;
 
@@ -53,9 +56,9 @@ export namespace almondnamespace::sandsim
             auto atlasVec = atlasmanager::get_atlas_vector_snapshot(); // by value
             std::span<const TextureAtlas* const> atlasSpan(atlasVec.data(), atlasVec.size());
 
-            if (auto it = sprites.find("bg"); it != sprites.end() && spritepool::is_alive(it->second))
+            if (const SpriteHandle background = sprites.live(SpriteBg); background.is_valid())
             {
-                ctx->draw_sprite_safe(it->second, atlasSpan, 0.0f, 0.0f,
+                ctx->draw_sprite_safe(background, atlasSpan, 0.0f, 0.0f,
                     float(ctx->get_width_safe()), float(ctx->get_height_safe()));
             }
 
@@ -64,28 +67,14 @@ export namespace almondnamespace::sandsim
             const float cellSize = std::min(width / float(kCols), height / float(kRows));
             const float offsetX = (width - cellSize * float(kCols)) * 0.5f;
             const float offsetY = (height - cellSize * float(kRows)) * 0.5f;
-            constexpr std::array<std::string_view, 3> materialNames = {
-                "sand", "water", "stone"
-            };
-
-            for (int row = 0; row < kRows; ++row)
-            {
-                for (int col = 0; col < kCols; ++col)
-                {
-                    const int material = grid[static_cast<size_t>(row * kCols + col)];
-                    if (material < 0 || material >= static_cast<int>(materialNames.size()))
-                        continue;
 
-                    auto it = sprites.find(std::string(materialNames[static_cast<size_t>(material)]));
-                    if (it == sprites.end() || !spritepool::is_alive(it->second))
-                        continue;
+            handleInput(*ctx, offsetX, offsetY, cellSize);
+            pour();
+            world.tick();
+            refreshCells();
 
-                    ctx->draw_sprite_safe(it->second, atlasSpan,
-                        offsetX + cellSize * float(col),
-                        offsetY + cellSize * float(row),
-                        cellSize, cellSize);
-                }
-            }
+            ctx->draw_tilemap_safe(sprites.palette(), cells, world.width(), world.height(),
+                { offsetX, offsetY, cellSize, cellSize }, atlasSpan);
 
             ctx->present_safe();
             return true;
@@ -113,9 +102,12 @@ export namespace almondnamespace::sandsim
                 throw std::runtime_error("[SandSim] Missing atlas registrar");
 
             TextureAtlas& atlas = registrar->atlas;
+
+            static constexpr std::array<std::string_view, 4> kSpriteIds{ "bg", "sand", "water", "stone" };
+
             bool registered = false;
 
-            auto ensureSprite = [&](std::string_view id)
+            auto ensureSprite = [&](std::size_t index, std::string_view id)
             {
                 std::string name(id);
 
@@ -124,7 +116,7 @@ export namespace almondnamespace::sandsim
                     auto handle = std::get<0>(*existing);
                     if (spritepool::is_alive(handle))
                     {
-                        sprites[name] = handle;
+                        sprites.set(index, handle);
                         return;
                     }
                 }
@@ -138,16 +130,18 @@ export namespace almondnamespace::sandsim
 
                 if (handleOpt && spritepool::is_alive(*handleOpt))
                 {
-                    sprites[name] = *handleOpt;
+                    sprites.set(index, *handleOpt);
                     registered = true;
                 }
             };
 
-            // Always try to load a background sprite if available
-            ensureSprite("bg");
-            ensureSprite("sand");
-            ensureSprite("water");
-            ensureSprite("stone");
+            atlasmanager::load_or_bake_atlas(atlas.name,
+                atlascache::asset_paths("assets/games/asandsim/", kSpriteIds), [&]
+                {
+                    // Always try to load a background sprite if available
+                    for (std::size_t i = 0; i < kSpriteIds.size(); ++i)
+                        ensureSprite(i, kSpriteIds[i]);
+                });
 
             if (createdAtlas || registered)
             {
@@ -156,21 +150,92 @@ export namespace almondnamespace::sandsim
             }
         }
 
-        std::unordered_map<std::string, SpriteHandle> sprites{};
-        static constexpr int kRows = 18;
-        static constexpr int kCols = 24;
-        std::vector<int> grid{};
+        // Positions in kSpriteIds (setupSprites()), which are also the tile-map cell values.
+        enum SpriteId : std::uint16_t { SpriteBg, SpriteSand, SpriteWater, SpriteStone };
+
+        SpriteTable sprites{};
+        static constexpr int kRows = 128;
+        static constexpr int kCols = 192;
+        static constexpr int kPourTicks = 2400; // emitters stop so the world can settle
+        static constexpr int kBrushRadius = 3;
+        SandWorld world{};
+        Material brush = Material::Sand;
+        std::vector<std::uint16_t> cells{};
 
         void initializeGrid()
         {
-            grid.resize(static_cast<size_t>(kRows * kCols));
-            for (int row = 0; row < kRows; ++row)
+            world.resize(kCols, kRows);
+            cells.assign(static_cast<std::size_t>(kRows * kCols), kNoTile);
+
+            // A few ledges for the emitters to pile onto.
+            world.fill_rect(kCols / 6, kRows / 3, kCols / 4, 2, Material::Stone);
+            world.fill_rect(kCols * 7 / 12, kRows / 2, kCols / 4, 2, Material::Stone);
+            world.fill_rect(kCols / 3, kRows * 3 / 4, kCols / 3, 2, Material::Stone);
+            world.fill_rect(kCols / 3, kRows * 3 / 4 - 10, 2, 10, Material::Stone);
+            world.fill_rect(kCols * 2 / 3 - 2, kRows * 3 / 4 - 10, 2, 10, Material::Stone);
+        }
+
+        void pour()
+        {
+            if (world.ticks() >= static_cast<std::uint64_t>(kPourTicks))
+                return;
+
+            const int spread = static_cast<int>(world.ticks() % 5) - 2;
+            world.set(kCols / 4 + spread, 0, Material::Sand);
+            world.set(kCols * 3 / 4 - spread, 0, Material::Water);
+        }
+
+        // 1/2/3 pick sand, water or stone, the left button paints, right erases, R resets.
+        void handleInput(core::Context& ctx, float offsetX, float offsetY, float cellSize)
+        {
+            if (ctx.is_key_down_safe(input::Key::Num1)) brush = Material::Sand;
+            if (ctx.is_key_down_safe(input::Key::Num2)) brush = Material::Water;
+            if (ctx.is_key_down_safe(input::Key::Num3)) brush = Material::Stone;
+            if (ctx.is_key_down_safe(input::Key::R))
+            {
+                initializeGrid();
+                return;
+            }
+
+            const bool paint = ctx.is_mouse_button_held_safe(input::MouseButton::MouseLeft);
+            const bool erase = ctx.is_mouse_button_held_safe(input::MouseButton::MouseRight);
+            if ((!paint && !erase) || cellSize <= 0.0f)
+                return;
+
+            int mx = 0, my = 0;
+            ctx.get_mouse_position_safe(mx, my);
+            const int col = static_cast<int>((float(mx) - offsetX) / cellSize);
+            const int row = static_cast<int>((float(my) - offsetY) / cellSize);
+            world.fill_circle(col, row, kBrushRadius, paint ? brush : Material::Empty);
+        }
+
+        // Rebuilds the cells of chunks that changed since the last frame.
+        void refreshCells()
+        {
+            // Material m is drawn with sprite m (see SpriteId); empty cells show the background.
+            static constexpr std::array<std::uint16_t, kMaterialCount> kTiles{
+                kNoTile, SpriteSand, SpriteWater, SpriteStone };
+
+            const auto materials = world.materials();
+            const int size = SandWorld::kChunkSize;
+            for (int cy = 0; cy < world.chunks_y(); ++cy)
             {
-                for (int col = 0; col < kCols; ++col)
+                for (int cx = 0; cx < world.chunks_x(); ++cx)
                 {
-                    grid[static_cast<size_t>(row * kCols + col)] = (row + col) % 3;
+                    if (!world.chunk_changed(cx, cy))
+                        continue;
+
+                    const int x1 = std::min(kCols, (cx + 1) * size);
+                    const int y1 = std::min(kRows, (cy + 1) * size);
+                    for (int y = cy * size; y < y1; ++y)
+                        for (int x = cx * size; x < x1; ++x)
+                        {
+                            const std::size_t i = static_cast<std::size_t>(y * kCols + x);
+                            cells[i] = kTiles[materials[i]];
+                        }
                 }
             }
+            world.clear_changed();
         }
     };
 
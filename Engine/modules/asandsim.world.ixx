@@ -0,0 +1,382 @@
+/**************************************************************
+ *   AlmondShell - Modular C++ Framework
+ **************************************************************/
+ // asandsim.world.ixx
+ //
+ // Falling-sand world for asandsim and the `sandsim` benchmark.
+ // Cells are one byte per field (material, move stamp) in row-major
+ // arrays, split into 64x64 chunks. Only awake chunks are updated; a
+ // chunk sleeps after a tick in which nothing in or next to it moved.
+ // A particle moves at most one cell per tick, so chunks two apart
+ // never touch the same cells: each tick runs four checkerboard phases
+ // and the chunks of a phase update in parallel. The result does not
+ // depend on the number of threads.
+
+module;
+
+export module asandsim.world;
+
+import <algorithm>;
+import <atomic>;
+import <cstddef>;
+import <cstdint>;
+import <memory>;
+import <span>;
+import <thread>;
+import <utility>;
+import <vector>;
+
+import aengine.systems;                 // Task
+import aengine.taskgraph.dotsystem;     // taskgraph::TaskGraph, Node
+
+export namespace almondnamespace::sandsim
+{
+    enum class Material : std::uint8_t { Empty, Sand, Water, Stone };
+    inline constexpr int kMaterialCount = 4;
+
+    class SandWorld
+    {
+    public:
+        static constexpr int kChunkShift = 6;
+        static constexpr int kChunkSize = 1 << kChunkShift;
+
+        SandWorld() = default;
+        SandWorld(int width, int height) { resize(width, height); }
+        SandWorld(const SandWorld&) = delete;
+        SandWorld& operator=(const SandWorld&) = delete;
+
+        // Empties the world and wakes every chunk.
+        void resize(int width, int height)
+        {
+            width_ = (std::max)(1, width);
+            height_ = (std::max)(1, height);
+            chunksX_ = (width_ + kChunkSize - 1) >> kChunkShift;
+            chunksY_ = (height_ + kChunkSize - 1) >> kChunkShift;
+
+            const std::size_t cells = static_cast<std::size_t>(width_) * static_cast<std::size_t>(height_);
+            material_.assign(cells, static_cast<std::uint8_t>(Material::Empty));
+            stamp_.assign(cells, 0);
+
+            const std::size_t chunks = static_cast<std::size_t>(chunksX_) * static_cast<std::size_t>(chunksY_);
+            awake_.assign(chunks, 1);
+            wakeNext_ = std::make_unique<std::atomic<std::uint8_t>[]>(chunks);
+            changed_ = std::make_unique<std::atomic<std::uint8_t>[]>(chunks);
+            for (std::size_t c = 0; c < chunks; ++c)
+                changed_[c].store(1, std::memory_order_relaxed);
+            ticks_ = 0;
+            awakeCount_ = 0;
+        }
+
+        void clear()
+        {
+            std::fill(material_.begin(), material_.end(), static_cast<std::uint8_t>(Material::Empty));
+            wake_all();
+        }
+
+        [[nodiscard]] int width() const noexcept { return width_; }
+        [[nodiscard]] int height() const noexcept { return height_; }
+        [[nodiscard]] int chunks_x() const noexcept { return chunksX_; }
+        [[nodiscard]] int chunks_y() const noexcept { return chunksY_; }
+        [[nodiscard]] std::uint64_t ticks() const noexcept { return ticks_; }
+
+        // Chunks updated by the last tick().
+        [[nodiscard]] std::size_t awake_chunks() const noexcept { return awakeCount_; }
+
+        // Row-major, width() * height(), values are Material.
+        [[nodiscard]] std::span<const std::uint8_t> materials() const noexcept { return material_; }
+
+        [[nodiscard]] Material at(int x, int y) const noexcept
+        {
+            if (!inside(x, y))
+                return Material::Stone; // the border behaves like a wall
+            return static_cast<Material>(material_[index(x, y)]);
+        }
+
+        void set(int x, int y, Material material)
+        {
+            if (!inside(x, y))
+                return;
+            material_[index(x, y)] = static_cast<std::uint8_t>(material);
+            touch(x, y);
+        }
+
+        void fill_rect(int x, int y, int w, int h, Material material)
+        {
+            const int x0 = (std::max)(0, x), y0 = (std::max)(0, y);
+            const int x1 = (std::min)(width_, x + w), y1 = (std::min)(height_, y + h);
+            for (int cy = y0; cy < y1; ++cy) {
+                std::fill_n(material_.begin() + static_cast<std::ptrdiff_t>(index(x0, cy)),
+                    (std::max)(0, x1 - x0), static_cast<std::uint8_t>(material));
+            }
+            wake_area(x0 - 1, y0 - 1, x1, y1);
+        }
+
+        void fill_circle(int cx, int cy, int radius, Material material)
+        {
+            for (int y = cy - radius; y <= cy + radius; ++y)
+                for (int x = cx - radius; x <= cx + radius; ++x)
+                    if ((x - cx) * (x - cx) + (y - cy) * (y - cy) <= radius * radius && inside(x, y))
+                        material_[index(x, y)] = static_cast<std::uint8_t>(material);
+            wake_area(cx - radius - 1, cy - radius - 1, cx + radius + 1, cy + radius + 1);
+        }
+
+        // With `parallel` off every chunk is updated on the calling thread.
+        void set_parallel(bool parallel) noexcept { parallel_ = parallel; }
+
+        // Advances the world by one step. Cells moved this tick carry the
+        // tick's stamp (1..255) and are not moved again; a cell left alone
+        // for a multiple of 255 ticks can alias and wait one extra tick.
+        void tick()
+        {
+            ++ticks_;
+            currentStamp_ = static_cast<std::uint8_t>(ticks_ % 255u + 1u);
+
+            awakeCount_ = 0;
+            for (const auto a : awake_)
+                awakeCount_ += a;
+
+            for (int phase = 0; phase < 4; ++phase) {
+                work_.clear();
+                for (int cy = phase >> 1; cy < chunksY_; cy += 2)
+                    for (int cx = phase & 1; cx < chunksX_; cx += 2)
+                        if (awake_[chunk_index(cx, cy)])
+                            work_.push_back(chunk_index(cx, cy));
+                run_phase();
+            }
+
+            for (std::size_t c = 0; c < awake_.size(); ++c)
+                awake_[c] = wakeNext_[c].exchange(0, std::memory_order_relaxed);
+        }
+
+        // Set when a chunk's cells changed since the last clear_changed(),
+        // so a renderer only rebuilds what moved.
+        [[nodiscard]] bool chunk_changed(int cx, int cy) const noexcept
+        {
+            return changed_[chunk_index(cx, cy)].load(std::memory_order_relaxed) != 0;
+        }
+
+        void clear_changed() noexcept
+        {
+            for (std::size_t c = 0; c < awake_.size(); ++c)
+                changed_[c].store(0, std::memory_order_relaxed);
+        }
+
+        // FNV-1a over the size and every cell, for determinism checks.
+        [[nodiscard]] std::uint64_t hash() const noexcept
+        {
+            constexpr std::uint64_t kPrime = 0x100000001B3ull;
+            std::uint64_t h = 0xCBF29CE484222325ull;
+            h = (h ^ static_cast<std::uint32_t>(width_)) * kPrime;
+            h = (h ^ static_cast<std::uint32_t>(height_)) * kPrime;
+            for (const auto m : material_)
+                h = (h ^ m) * kPrime;
+            return h;
+        }
+
+    private:
+        [[nodiscard]] bool inside(int x, int y) const noexcept
+        {
+            return x >= 0 && y >= 0 && x < width_ && y < height_;
+        }
+
+        [[nodiscard]] std::size_t index(int x, int y) const noexcept
+        {
+            return static_cast<std::size_t>(y) * static_cast<std::size_t>(width_) + static_cast<std::size_t>(x);
+        }
+
+        [[nodiscard]] std::size_t chunk_index(int cx, int cy) const noexcept
+        {
+            return static_cast<std::size_t>(cy) * static_cast<std::size_t>(chunksX_) + static_cast<std::size_t>(cx);
+        }
+
+        void wake_all() noexcept
+        {
+            std::fill(awake_.begin(), awake_.end(), std::uint8_t{ 1 });
+            for (std::size_t c = 0; c < awake_.size(); ++c)
+                changed_[c].store(1, std::memory_order_relaxed);
+        }
+
+        // Wakes (for this tick if it has not run yet, and the next) and marks
+        // changed every chunk overlapping the inclusive cell rect.
+        void wake_area(int x0, int y0, int x1, int y1) noexcept
+        {
+            const int cx0 = (std::max)(0, x0) >> kChunkShift;
+            const int cy0 = (std::max)(0, y0) >> kChunkShift;
+            const int cx1 = (std::min)(width_ - 1, x1) >> kChunkShift;
+            const int cy1 = (std::min)(height_ - 1, y1) >> kChunkShift;
+            for (int cy = cy0; cy <= cy1; ++cy) {
+                for (int cx = cx0; cx <= cx1; ++cx) {
+                    const std::size_t c = chunk_index(cx, cy);
+                    awake_[c] = 1;
+                    changed_[c].store(1, std::memory_order_relaxed);
+                }
+            }
+        }
+
+        void touch(int x, int y) noexcept { wake_area(x - 1, y - 1, x + 1, y + 1); }
+
+        // During a tick: a cell at (x, y) changed, so its chunk and whichever
+        // chunks hold its neighbours run again next tick.
+        void wake_next(int x, int y) noexcept
+        {
+            const int cx0 = (std::max)(0, x - 1) >> kChunkShift;
+            const int cy0 = (std::max)(0, y - 1) >> kChunkShift;
+            const int cx1 = (std::min)(width_ - 1, x + 1) >> kChunkShift;
+            const int cy1 = (std::min)(height_ - 1, y + 1) >> kChunkShift;
+            for (int cy = cy0; cy <= cy1; ++cy) {
+                for (int cx = cx0; cx <= cx1; ++cx) {
+                    const std::size_t c = chunk_index(cx, cy);
+                    wakeNext_[c].store(1, std::memory_order_relaxed);
+                    changed_[c].store(1, std::memory_order_relaxed);
+                }
+            }
+        }
+
+        // Cheap per-cell coin flip that only depends on position and time.
+        [[nodiscard]] bool coin(int x, int y) const noexcept
+        {
+            std::uint32_t h = static_cast<std::uint32_t>(x) * 0x9E3779B1u
+                ^ static_cast<std::uint32_t>(y) * 0x85EBCA77u
+                ^ static_cast<std::uint32_t>(ticks_) * 0xC2B2AE3Du;
+            h ^= h >> 15;
+            h *= 0x2C1B3C6Du;
+            return (h >> 16) & 1u;
+        }
+
+        [[nodiscard]] bool accepts(int x, int y, Material mover) const noexcept
+        {
+            if (!inside(x, y))
+                return false;
+            const auto target = static_cast<Material>(material_[index(x, y)]);
+            // Sand sinks through water.
+            return target == Material::Empty || (mover == Material::Sand && target == Material::Water);
+        }
+
+        void move(int x, int y, int tx, int ty) noexcept
+        {
+            const std::size_t from = index(x, y);
+            const std::size_t to = index(tx, ty);
+            std::swap(material_[from], material_[to]);
+            stamp_[to] = currentStamp_;
+            stamp_[from] = currentStamp_; // a displaced water cell has moved too
+            wake_next(x, y);
+            wake_next(tx, ty);
+        }
+
+        void update_cell(int x, int y) noexcept
+        {
+            const std::size_t i = index(x, y);
+            const auto m = static_cast<Material>(material_[i]);
+            if (m == Material::Empty || m == Material::Stone || stamp_[i] == currentStamp_)
+                return;
+
+            if (accepts(x, y + 1, m)) {
+                move(x, y, x, y + 1);
+                return;
+            }
+
+            const int side = coin(x, y) ? 1 : -1;
+            if (accepts(x + side, y + 1, m)) {
+                move(x, y, x + side, y + 1);
+                return;
+            }
+            if (accepts(x - side, y + 1, m)) {
+                move(x, y, x - side, y + 1);
+                return;
+            }
+
+            if (m == Material::Water) {
+                if (accepts(x + side, y, m))
+                    move(x, y, x + side, y);
+                else if (accepts(x - side, y, m))
+                    move(x, y, x - side, y);
+            }
+        }
+
+        // Bottom row first so a falling column moves together; the scan
+        // direction alternates per row and tick to avoid a sideways bias.
+        void update_chunk(std::size_t chunk) noexcept
+        {
+            const int cx = static_cast<int>(chunk % static_cast<std::size_t>(chunksX_));
+            const int cy = static_cast<int>(chunk / static_cast<std::size_t>(chunksX_));
+            const int x0 = cx << kChunkShift;
+            const int y0 = cy << kChunkShift;
+            const int x1 = (std::min)(width_, x0 + kChunkSize);
+            const int y1 = (std::min)(height_, y0 + kChunkSize);
+
+            for (int y = y1 - 1; y >= y0; --y) {
+                if (((static_cast<std::uint64_t>(y) + ticks_) & 1u) == 0) {
+                    for (int x = x0; x < x1; ++x)
+                        update_cell(x, y);
+                }
+                else {
+                    for (int x = x1 - 1; x >= x0; --x)
+                        update_cell(x, y);
+                }
+            }
+        }
+
+        void drain() noexcept
+        {
+            for (std::size_t i = next_.fetch_add(1, std::memory_order_relaxed); i < work_.size();
+                i = next_.fetch_add(1, std::memory_order_relaxed))
+                update_chunk(work_[i]);
+        }
+
+        static Task chunk_worker(SandWorld* self)
+        {
+            self->drain();
+            co_return;
+        }
+
+        void run_phase()
+        {
+            if (work_.empty())
+                return;
+
+            const std::size_t hw = (std::max)(1u, std::thread::hardware_concurrency());
+            const std::size_t helpers = parallel_ ? (std::min)(hw - 1, work_.size() - 1) : 0;
+
+            next_.store(0, std::memory_order_relaxed);
+            if (helpers == 0) {
+                drain();
+                return;
+            }
+
+            if (!graph_)
+                graph_ = std::make_unique<taskgraph::TaskGraph>(hw - 1);
+
+            for (std::size_t i = 0; i < helpers; ++i) {
+                auto node = std::make_unique<taskgraph::Node>(chunk_worker(this));
+                node->Label = "sandsim:chunks";
+                graph_->AddNode(std::move(node));
+            }
+            graph_->Execute();
+
+            drain();
+
+            graph_->WaitAll();
+            graph_->PruneFinished();
+        }
+
+        int width_{ 0 };
+        int height_{ 0 };
+        int chunksX_{ 0 };
+        int chunksY_{ 0 };
+        bool parallel_{ true };
+        std::uint64_t ticks_{ 0 };
+        std::size_t awakeCount_{ 0 };
+        std::uint8_t currentStamp_{ 0 };                        // move stamp of the running tick
+
+        std::vector<std::uint8_t> material_;                    // per cell, Material
+        std::vector<std::uint8_t> stamp_;                       // per cell, tick stamp of its last move
+
+        std::vector<std::uint8_t> awake_;                       // per chunk, updated this tick
+        std::unique_ptr<std::atomic<std::uint8_t>[]> wakeNext_; // per chunk, set from worker threads
+        std::unique_ptr<std::atomic<std::uint8_t>[]> changed_;  // per chunk, cleared by clear_changed()
+
+        std::vector<std::size_t> work_;                         // chunks of the running phase
+        std::atomic<std::size_t> next_{ 0 };
+        std::unique_ptr<taskgraph::TaskGraph> graph_;
+    };
+}
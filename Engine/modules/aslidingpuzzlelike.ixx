@@ -7,22 +7,24 @@ import aengine.core.context;      // core::Context
 import aengine.context.window;    // core::WindowData
 import aengine.input;             // input::Key
 import aatlas.manager;            // atlasmanager
+import aatlas.cache;              // atlascache::asset_paths
 import aimage.loader;             // a_loadImage
 import aspritehandle;             // SpriteHandle
 import asprite.pool;              // spritepool
+import aspritetable;              // SpriteTable, TileGrid
 import ascene;                    // scene::Scene
 import aengine.core.logger;       // logger::Logger
 import aengine.core.time;         // timing::Timer
 
 // C++ std
 import <algorithm>;
+import <array>;
 import <cstdint>;
 import <span>;
 import <stdexcept>;
 import <string>;
 import <string_view>;
 import <tuple>;
-import <unordered_map>;
 import <utility>;
 import <vector>;
 
@@ -54,9 +56,9 @@ export namespace almondnamespace::slidinglike
             auto atlasVec = atlasmanager::get_atlas_vector_snapshot(); // by value
             std::span<const TextureAtlas* const> atlasSpan(atlasVec.data(), atlasVec.size());
 
-            if (auto it = sprites.find("bg"); it != sprites.end() && spritepool::is_alive(it->second))
+            if (const SpriteHandle background = sprites.live(SpriteBg); background.is_valid())
             {
-                ctx->draw_sprite_safe(it->second, atlasSpan, 0.0f, 0.0f,
+                ctx->draw_sprite_safe(background, atlasSpan, 0.0f, 0.0f,
                     float(ctx->get_width_safe()), float(ctx->get_height_safe()));
             }
 
@@ -66,22 +68,11 @@ export namespace almondnamespace::slidinglike
             const float offsetX = (width - cellSize * float(kCols)) * 0.5f;
             const float offsetY = (height - cellSize * float(kRows)) * 0.5f;
 
-            for (int row = 0; row < kRows; ++row)
-            {
-                for (int col = 0; col < kCols; ++col)
-                {
-                    const int value = grid[static_cast<size_t>(row * kCols + col)];
-                    const char* spriteName = (value == 0) ? "empty" : "tile";
-                    auto it = sprites.find(spriteName);
-                    if (it == sprites.end() || !spritepool::is_alive(it->second))
-                        continue;
-
-                    ctx->draw_sprite_safe(it->second, atlasSpan,
-                        offsetX + cellSize * float(col),
-                        offsetY + cellSize * float(row),
-                        cellSize, cellSize);
-                }
-            }
+            for (std::size_t i = 0; i < grid.size(); ++i)
+                cells[i] = grid[i] == 0 ? SpriteEmpty : SpriteTile;
+
+            ctx->draw_tilemap_safe(sprites.palette(), cells, kCols, kRows,
+                { offsetX, offsetY, cellSize, cellSize }, atlasSpan);
 
             ctx->present_safe();
             return true;
@@ -109,9 +100,12 @@ export namespace almondnamespace::slidinglike
                 throw std::runtime_error("[SlidingPuzzleLike] Missing atlas registrar");
 
             TextureAtlas& atlas = registrar->atlas;
+
+            static constexpr std::array<std::string_view, 3> kSpriteIds{ "bg", "tile", "empty" };
+
             bool registered = false;
 
-            auto ensureSprite = [&](std::string_view id)
+            auto ensureSprite = [&](std::size_t index, std::string_view id)
             {
                 std::string name(id);
 
@@ -120,7 +114,7 @@ export namespace almondnamespace::slidinglike
                     auto handle = std::get<0>(*existing);
                     if (spritepool::is_alive(handle))
                     {
-                        sprites[name] = handle;
+                        sprites.set(index, handle);
                         return;
                     }
                 }
@@ -134,15 +128,18 @@ export namespace almondnamespace::slidinglike
 
                 if (handleOpt && spritepool::is_alive(*handleOpt))
                 {
-                    sprites[name] = *handleOpt;
+                    sprites.set(index, *handleOpt);
                     registered = true;
                 }
             };
 
-            // Always try to load a background sprite if available
-            ensureSprite("bg");
-            ensureSprite("tile");
-            ensureSprite("empty");
+            atlasmanager::load_or_bake_atlas(atlas.name,
+                atlascache::asset_paths("assets/games/aslidingpuzzlelike/", kSpriteIds), [&]
+                {
+                    // Always try to load a background sprite if available
+                    for (std::size_t i = 0; i < kSpriteIds.size(); ++i)
+                        ensureSprite(i, kSpriteIds[i]);
+                });
 
             if (createdAtlas || registered)
             {
@@ -151,14 +148,19 @@ export namespace almondnamespace::slidinglike
             }
         }
 
-        std::unordered_map<std::string, SpriteHandle> sprites{};
+        // Positions in kSpriteIds (setupSprites()), which are also the tile-map cell values.
+        enum SpriteId : std::uint16_t { SpriteBg, SpriteTile, SpriteEmpty };
+
+        SpriteTable sprites{};
         static constexpr int kRows = 4;
         static constexpr int kCols = 4;
         std::vector<int> grid{};
+        std::vector<std::uint16_t> cells{};
 
         void initializeGrid()
         {
             grid.resize(static_cast<size_t>(kRows * kCols));
+            cells.resize(grid.size());
             int value = 1;
             for (int row = 0; row < kRows; ++row)
             {
@@ -7,21 +7,23 @@ import aengine.core.context;      // core::Context
 import aengine.context.window;    // core::WindowData
 import aengine.input;             // input::Key
 import aatlas.manager;            // atlasmanager
+import aatlas.cache;              // atlascache::asset_paths
 import aimage.loader;             // a_loadImage
 import aspritehandle;             // SpriteHandle
 import asprite.pool;              // spritepool
+import aspritetable;              // SpriteTable
 import ascene;                    // scene::Scene
 import aengine.core.logger;       // logger::Logger
 import aengine.core.time;         // timing::Timer
 
 // C++ std
+import <array>;
 import <cstdint>;
 import <span>;
 import <stdexcept>;
 import <string>;
 import <string_view>;
 import <tuple>;
-import <unordered_map>;
 import <utility>;
 import <vector>;
 
@@ -48,14 +50,14 @@ export namespace almondnamespace::snakelike
             ctx->clear_safe();
 
             // Example: draw head as a sanity check (or bg if you have it)
-            if (auto it = sprites.find("head"); it != sprites.end() && spritepool::is_alive(it->second))
+            if (const SpriteHandle head = sprites.live(SpriteHead); head.is_valid())
             {
                 auto atlasVec = atlasmanager::get_atlas_vector_snapshot(); // by value
                 std::span<const TextureAtlas* const> atlasSpan(atlasVec.data(), atlasVec.size());
 
 
                 ctx->draw_sprite_safe(
-                    it->second,
+                    head,
                     atlasSpan,
                     0.0f, 0.0f,
                     float(ctx->get_width_safe()),
@@ -89,9 +91,12 @@ export namespace almondnamespace::snakelike
                 throw std::runtime_error("[SnakeLike] Missing atlas registrar");
 
             TextureAtlas& atlas = registrar->atlas;
+
+            static constexpr std::array<std::string_view, 3> kSpriteIds{ "head", "body", "food" };
+
             bool registered = false;
 
-            auto ensureSprite = [&](std::string_view id)
+            auto ensureSprite = [&](std::size_t index, std::string_view id)
             {
                 std::string name(id);
 
@@ -100,7 +105,7 @@ export namespace almondnamespace::snakelike
                     auto handle = std::get<0>(*existing);
                     if (spritepool::is_alive(handle))
                     {
-                        sprites[name] = handle;
+                        sprites.set(index, handle);
                         return;
                     }
                 }
@@ -114,16 +119,19 @@ export namespace almondnamespace::snakelike
 
                 if (handleOpt && spritepool::is_alive(*handleOpt))
                 {
-                    sprites[name] = *handleOpt;
+                    sprites.set(index, *handleOpt);
                     registered = true;
                 }
             };
 
-            // Always try to load a background sprite if available
-            //ensureSprite("bg");
-            ensureSprite("head");
-            ensureSprite("body");
-            ensureSprite("food");
+            atlasmanager::load_or_bake_atlas(atlas.name,
+                atlascache::asset_paths("assets/games/asnakelike/", kSpriteIds), [&]
+                {
+                    // Always try to load a background sprite if available
+                    //ensureSprite("bg");
+                    for (std::size_t i = 0; i < kSpriteIds.size(); ++i)
+                        ensureSprite(i, kSpriteIds[i]);
+                });
 
             if (createdAtlas || registered)
             {
@@ -132,7 +140,10 @@ export namespace almondnamespace::snakelike
             }
         }
 
-        std::unordered_map<std::string, SpriteHandle> sprites{};
+        // Positions in kSpriteIds (setupSprites()).
+        enum SpriteId : std::uint16_t { SpriteHead, SpriteBody, SpriteFood };
+
+        SpriteTable sprites{};
     };
 
     export bool run_snakelike(std::shared_ptr<almondnamespace::core::Context> ctx)
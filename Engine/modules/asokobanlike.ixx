@@ -7,22 +7,24 @@ import aengine.core.context;      // core::Context
 import aengine.context.window;    // core::WindowData
 import aengine.input;             // input::Key
 import aatlas.manager;            // atlasmanager
+import aatlas.cache;              // atlascache::asset_paths
 import aimage.loader;             // a_loadImage
 import aspritehandle;             // SpriteHandle
 import asprite.pool;              // spritepool
+import aspritetable;              // SpriteTable, TileGrid
 import ascene;                    // scene::Scene
 import aengine.core.logger;       // logger::Logger
 import aengine.core.time;         // timing::Timer
 
 // C++ std
 import <algorithm>;
+import <array>;
 import <cstdint>;
 import <span>;
 import <stdexcept>;
 import <string>;
 import <string_view>;
 import <tuple>;
-import <unordered_map>;
 import <utility>;
 import <vector>;
 
@@ -52,9 +54,9 @@ export namespace almondnamespace::sokobanlike
             auto atlasVec = atlasmanager::get_atlas_vector_snapshot(); // by value
             std::span<const TextureAtlas* const> atlasSpan(atlasVec.data(), atlasVec.size());
 
-            if (auto it = sprites.find("bg"); it != sprites.end() && spritepool::is_alive(it->second))
+            if (const SpriteHandle background = sprites.live(SpriteBg); background.is_valid())
             {
-                ctx->draw_sprite_safe(it->second, atlasSpan, 0.0f, 0.0f,
+                ctx->draw_sprite_safe(background, atlasSpan, 0.0f, 0.0f,
                     float(ctx->get_width_safe()), float(ctx->get_height_safe()));
             }
 
@@ -64,34 +66,21 @@ export namespace almondnamespace::sokobanlike
             const float offsetX = (width - cellSize * float(kCols)) * 0.5f;
             const float offsetY = (height - cellSize * float(kRows)) * 0.5f;
 
-            for (int row = 0; row < kRows; ++row)
-            {
-                for (int col = 0; col < kCols; ++col)
-                {
-                    const int tile = grid[static_cast<size_t>(row * kCols + col)];
-                    const char* spriteName = "floor";
-
-                    switch (tile)
-                    {
-                    case 0: spriteName = "floor"; break;
-                    case 1: spriteName = "wall"; break;
-                    case 2: spriteName = "goal"; break;
-                    case 3: spriteName = "box"; break;
-                    case 4: spriteName = "player"; break;
-                    default: spriteName = "floor"; break;
-                    }
-
-                    auto it = sprites.find(spriteName);
-                    if (it == sprites.end() || !spritepool::is_alive(it->second))
-                        continue;
+            // Tile codes: 0 floor, 1 wall, 2 goal, 3 box, 4 player; anything else is floor.
+            constexpr std::array<std::uint16_t, 5> tileSprites{
+                SpriteFloor, SpriteWall, SpriteGoal, SpriteBox, SpritePlayer };
 
-                    ctx->draw_sprite_safe(it->second, atlasSpan,
-                        offsetX + cellSize * float(col),
-                        offsetY + cellSize * float(row),
-                        cellSize, cellSize);
-                }
+            for (std::size_t i = 0; i < grid.size(); ++i)
+            {
+                const int tile = grid[i];
+                cells[i] = (tile >= 0 && tile < static_cast<int>(tileSprites.size()))
+                    ? tileSprites[static_cast<size_t>(tile)]
+                    : SpriteFloor;
             }
 
+            ctx->draw_tilemap_safe(sprites.palette(), cells, kCols, kRows,
+                { offsetX, offsetY, cellSize, cellSize }, atlasSpan);
+
             ctx->present_safe();
             return true;
         }
@@ -118,9 +107,12 @@ export namespace almondnamespace::sokobanlike
                 throw std::runtime_error("[SokobanLike] Missing atlas registrar");
 
             TextureAtlas& atlas = registrar->atlas;
+
+            static constexpr std::array<std::string_view, 6> kSpriteIds{ "bg", "wall", "floor", "goal", "box", "player" };
+
             bool registered = false;
 
-            auto ensureSprite = [&](std::string_view id)
+            auto ensureSprite = [&](std::size_t index, std::string_view id)
             {
                 std::string name(id);
 
@@ -129,7 +121,7 @@ export namespace almondnamespace::sokobanlike
                     auto handle = std::get<0>(*existing);
                     if (spritepool::is_alive(handle))
                     {
-                        sprites[name] = handle;
+                        sprites.set(index, handle);
                         return;
                     }
                 }
@@ -143,18 +135,18 @@ export namespace almondnamespace::sokobanlike
 
                 if (handleOpt && spritepool::is_alive(*handleOpt))
                 {
-                    sprites[name] = *handleOpt;
+                    sprites.set(index, *handleOpt);
                     registered = true;
                 }
             };
 
-            // Always try to load a background sprite if available
-            ensureSprite("bg");
-            ensureSprite("wall");
-            ensureSprite("floor");
-            ensureSprite("goal");
-            ensureSprite("box");
-            ensureSprite("player");
+            atlasmanager::load_or_bake_atlas(atlas.name,
+                atlascache::asset_paths("assets/games/asokobanlike/", kSpriteIds), [&]
+                {
+                    // Always try to load a background sprite if available
+                    for (std::size_t i = 0; i < kSpriteIds.size(); ++i)
+                        ensureSprite(i, kSpriteIds[i]);
+                });
 
             if (createdAtlas || registered)
             {
@@ -163,14 +155,19 @@ export namespace almondnamespace::sokobanlike
             }
         }
 
-        std::unordered_map<std::string, SpriteHandle> sprites{};
+        // Positions in kSpriteIds (setupSprites()), which are also the tile-map cell values.
+        enum SpriteId : std::uint16_t { SpriteBg, SpriteWall, SpriteFloor, SpriteGoal, SpriteBox, SpritePlayer };
+
+        SpriteTable sprites{};
         static constexpr int kRows = 10;
         static constexpr int kCols = 12;
         std::vector<int> grid{};
+        std::vector<std::uint16_t> cells{};
 
         void initializeGrid()
         {
             grid.assign(static_cast<size_t>(kRows * kCols), 0);
+            cells.resize(grid.size());
             for (int row = 0; row < kRows; ++row)
             {
                 for (int col = 0; col < kCols; ++col)
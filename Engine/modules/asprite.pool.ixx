@@ -8,10 +8,7 @@ export module asprite.pool;
 
 import <vector>;
 import <atomic>;
-import <optional>;
-import <stdexcept>;
 import <coroutine>;
-import <memory>;
 import <iostream>;
 import <algorithm>;
 import <cstdint>;
@@ -21,40 +18,95 @@ import <cstdint>;
 // ────────────────────────────────────────────────────────────
 
 import aspritehandle;          // SpriteHandle
-import aengine.systems;         // Task
-import ampmcboundedqueue;
-import aengine.taskgraph.dotsystem;      // taskgraph::TaskGraph, Node
 
 // ────────────────────────────────────────────────────────────
 
 export namespace almondnamespace::spritepool
 {
     using almondnamespace::SpriteHandle;
-    using almondnamespace::Task;
-    using almondnamespace::taskgraph::Node;
 
     // ────────────────────────────────────────────────────────
     // Pool state (module-local singletons)
+    //
+    // Free slots form a lock-free stack threaded through `nextFree`.
+    // `freeHead` packs a tag (high 32 bits) with the top slot index
+    // (low 32 bits); every successful push or pop bumps the tag, so a
+    // stale head fails its CAS even if the same index is back on top
+    // (ABA). Allocation and free are O(1) whatever the fill level.
     // ────────────────────────────────────────────────────────
 
+    inline constexpr std::uint32_t kNoSlot = 0xFFFFFFFFu;
+
     inline std::vector<std::uint8_t>  usedFlags;     // 0 = free, 1 = used
-    inline std::vector<std::uint32_t> generations;  // generation per slot
-    inline std::atomic<std::size_t>   lastAllocIndex{ 0 };
+    inline std::vector<std::uint32_t> generations;  // generation per slot, bumped on free
+    inline std::vector<std::uint32_t> nextFree;     // slot below this one on the free stack
+    inline std::atomic<std::uint64_t> freeHead{ kNoSlot };
     inline std::size_t                capacity = 0;
 
-    // Optional async task graph
-    inline taskgraph::TaskGraph* g_taskGraph = nullptr;
+    // ────────────────────────────────────────────────────────
+    // Free-list internals
+    // ────────────────────────────────────────────────────────
+
+    [[nodiscard]] inline constexpr std::uint64_t pack_head(std::uint64_t tag, std::uint32_t index) noexcept
+    {
+        return (tag << 32) | index;
+    }
+
+    // Slot 0 on top, so a fresh pool hands out ids in order.
+    inline void rebuild_free_list() noexcept
+    {
+        nextFree.resize(capacity);
+        for (std::size_t i = 0; i < capacity; ++i)
+            nextFree[i] = i + 1 < capacity ? static_cast<std::uint32_t>(i + 1) : kNoSlot;
+
+        const std::uint64_t tag = (freeHead.load(std::memory_order_relaxed) >> 32) + 1;
+        freeHead.store(pack_head(tag, capacity ? 0u : kNoSlot), std::memory_order_release);
+    }
+
+    [[nodiscard]] inline std::uint32_t pop_free() noexcept
+    {
+        std::uint64_t head = freeHead.load(std::memory_order_acquire);
+        for (;;)
+        {
+            const std::uint32_t index = static_cast<std::uint32_t>(head);
+            if (index == kNoSlot)
+                return kNoSlot;
+
+            // May read a link another thread is rewriting; the tag makes
+            // the CAS below fail in that case and we retry.
+            const std::uint32_t next =
+                std::atomic_ref<std::uint32_t>(nextFree[index]).load(std::memory_order_relaxed);
+            if (freeHead.compare_exchange_weak(head, pack_head((head >> 32) + 1, next),
+                std::memory_order_acq_rel, std::memory_order_acquire))
+                return index;
+        }
+    }
+
+    inline void push_free(std::uint32_t index) noexcept
+    {
+        std::uint64_t head = freeHead.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            std::atomic_ref<std::uint32_t>(nextFree[index])
+                .store(static_cast<std::uint32_t>(head), std::memory_order_relaxed);
+            if (freeHead.compare_exchange_weak(head, pack_head((head >> 32) + 1, index),
+                std::memory_order_release, std::memory_order_relaxed))
+                return;
+        }
+    }
 
     // ────────────────────────────────────────────────────────
     // Lifecycle
+    //
+    // Not thread-safe: call while no sprite is being allocated or freed.
     // ────────────────────────────────────────────────────────
 
     export inline void initialize(std::size_t cap) noexcept
     {
-        capacity = cap;
+        capacity = (std::min)(cap, static_cast<std::size_t>(kNoSlot));
         usedFlags.assign(capacity, 0);
         generations.assign(capacity, 0);
-        lastAllocIndex.store(0, std::memory_order_relaxed);
+        rebuild_free_list();
 
 #if defined(DEBUG_TEXTURE_RENDERING_VERBOSE)
         std::cerr << "[SpritePool] Initialized with capacity " << capacity << "\n";
@@ -65,8 +117,9 @@ export namespace almondnamespace::spritepool
     {
         usedFlags.clear();
         generations.clear();
-        lastAllocIndex.store(0, std::memory_order_relaxed);
+        nextFree.clear();
         capacity = 0;
+        rebuild_free_list();
         std::cerr << "[SpritePool] Cleared\n";
     }
 
@@ -80,19 +133,13 @@ export namespace almondnamespace::spritepool
 
         std::fill(usedFlags.begin(), usedFlags.end(), 0);
         std::fill(generations.begin(), generations.end(), 0);
-        lastAllocIndex.store(0, std::memory_order_relaxed);
+        rebuild_free_list();
 
 #if defined(DEBUG_TEXTURE_RENDERING_VERBOSE)
         std::cerr << "[SpritePool] Reset\n";
 #endif
     }
 
-    export inline void set_task_graph(taskgraph::TaskGraph* graph) noexcept
-    {
-        g_taskGraph = graph;
-        std::cerr << "[SpritePool] Task graph set\n";
-    }
-
     export inline void validate_pool() noexcept
     {
         std::size_t freeCount = 0;
@@ -103,113 +150,35 @@ export namespace almondnamespace::spritepool
             << " free slots out of " << capacity << "\n";
     }
 
-    // ────────────────────────────────────────────────────────
-    // Allocation internals
-    // ────────────────────────────────────────────────────────
-
-    inline bool try_acquire_flag(std::size_t idx) noexcept
-    {
-        std::atomic_ref<std::uint8_t> flag(usedFlags[idx]);
-        std::uint8_t expected = 0;
-        return flag.compare_exchange_strong(
-            expected, 1, std::memory_order_acquire);
-    }
-
-    inline std::optional<std::size_t>
-        try_allocate_round_robin() noexcept
-    {
-        const std::size_t size = capacity;
-        const std::size_t start =
-            lastAllocIndex.load(std::memory_order_relaxed);
-
-        for (std::size_t offset = 0; offset < size; ++offset)
-        {
-            const std::size_t idx = (start + offset) % size;
-            if (try_acquire_flag(idx))
-            {
-                lastAllocIndex.store(
-                    (idx + 1) % size, std::memory_order_relaxed);
-                return idx;
-            }
-        }
-
-        return std::nullopt;
-    }
-
     // ────────────────────────────────────────────────────────
     // Synchronous allocate
     // ────────────────────────────────────────────────────────
 
     export inline SpriteHandle allocate() noexcept
     {
-        auto idx = try_allocate_round_robin();
-        if (!idx)
+        const std::uint32_t id = pop_free();
+        if (id == kNoSlot)
             return SpriteHandle::invalid();
 
-        const std::uint32_t id =
-            static_cast<std::uint32_t>(*idx);
-
-        return SpriteHandle{ id, generations[id] };
+        std::atomic_ref<std::uint8_t>(usedFlags[id]).store(1, std::memory_order_release);
+        return SpriteHandle{ id,
+            std::atomic_ref<std::uint32_t>(generations[id]).load(std::memory_order_acquire) };
     }
 
     // ────────────────────────────────────────────────────────
     // Async allocate
+    //
+    // Allocation never blocks, so the awaitable completes without
+    // suspending; it stays for coroutine callers.
     // ────────────────────────────────────────────────────────
 
-    struct AllocateAwaitable;
-
-    inline Task spritepool_allocation_coroutine(
-        AllocateAwaitable* self);
-
     struct AllocateAwaitable
     {
-        std::optional<std::size_t> index;
-        std::coroutine_handle<>    awaiting{};
-
-        bool await_ready() const noexcept { return false; }
-
-        void await_suspend(std::coroutine_handle<> h) noexcept
-        {
-            awaiting = h;
-
-            if (!g_taskGraph)
-            {
-                index = try_allocate_round_robin();
-                if (awaiting) awaiting.resume();
-                return;
-            }
-
-            Task task = spritepool_allocation_coroutine(this);
-            auto node = std::make_unique<Node>(std::move(task));
-            node->Label = "SpritePoolAllocate";
-
-            g_taskGraph->AddNode(std::move(node));
-            g_taskGraph->Execute();
-        }
-
-        SpriteHandle await_resume() noexcept
-        {
-            if (!index)
-                return SpriteHandle::invalid();
-
-            const std::uint32_t id =
-                static_cast<std::uint32_t>(*index);
-
-            if (id >= generations.size())
-                return SpriteHandle::invalid();
-
-            return SpriteHandle{ id, generations[id] };
-        }
+        bool await_ready() const noexcept { return true; }
+        void await_suspend(std::coroutine_handle<>) const noexcept {}
+        SpriteHandle await_resume() const noexcept { return allocate(); }
     };
 
-    inline Task spritepool_allocation_coroutine(
-        AllocateAwaitable* self)
-    {
-        self->index = try_allocate_round_robin();
-        if (self->awaiting) self->awaiting.resume();
-        co_return;
-    }
-
     export inline AllocateAwaitable allocateAsync() noexcept
     {
         return {};
@@ -219,6 +188,8 @@ export namespace almondnamespace::spritepool
     // Free / lifetime checks
     // ────────────────────────────────────────────────────────
 
+    // Stale handles (already freed, or from an earlier generation) are
+    // ignored, so a slot is never pushed onto the free stack twice.
     export inline void free(const SpriteHandle& handle) noexcept
     {
         const std::size_t idx =
@@ -226,9 +197,17 @@ export namespace almondnamespace::spritepool
 
         if (idx >= capacity) return;
 
+        std::atomic_ref<std::uint32_t> generation(generations[idx]);
+        if (generation.load(std::memory_order_acquire) != handle.generation)
+            return;
+
         std::atomic_ref<std::uint8_t> flag(usedFlags[idx]);
-        flag.store(0, std::memory_order_release);
-        ++generations[idx];
+        std::uint8_t expected = 1;
+        if (!flag.compare_exchange_strong(expected, 0, std::memory_order_acq_rel))
+            return;
+
+        generation.fetch_add(1, std::memory_order_release);
+        push_free(static_cast<std::uint32_t>(idx));
     }
 
     export inline bool is_alive(
@@ -243,6 +222,7 @@ export namespace almondnamespace::spritepool
         if (flag.load(std::memory_order_acquire) == 0)
             return false;
 
-        return generations[idx] == handle.generation;
+        return std::atomic_ref<std::uint32_t>(generations[idx]).load(std::memory_order_acquire)
+            == handle.generation;
     }
 }
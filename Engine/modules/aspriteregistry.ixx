@@ -6,14 +6,21 @@ export module aspriteregistry;
 // Standard library
 // ────────────────────────────────────────────────────────────
 
+import <array>;
 import <atomic>;
+import <cstddef>;
+import <cstdint>;
 import <iostream>;
+import <memory>;
+import <mutex>;
 import <optional>;
 import <shared_mutex>;
 import <string>;
 import <string_view>;
+import <thread>;
 import <tuple>;
 import <unordered_map>;
+import <vector>;
 
 // ────────────────────────────────────────────────────────────
 // Engine modules
@@ -73,8 +80,34 @@ export namespace almondnamespace
         }
     };
 
+    // ────────────────────────────────────────────────────────
+    // Interned sprite ids
+    // ────────────────────────────────────────────────────────
+
+    // Dense index of a sprite name, handed out by SpriteRegistry::intern().
+    // Ids stay valid for the registry's lifetime, also across remove() and
+    // clear(), so scenes can resolve names once and index from then on.
+    enum class SpriteId : std::uint32_t { Invalid = 0xFFFFFFFFu };
+
+    struct SpriteUv
+    {
+        float u0 = 0.f, v0 = 0.f, u1 = 0.f, v1 = 0.f;
+    };
+
+    struct SpritePivot
+    {
+        float x = 0.f, y = 0.f;
+    };
+
     // ────────────────────────────────────────────────────────
     // SpriteRegistry
+    //
+    // Names are interned to SpriteIds under `mutex`; the data lives in
+    // SoA columns (handles, UV rects, pivots) in fixed-size chunks that
+    // never move. Reads by id take no lock: a sequence counter bumped
+    // around every write lets readers retry a torn read, as in
+    // AtlasEntryTable. Lookups by name hash the string and take the
+    // shared lock, so hot paths should keep the id instead.
     // ────────────────────────────────────────────────────────
 
     export struct SpriteRegistry
@@ -83,21 +116,56 @@ export namespace almondnamespace
             std::tuple<SpriteHandle, float, float, float, float, float, float>;
         //        handle        u0     v0     u1     v1     pivotX pivotY
 
-        std::unordered_map<
-            std::string,
-            Entry,
-            TransparentHash,
-            TransparentEqual
-        > sprites;
+        static constexpr std::size_t kChunkBits = 8;
+        static constexpr std::size_t kChunkSize = std::size_t{ 1 } << kChunkBits;
+        static constexpr std::size_t kMaxChunks = 4096;
+
+        SpriteRegistry() = default;
+        SpriteRegistry(const SpriteRegistry&) = delete;
+        SpriteRegistry& operator=(const SpriteRegistry&) = delete;
 
         mutable std::shared_mutex mutex{};
         std::atomic<const TextureAtlas*> atlas_ptr{ nullptr };
 
+        // ----------------------------------------------------
+        // Interning
+        // ----------------------------------------------------
+
+        // The id for `name`, creating an empty slot the first time.
+        // Invalid only when the registry is full.
+        SpriteId intern(std::string_view name)
+        {
+            std::unique_lock lock(mutex);
+            return intern_locked(name);
+        }
+
+        // Invalid if `name` was never interned.
+        [[nodiscard]]
+        SpriteId find(std::string_view name) const
+        {
+            std::shared_lock lock(mutex);
+            auto it = ids.find(name);
+            return it != ids.end() ? it->second : SpriteId::Invalid;
+        }
+
+        // Number of interned names; ids are [0, size()).
+        [[nodiscard]]
+        std::size_t size() const noexcept { return count.load(std::memory_order_acquire); }
+
+        // Never changes once interned, so no retry is needed.
+        [[nodiscard]]
+        std::string_view name(SpriteId id) const noexcept
+        {
+            return published(id) ? std::string_view{ chunk(id).names[slot(id)] } : std::string_view{};
+        }
+
         // ----------------------------------------------------
         // Add
         // ----------------------------------------------------
 
-        void add(
+        // Publishes `handle` under `name`. A name that already holds a
+        // sprite keeps it; remove it first to replace it.
+        SpriteId add(
             std::string_view name,
             SpriteHandle handle,
             float u0,
@@ -112,30 +180,42 @@ export namespace almondnamespace
                 std::cerr
                     << "[SpriteRegistry] Rejecting invalid handle for '"
                     << name << "'\n";
-                return;
+                return SpriteId::Invalid;
             }
 
             std::unique_lock lock(mutex);
 
             // Prevent handle aliasing
-            for (const auto& [existingName, entry] : sprites)
+            if (auto it = byHandle.find(handle_key(handle)); it != byHandle.end())
             {
-                if (std::get<0>(entry) == handle &&
-                    existingName != name)
+                const SpriteId owner = it->second;
+                if (chunk(owner).handles[slot(owner)] == handle && chunk(owner).names[slot(owner)] != name)
                 {
                     std::cerr
                         << "[SpriteRegistry] Duplicate handle for '"
                         << name << "'\n";
-                    return;
+                    return SpriteId::Invalid;
                 }
             }
 
+            const SpriteId id = intern_locked(name);
+            if (id == SpriteId::Invalid)
+                return id;
+
+            Chunk& c = chunk(id);
+            const std::size_t i = slot(id);
+            if (c.handles[i].is_valid())
+                return id;
+
             const float u1 = u0 + width;
             const float v1 = v0 + height;
 
-            sprites.emplace(
-                std::string{ name },
-                Entry{ handle, u0, v0, u1, v1, pivotX, pivotY });
+            begin_update();
+            c.handles[i] = handle;
+            c.uvs[i] = { u0, v0, u1, v1 };
+            c.pivots[i] = { pivotX, pivotY };
+            end_update();
+            byHandle[handle_key(handle)] = id;
 
 #if defined(DEBUG_TEXTURE_RENDERING_VERBOSE)
             std::cout
@@ -144,46 +224,87 @@ export namespace almondnamespace
                 << " UV=(" << u0 << "," << v0
                 << ")->(" << u1 << "," << v1 << ")\n";
 #endif
+            return id;
         }
 
         // ----------------------------------------------------
-        // Lookup
+        // Lookup by id (lock-free)
+        // ----------------------------------------------------
+
+        // Invalid for unknown or removed ids.
+        [[nodiscard]]
+        SpriteHandle handle(SpriteId id) const noexcept
+        {
+            SpriteHandle out = SpriteHandle::invalid();
+            read(id, [&](const Chunk& c, std::size_t i) { out = c.handles[i]; });
+            return out;
+        }
+
+        [[nodiscard]]
+        SpriteUv uv(SpriteId id) const noexcept
+        {
+            SpriteUv out{};
+            read(id, [&](const Chunk& c, std::size_t i) { out = c.uvs[i]; });
+            return out;
+        }
+
+        [[nodiscard]]
+        SpritePivot pivot(SpriteId id) const noexcept
+        {
+            SpritePivot out{};
+            read(id, [&](const Chunk& c, std::size_t i) { out = c.pivots[i]; });
+            return out;
+        }
+
+        [[nodiscard]]
+        std::optional<Entry> get(SpriteId id) const noexcept
+        {
+            SpriteHandle h = SpriteHandle::invalid();
+            SpriteUv u{};
+            SpritePivot p{};
+            read(id, [&](const Chunk& c, std::size_t i) {
+                h = c.handles[i];
+                u = c.uvs[i];
+                p = c.pivots[i];
+                });
+            if (!h.is_valid())
+                return std::nullopt;
+            return Entry{ h, u.u0, u.v0, u.u1, u.v1, p.x, p.y };
+        }
+
+        // ----------------------------------------------------
+        // Lookup by name
         // ----------------------------------------------------
 
         [[nodiscard]]
         std::optional<Entry>
             get(std::string_view name) const noexcept
         {
-            std::shared_lock lock(mutex);
-            auto it = sprites.find(name);
-            return (it != sprites.end())
-                ? std::optional<Entry>{ it->second }
-            : std::nullopt;
+            return get(find(name));
         }
 
         // ----------------------------------------------------
-        // Removal
+        // Removal (the name stays interned)
         // ----------------------------------------------------
 
         bool remove(std::string_view name)
         {
             std::unique_lock lock(mutex);
-            return sprites.erase(name) > 0;
+            auto it = ids.find(name);
+            return it != ids.end() && remove_locked(it->second);
         }
 
         bool remove_if_invalid(std::string_view name)
         {
             std::unique_lock lock(mutex);
 
-            auto it = sprites.find(name);
-            if (it == sprites.end())
+            auto it = ids.find(name);
+            if (it == ids.end())
                 return false;
 
-            if (!spritepool::is_alive(std::get<0>(it->second)))
-            {
-                sprites.erase(it);
-                return true;
-            }
+            const SpriteHandle current = chunk(it->second).handles[slot(it->second)];
+            if (current.is_valid() && !spritepool::is_alive(current))
+                return remove_locked(it->second);
 
             return false;
         }
@@ -192,19 +313,29 @@ export namespace almondnamespace
         {
             std::unique_lock lock(mutex);
 
-            for (auto it = sprites.begin(); it != sprites.end();)
+            const std::size_t n = count.load(std::memory_order_relaxed);
+            for (std::size_t i = 0; i < n; ++i)
             {
-                if (!spritepool::is_alive(std::get<0>(it->second)))
-                    it = sprites.erase(it);
-                else
-                    ++it;
+                const SpriteId id = static_cast<SpriteId>(i);
+                const SpriteHandle current = chunk(id).handles[slot(id)];
+                if (current.is_valid() && !spritepool::is_alive(current))
+                    remove_locked(id);
             }
         }
 
         void clear() noexcept
         {
             std::unique_lock lock(mutex);
-            sprites.clear();
+
+            const std::size_t n = count.load(std::memory_order_relaxed);
+            begin_update();
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                const SpriteId id = static_cast<SpriteId>(i);
+                chunk(id).handles[slot(id)] = SpriteHandle::invalid();
+            }
+            end_update();
+            byHandle.clear();
         }
 
         // ----------------------------------------------------
@@ -221,5 +352,109 @@ export namespace almondnamespace
         {
             return atlas_ptr.load(std::memory_order_acquire);
         }
+
+    private:
+        struct Chunk
+        {
+            std::array<SpriteHandle, kChunkSize> handles{}; // invalid = no sprite
+            std::array<SpriteUv, kChunkSize>     uvs{};
+            std::array<SpritePivot, kChunkSize>  pivots{};
+            std::array<std::string, kChunkSize>  names{};
+        };
+
+        [[nodiscard]] static std::size_t slot(SpriteId id) noexcept
+        {
+            return static_cast<std::size_t>(id) & (kChunkSize - 1);
+        }
+
+        [[nodiscard]] Chunk& chunk(SpriteId id) const noexcept
+        {
+            return *chunks[static_cast<std::size_t>(id) >> kChunkBits].load(std::memory_order_acquire);
+        }
+
+        [[nodiscard]] bool published(SpriteId id) const noexcept
+        {
+            return static_cast<std::size_t>(id) < count.load(std::memory_order_acquire);
+        }
+
+        [[nodiscard]] static std::uint64_t handle_key(const SpriteHandle& h) noexcept
+        {
+            return (static_cast<std::uint64_t>(h.generation) << 32) | h.id;
+        }
+
+        void begin_update() noexcept { seq.fetch_add(1, std::memory_order_acq_rel); }
+        void end_update() noexcept { seq.fetch_add(1, std::memory_order_release); }
+
+        // Runs `fn(chunk, slot)` on a consistent view of a published id.
+        template <typename Fn>
+        void read(SpriteId id, Fn&& fn) const noexcept
+        {
+            if (!published(id))
+                return;
+            const Chunk& c = chunk(id);
+            const std::size_t i = slot(id);
+            for (;;)
+            {
+                const std::uint64_t before = seq.load(std::memory_order_acquire);
+                if (before & 1u)
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+                fn(c, i);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (seq.load(std::memory_order_relaxed) == before)
+                    return;
+            }
+        }
+
+        SpriteId intern_locked(std::string_view name)
+        {
+            if (auto it = ids.find(name); it != ids.end())
+                return it->second;
+
+            const std::size_t i = count.load(std::memory_order_relaxed);
+            if (i >= kChunkSize * kMaxChunks)
+                return SpriteId::Invalid;
+
+            auto& entry = chunks[i >> kChunkBits];
+            if (!entry.load(std::memory_order_relaxed))
+            {
+                owned.push_back(std::make_unique<Chunk>());
+                entry.store(owned.back().get(), std::memory_order_release);
+            }
+
+            const SpriteId id = static_cast<SpriteId>(i);
+            chunk(id).names[slot(id)] = std::string{ name };
+            ids.emplace(std::string{ name }, id);
+            count.store(i + 1, std::memory_order_release);
+            return id;
+        }
+
+        bool remove_locked(SpriteId id)
+        {
+            SpriteHandle& current = chunk(id).handles[slot(id)];
+            if (!current.is_valid())
+                return false;
+
+            byHandle.erase(handle_key(current));
+            begin_update();
+            current = SpriteHandle::invalid();
+            end_update();
+            return true;
+        }
+
+        std::unordered_map<
+            std::string,
+            SpriteId,
+            TransparentHash,
+            TransparentEqual
+        > ids;
+        std::unordered_map<std::uint64_t, SpriteId> byHandle; // aliasing check
+
+        std::array<std::atomic<Chunk*>, kMaxChunks> chunks{};
+        std::vector<std::unique_ptr<Chunk>> owned;
+        std::atomic<std::size_t> count{ 0 };
+        std::atomic<std::uint64_t> seq{ 0 };
     };
 }
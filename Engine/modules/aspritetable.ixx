@@ -0,0 +1,107 @@
+module;
+
+export module aspritetable;
+
+// ────────────────────────────────────────────────────────────
+// Standard library
+// ────────────────────────────────────────────────────────────
+
+import <cstddef>;
+import <cstdint>;
+import <span>;
+import <vector>;
+
+// ────────────────────────────────────────────────────────────
+// Engine modules
+// ────────────────────────────────────────────────────────────
+
+import aspritehandle;
+import asprite.pool;
+
+// ────────────────────────────────────────────────────────────
+
+export namespace almondnamespace
+{
+    // Tile-map cell value that draws nothing.
+    inline constexpr std::uint16_t kNoTile = 0xFFFF;
+
+    // Placement of a tile map in pixels: the top-left corner of cell (0, 0)
+    // and the size of one cell. Cell (col, row) is drawn at
+    // (x + col * cellWidth, y + row * cellHeight).
+    struct TileGrid
+    {
+        float x = 0.0f;
+        float y = 0.0f;
+        float cellWidth = 0.0f;
+        float cellHeight = 0.0f;
+    };
+
+    // ────────────────────────────────────────────────────────
+    // SpriteTable
+    //
+    // Sprite handles indexed by a small integer (a material, a tile
+    // kind, a sprite id's position in a scene's id list). Scenes fill
+    // it once when their sprites are registered and index it while
+    // drawing instead of looking sprites up by name every cell. The
+    // indices are the cell values of draw_tilemap_safe().
+    // ────────────────────────────────────────────────────────
+
+    class SpriteTable
+    {
+    public:
+        SpriteTable() = default;
+        explicit SpriteTable(std::size_t size) : handles(size) {}
+
+        void resize(std::size_t size) { handles.resize(size); }
+
+        // Keeps the size; every entry becomes invalid.
+        void clear() noexcept
+        {
+            for (auto& handle : handles)
+                handle = SpriteHandle::invalid();
+        }
+
+        void set(std::size_t index, SpriteHandle handle)
+        {
+            if (index >= handles.size())
+                handles.resize(index + 1);
+            handles[index] = handle;
+        }
+
+        // Invalid for out-of-range indices and unset entries.
+        [[nodiscard]] SpriteHandle operator[](std::size_t index) const noexcept
+        {
+            return index < handles.size() ? handles[index] : SpriteHandle::invalid();
+        }
+
+        [[nodiscard]] bool has(std::size_t index) const noexcept
+        {
+            return (*this)[index].is_valid();
+        }
+
+        // The entry if its sprite is still alive, otherwise invalid.
+        [[nodiscard]] SpriteHandle live(std::size_t index) const noexcept
+        {
+            const SpriteHandle handle = (*this)[index];
+            return handle.is_valid() && spritepool::is_alive(handle) ? handle : SpriteHandle::invalid();
+        }
+
+        [[nodiscard]] std::size_t size() const noexcept { return handles.size(); }
+        [[nodiscard]] std::span<const SpriteHandle> entries() const noexcept { return handles; }
+
+        // The table with released sprites replaced by invalid handles: one
+        // liveness check per entry, for a whole tile map. Valid until the
+        // next call.
+        [[nodiscard]] std::span<const SpriteHandle> palette() const
+        {
+            livePalette.resize(handles.size());
+            for (std::size_t i = 0; i < handles.size(); ++i)
+                livePalette[i] = live(i);
+            return livePalette;
+        }
+
+    private:
+        std::vector<SpriteHandle> handles{};
+        mutable std::vector<SpriteHandle> livePalette{};
+    };
+}
@@ -158,6 +158,7 @@ export namespace almondnamespace::tetrislike
         bool game_over = false;
 
         static inline SpriteRegistry registry;
+        static inline const SpriteId blockSprite = registry.intern("tetris_block");
 
         // === Tetromino definitions ===
         static constexpr std::array<std::array<std::array<int, 16>, 4>, 7> TETRAMINOS = { {
@@ -285,7 +286,7 @@ export namespace almondnamespace::tetrislike
             float cw = float(ctx->get_width_safe()) / GRID_W;
             float ch = float(ctx->get_height_safe()) / GRID_H;
 
-            auto entry = registry.get("tetris_block");
+            auto entry = registry.get(blockSprite);
             if (!entry || !registry.get_atlas()) return;
 
             auto& [handle, u0, v0, u1, v1, px, py] = *entry;
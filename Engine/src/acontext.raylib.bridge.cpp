@@ -198,6 +198,11 @@ namespace almondnamespace::raylib_api
         return from_rl(::LoadTextureFromImage(rlImg));
     }
 
+    void update_texture_rec(const Texture2D& tex, const Rectangle& rec, const void* pixels)
+    {
+        ::UpdateTextureRec(to_rl(tex), to_rl(rec), pixels);
+    }
+
     void unload_texture(const Texture2D& tex) { ::UnloadTexture(to_rl(tex)); }
 
     RenderTexture2D load_render_texture(int w, int h) { return from_rl(::LoadRenderTexture(w, h)); }
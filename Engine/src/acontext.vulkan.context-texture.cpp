@@ -13,6 +13,7 @@ module;
 
 module acontext.vulkan.context:texture;
 
+import <algorithm>;
 import <array>;
 import <cstdint>;
 import <cstring>;
@@ -30,6 +31,9 @@ import aengine.core.logger;
 import autility.string.converter;
 import aimage.loader;
 import aatlas.texture;
+import aatlas.manager;
+import amipmapatlas;
+import aengine.context.type;
 import :shared_vk;
 
 namespace almondnamespace::vulkancontext
@@ -287,6 +291,122 @@ namespace almondnamespace::vulkancontext
         if (atlas.pixel_data.empty())
             return;
 
+        const std::uint32_t mipLevels = atlas.has_mipmaps ? atlas.mip_level_count + 1 : 1;
+        if (mipLevels > 1)
+            atlas.ensure_mipmaps();
+
+        // Stages the part of each mip level covered by `rect` (base-level texels).
+        // The image must already be in TransferDstOptimal.
+        auto upload_mip_levels = [&](const AtlasDirtyRect& rect)
+        {
+            std::vector<std::uint8_t> texels;
+            for (std::uint32_t level = 1; level < mipLevels; ++level)
+            {
+                const auto view = atlas.mip_view(level);
+                const auto scaled = mip::scale_rect({ rect.x, rect.y, rect.width, rect.height }, level);
+                const std::uint32_t x1 = (std::min)(scaled.x + scaled.width, view.width);
+                const std::uint32_t y1 = (std::min)(scaled.y + scaled.height, view.height);
+                if (scaled.x >= x1 || scaled.y >= y1)
+                    continue;
+
+                const std::size_t rowBytes = static_cast<std::size_t>(x1 - scaled.x) * 4;
+                texels.resize(rowBytes * (y1 - scaled.y));
+                for (std::uint32_t row = scaled.y; row < y1; ++row)
+                {
+                    std::memcpy(texels.data() + (row - scaled.y) * rowBytes,
+                        view.pixels + (static_cast<std::size_t>(row) * view.width + scaled.x) * 4,
+                        rowBytes);
+                }
+
+                const vk::DeviceSize levelSize = static_cast<vk::DeviceSize>(texels.size());
+
+                vk::UniqueBuffer levelStaging;
+                vk::UniqueDeviceMemory levelStagingMemory;
+                std::tie(levelStaging, levelStagingMemory) = createBuffer(
+                    levelSize,
+                    vk::BufferUsageFlagBits::eTransferSrc,
+                    vk::MemoryPropertyFlagBits::eHostVisible |
+                    vk::MemoryPropertyFlagBits::eHostCoherent);
+
+                auto [levelMapRes, levelMapped] = device->mapMemory(*levelStagingMemory, 0, levelSize);
+                if (levelMapRes != vk::Result::eSuccess || !levelMapped)
+                    throw std::runtime_error("[ Vulkan ] -  Failed to map GUI atlas mip staging buffer.");
+
+                std::memcpy(levelMapped, texels.data(), texels.size());
+                device->unmapMemory(*levelStagingMemory);
+
+                copyBufferToImageRegion(
+                    *levelStaging,
+                    *entry.image,
+                    static_cast<std::int32_t>(scaled.x),
+                    static_cast<std::int32_t>(scaled.y),
+                    x1 - scaled.x,
+                    y1 - scaled.y,
+                    level);
+
+                atlasmanager::record_upload_bytes(core::ContextType::Vulkan, texels.size());
+            }
+        };
+
+        // Image already matches the atlas: re-upload only the texels written since.
+        if (entry.image && entry.width == atlas.width && entry.height == atlas.height
+            && entry.mipLevels == mipLevels)
+        {
+            std::uint64_t uploadVersion = 0;
+            const AtlasDirtyRect rect = atlas.dirty_rect_since(entry.version, &uploadVersion);
+            if (!rect.empty())
+            {
+                std::vector<std::uint8_t> texels;
+                atlas.copy_rect(rect, texels);
+
+                const vk::DeviceSize rectSize = static_cast<vk::DeviceSize>(texels.size());
+
+                vk::UniqueBuffer rectStaging;
+                vk::UniqueDeviceMemory rectStagingMemory;
+                std::tie(rectStaging, rectStagingMemory) = createBuffer(
+                    rectSize,
+                    vk::BufferUsageFlagBits::eTransferSrc,
+                    vk::MemoryPropertyFlagBits::eHostVisible |
+                    vk::MemoryPropertyFlagBits::eHostCoherent);
+
+                auto [rectMapRes, rectMapped] = device->mapMemory(*rectStagingMemory, 0, rectSize);
+                if (rectMapRes != vk::Result::eSuccess || !rectMapped)
+                    throw std::runtime_error("[ Vulkan ] -  Failed to map GUI atlas staging buffer.");
+
+                std::memcpy(rectMapped, texels.data(), texels.size());
+                device->unmapMemory(*rectStagingMemory);
+
+                transitionImageLayout(
+                    *entry.image,
+                    vk::Format::eR8G8B8A8Srgb,
+                    vk::ImageLayout::eShaderReadOnlyOptimal,
+                    vk::ImageLayout::eTransferDstOptimal,
+                    mipLevels);
+
+                copyBufferToImageRegion(
+                    *rectStaging,
+                    *entry.image,
+                    static_cast<std::int32_t>(rect.x),
+                    static_cast<std::int32_t>(rect.y),
+                    rect.width,
+                    rect.height);
+
+                upload_mip_levels(rect);
+
+                transitionImageLayout(
+                    *entry.image,
+                    vk::Format::eR8G8B8A8Srgb,
+                    vk::ImageLayout::eTransferDstOptimal,
+                    vk::ImageLayout::eShaderReadOnlyOptimal,
+                    mipLevels);
+
+                atlasmanager::record_upload_bytes(core::ContextType::Vulkan, rect.byte_size());
+            }
+
+            entry.version = uploadVersion;
+            return;
+        }
+
         entry.image.reset();
         entry.memory.reset();
         entry.view.reset();
@@ -294,6 +414,9 @@ namespace almondnamespace::vulkancontext
         entry.descriptorPool.reset();
         entry.descriptorSets.clear();
 
+        // Taken before the texels are read: a write racing the copy leaves the
+        // stored version behind, so the next upload picks it up.
+        const std::uint64_t fullVersion = atlas.version;
         const vk::DeviceSize imageSize = static_cast<vk::DeviceSize>(atlas.pixel_data.size());
 
         vk::UniqueBuffer stagingBuffer;
@@ -311,11 +434,13 @@ namespace almondnamespace::vulkancontext
         std::memcpy(mapped, atlas.pixel_data.data(), static_cast<std::size_t>(imageSize));
         device->unmapMemory(*stagingMemory);
 
+        atlasmanager::record_upload_bytes(core::ContextType::Vulkan, static_cast<std::size_t>(imageSize));
+
         vk::ImageCreateInfo imageInfo{};
         imageInfo.imageType = vk::ImageType::e2D;
         imageInfo.format = vk::Format::eR8G8B8A8Srgb;
         imageInfo.extent = vk::Extent3D{ atlas.width, atlas.height, 1u };
-        imageInfo.mipLevels = 1u;
+        imageInfo.mipLevels = mipLevels;
         imageInfo.arrayLayers = 1u;
         imageInfo.samples = vk::SampleCountFlagBits::e1;
         imageInfo.tiling = vk::ImageTiling::eOptimal;
@@ -351,7 +476,8 @@ namespace almondnamespace::vulkancontext
             *entry.image,
             vk::Format::eR8G8B8A8Srgb,
             vk::ImageLayout::eUndefined,
-            vk::ImageLayout::eTransferDstOptimal);
+            vk::ImageLayout::eTransferDstOptimal,
+            mipLevels);
 
         copyBufferToImage(
             *stagingBuffer,
@@ -359,16 +485,20 @@ namespace almondnamespace::vulkancontext
             atlas.width,
             atlas.height);
 
+        upload_mip_levels({ 0, 0, atlas.width, atlas.height });
+
         transitionImageLayout(
             *entry.image,
             vk::Format::eR8G8B8A8Srgb,
             vk::ImageLayout::eTransferDstOptimal,
-            vk::ImageLayout::eShaderReadOnlyOptimal);
+            vk::ImageLayout::eShaderReadOnlyOptimal,
+            mipLevels);
 
         entry.view = createImageViewUnique(
             *entry.image,
             vk::Format::eR8G8B8A8Srgb,
-            vk::ImageAspectFlagBits::eColor);
+            vk::ImageAspectFlagBits::eColor,
+            mipLevels);
 
         vk::SamplerCreateInfo samplerInfo{};
         samplerInfo.flags = {};
@@ -384,7 +514,7 @@ namespace almondnamespace::vulkancontext
         samplerInfo.compareEnable = VK_FALSE;
         samplerInfo.compareOp = vk::CompareOp::eAlways;
         samplerInfo.minLod = 0.0f;
-        samplerInfo.maxLod = 0.0f;
+        samplerInfo.maxLod = static_cast<float>(mipLevels - 1);
         samplerInfo.borderColor = vk::BorderColor::eIntOpaqueBlack;
         samplerInfo.unnormalizedCoordinates = VK_FALSE;
 
@@ -460,9 +590,10 @@ namespace almondnamespace::vulkancontext
             device->updateDescriptorSets(writes, {});
         }
 
-        entry.version = atlas.version;
+        entry.version = fullVersion;
         entry.width = atlas.width;
         entry.height = atlas.height;
+        entry.mipLevels = mipLevels;
     }
 } // namespace almondnamespace::vulkancontext
 
@@ -28,7 +28,6 @@ module;
 #include <string_view>
 #include <unordered_map>
 #include <utility>
-#include <vector>
 
 module aeditor; // implements the interface unit
 
@@ -51,7 +50,7 @@ namespace almondnamespace
 
         struct AiChat
         {
-            std::vector<std::string> lines{};
+            gui::ConsoleScrollback scrollback{ 4096 };
             std::string input{};
 
             // One request in flight.
@@ -60,7 +59,7 @@ namespace almondnamespace
             AiChat()
             {
                 epoch::ai::init_bot();
-                lines.emplace_back("bot> Ready. Endpoint: http://localhost:1234");
+                scrollback.push("bot> Ready. Endpoint: http://localhost:1234");
             }
 
             // std::future is move-only => make this move-only explicitly.
@@ -84,11 +83,11 @@ namespace almondnamespace
                 {
                     std::string reply = pending->get();
                     if (reply.empty()) reply = "(empty reply)";
-                    lines.emplace_back("bot> " + reply);
+                    scrollback.push("bot> " + reply);
                 }
                 catch (const std::exception& e)
                 {
-                    lines.emplace_back(std::string("bot> (error) ") + e.what());
+                    scrollback.push(std::string("bot> (error) ") + e.what());
                 }
 
                 pending.reset();
@@ -100,11 +99,11 @@ namespace almondnamespace
 
                 if (pending)
                 {
-                    lines.emplace_back("bot> (busy)");
+                    scrollback.push("bot> (busy)");
                     return;
                 }
 
-                lines.emplace_back("you> " + text);
+                scrollback.push("you> " + text);
 
                 pending.emplace(std::async(std::launch::async, [t = std::move(text)]() mutable {
                     return epoch::ai::send_to_bot(t);
@@ -236,8 +235,7 @@ namespace almondnamespace
             .title = "AI Chat",
             .position = { 0.0f, 0.0f },
             .size = { 0.0f, 0.0f },
-            .lines = chat.lines,
-            .max_visible_lines = 200,
+            .scrollback = &chat.scrollback,
             .input = &chat.input,
             .max_input_chars = 1024,
             .multiline_input = false,
@@ -83,6 +83,9 @@ import acontext.raylib.state;
 #if defined(ALMOND_USING_SOFTWARE_RENDERER)
 import acontext.softrenderer.context;
 #endif
+#if defined(ALMOND_USING_SOFTWARE_HEADLESS)
+import acontext.softrenderer.headless;
+#endif
 #if defined(ALMOND_USING_NOOP_HEADLESS)
 import acontext.noop.context;
 #endif
@@ -312,6 +315,41 @@ namespace
     }
 #endif
 
+#if defined(ALMOND_USING_SOFTWARE_HEADLESS)
+    void softrenderer_headless_initialize_adapter()
+    {
+        auto ctx = almondnamespace::core::MultiContextManager::GetCurrent();
+        if (!ctx) return;
+
+        try {
+            if (!almondnamespace::anativecontext::headless_initialize(ctx))
+                ctx->init_failed = true;
+        }
+        catch (const std::exception& e) {
+            almondnamespace::logger::get(kLogSoftRenderer).logf(
+                almondnamespace::logger::LogLevel::ALMOND_ERROR,
+                std::source_location::current(),
+                "headless init exception: {}",
+                e.what());
+        }
+        catch (...) {
+            almondnamespace::logger::get(kLogSoftRenderer).log(
+                almondnamespace::logger::LogLevel::ALMOND_ERROR,
+                "headless init unknown exception",
+                std::source_location::current());
+        }
+    }
+
+    void softrenderer_headless_cleanup_adapter()
+    {
+        auto ctx = almondnamespace::core::MultiContextManager::GetCurrent();
+        if (!ctx) return;
+
+        auto copy = ctx;
+        almondnamespace::anativecontext::headless_cleanup(copy);
+    }
+#endif
+
 #if defined(ALMOND_USING_SFML)
     void sfml_initialize_adapter()
     {
@@ -445,6 +483,7 @@ namespace
         almondnamespace::raylibcontext::raylib_process();
 
         // Ensure atlas uploads happen on the active raylib context.
+        almondnamespace::atlasmanager::mark_quiescent(almondnamespace::core::ContextType::RayLib);
         almondnamespace::atlasmanager::process_pending_uploads(almondnamespace::core::ContextType::RayLib);
 
         // Always clear + present once per frame so UI draws actually show up (and we don't leave a half-open texture mode).
@@ -521,6 +560,7 @@ namespace almondnamespace::core
         clone->get_height = prototype.get_height;
         clone->registry_get = prototype.registry_get;
         clone->draw_sprite = prototype.draw_sprite;
+        clone->draw_tilemap = prototype.draw_tilemap;
         clone->add_model = prototype.add_model;
 
         clone->is_key_held = prototype.is_key_held;
@@ -760,6 +800,7 @@ namespace almondnamespace::core
             ctx->is_mouse_button_down = [](input::MouseButton b) { return input::is_mouse_button_down(b); };
 
             ctx->draw_sprite = almondnamespace::anativecontext::draw_sprite;
+            ctx->draw_tilemap = almondnamespace::anativecontext::draw_tilemap;
             ctx->add_texture = &add_texture_default;
             ctx->add_atlas = +[](const TextureAtlas& a) { return add_atlas_default(a, ContextType::Software); };
 
@@ -767,6 +808,25 @@ namespace almondnamespace::core
         }
 #endif
 
+#if defined(ALMOND_USING_SOFTWARE_HEADLESS)
+        {
+            auto ctx = std::make_shared<Context>();
+            ctx->type = ContextType::SoftwareHeadless;
+            ctx->backendName = "SoftwareHeadless";
+
+            ctx->initialize = softrenderer_headless_initialize_adapter;
+            ctx->cleanup = softrenderer_headless_cleanup_adapter;
+            ctx->process = almondnamespace::anativecontext::headless_process;
+
+            ctx->draw_sprite = almondnamespace::anativecontext::draw_sprite;
+            ctx->draw_tilemap = almondnamespace::anativecontext::draw_tilemap;
+            ctx->add_texture = &add_texture_default;
+            ctx->add_atlas = +[](const TextureAtlas& a) { return add_atlas_default(a, ContextType::SoftwareHeadless); };
+
+            AddContextForBackend(ContextType::SoftwareHeadless, std::move(ctx));
+        }
+#endif
+
 #if defined(ALMOND_USING_NOOP_HEADLESS)
         {
             auto ctx = std::make_shared<Context>();
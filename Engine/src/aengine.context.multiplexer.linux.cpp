@@ -175,6 +175,7 @@ namespace almondnamespace::core
             case Vulkan:   return L"Vulkan";
             case DirectX:  return L"DirectX";
             case Noop:     return L"Noop";
+            case SoftwareHeadless: return L"Software (headless)";
             case Custom:   return L"Custom";
             default:       return L"Context";
             }
@@ -273,6 +273,7 @@ namespace almondnamespace::core
             case ContextType::Vulkan:   return L"Vulkan";
             case ContextType::DirectX:  return L"DirectX";
             case ContextType::Noop:     return L"Noop";
+            case ContextType::SoftwareHeadless: return L"Software (headless)";
             case ContextType::Custom:   return L"Custom";
             default:                    return L"Context";
             }
@@ -1589,6 +1590,17 @@ namespace almondnamespace::core
             ::FillRect(hdc, &ps.rcPaint, (HBRUSH)(COLOR_WINDOW + 1));
 #endif
             ::EndPaint(hwnd, &ps);
+
+#if defined(ALMOND_USING_SOFTWARE_RENDERER)
+            // The software renderer only presents tiles that changed, so it
+            // has to be told when the window contents were lost.
+            if (auto* mgr = s_activeInstance)
+            {
+                const WindowData* win = mgr->findWindowByHWND(hwnd);
+                if (win && win->type == ContextType::Software)
+                    almondnamespace::anativecontext::softrenderer_invalidate();
+            }
+#endif
             return 0;
         }
         case WM_CLOSE:
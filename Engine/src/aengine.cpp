@@ -87,6 +87,7 @@ import aengine.core.context;
 import aengine.gui;
 import aengine.gui.menu;
 import aeditor;
+import aengine.benchmarks;
 
 import ascene;
 
@@ -656,6 +657,9 @@ int WINAPI wWinMain(
             return 0;
         }
 
+        if (!cli_result.benchmark.empty())
+            return almondnamespace::benchmarks::run(cli_result.benchmark);
+
         if (cli_result.editor_requested)
         {
             almondnamespace::core::RunEditorInterface();
@@ -697,6 +701,9 @@ int main(int argc, char** argv)
             return 0;
         }
 
+        if (!cli_result.benchmark.empty())
+            return almondnamespace::benchmarks::run(cli_result.benchmark);
+
         if (cli_result.editor_requested)
         {
             almondnamespace::core::RunEditorInterface();
@@ -17,6 +17,7 @@
 
 #include <algorithm>
 #include <array>
+#include <bit>
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
@@ -94,8 +95,6 @@ namespace almondnamespace::gui
             const font::FontAsset* asset = nullptr;
             const TextureAtlas* atlas = nullptr;
             font::FontMetrics metrics{};
-            std::array<const font::Glyph*, 256> glyphLookup{};
-            const font::Glyph* fallbackGlyph = nullptr;
         };
 
         struct GuiResources
@@ -159,6 +158,95 @@ namespace almondnamespace::gui
         static thread_local std::vector<InputEvent> g_pendingEvents{};
         static thread_local const void* g_activeWidget = nullptr;
 
+        // Per-thread copies of the glyphs for bytes 0..255. Glyphs are baked on
+        // first use, so this fills lazily and resets when the glyph cache
+        // evicts (FontAsset::glyph_generation() moves).
+        struct GlyphLookup
+        {
+            enum State : std::uint8_t { Unknown, Present, Missing };
+
+            const font::FontAsset* asset = nullptr;
+            std::uint64_t generation = 0;
+            std::array<font::Glyph, 256> glyphs{};
+            std::array<State, 256> state{};
+        };
+
+        static thread_local GlyphLookup g_glyphLookup{};
+
+        // Laid-out text, keyed by (text, font, wrap width, scale). Quads are
+        // relative to the run's origin and shared with queued draw commands.
+        struct GlyphQuad
+        {
+            SpriteHandle handle{};
+            float x = 0.0f;
+            float y = 0.0f;
+            float w = 0.0f;
+            float h = 0.0f;
+        };
+
+        struct TextRun
+        {
+            std::string text{};
+            const font::FontAsset* font = nullptr;
+            std::uint64_t glyphGeneration = 0;
+            float width = -1.0f;
+            float scale = 1.0f;
+            float height = 0.0f;
+            float extent = 0.0f; // widest line
+            Vec2 end{};          // pen after the last glyph, at the top of its line
+            std::shared_ptr<const std::vector<GlyphQuad>> quads{};
+            std::uint64_t lastUsedFrame = 0;
+        };
+
+        constexpr std::size_t kTextRunCacheLimit = 1024;
+
+        static thread_local std::unordered_map<std::size_t, std::shared_ptr<TextRun>> g_textRuns{};
+        static thread_local std::uint64_t g_textFrame = 0;
+
+        // One entry of a window's draw list: a sprite, or a text run at (x, y).
+        struct DrawCmd
+        {
+            SpriteHandle handle{};
+            float x = 0.0f;
+            float y = 0.0f;
+            float w = 0.0f;
+            float h = 0.0f;
+            std::shared_ptr<const std::vector<GlyphQuad>> quads{};
+
+            bool operator==(const DrawCmd&) const = default;
+        };
+
+        using DrawList = std::vector<DrawCmd>;
+
+        // What a window keeps between frames: the text run behind each of its
+        // text calls, in call order, and the draw list it submitted last. A
+        // frame that records the same list resubmits the old one as is.
+        struct RetainedWindow
+        {
+            std::vector<std::shared_ptr<const TextRun>> texts{};
+            std::size_t nextText = 0;
+            DrawList recording{};
+            std::shared_ptr<const DrawList> submitted{};
+            std::uint64_t lastUsedFrame = 0;
+        };
+
+        constexpr std::size_t kRetainedWindowLimit = 64;
+
+        static thread_local std::unordered_map<std::size_t, RetainedWindow> g_windows{};
+        static thread_local RetainedWindow* g_window = nullptr; // between begin_window() and end_window()
+        static thread_local std::size_t g_windowOrdinal = 0;     // windows begun this frame
+
+        [[nodiscard]] static std::size_t text_run_key(
+            std::string_view text, const font::FontAsset* font, float width, float scale) noexcept
+        {
+            std::size_t seed = std::hash<std::string_view>{}(text);
+            auto mix = [&seed](std::size_t v) { seed ^= v + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2); };
+            mix(std::hash<const void*>{}(font));
+            mix(std::bit_cast<std::uint32_t>(width));
+            mix(std::bit_cast<std::uint32_t>(scale));
+            return seed;
+        }
+
         [[nodiscard]] static std::vector<std::uint8_t> make_solid_pixels(
             std::uint8_t r, std::uint8_t g, std::uint8_t b, std::uint8_t a,
             std::uint32_t w, std::uint32_t h)
@@ -277,33 +365,6 @@ namespace almondnamespace::gui
             return {};
         }
 
-        static void populate_font_lookup(GuiFontCache& fontCache)
-        {
-            fontCache.glyphLookup.fill(nullptr);
-            fontCache.fallbackGlyph = nullptr;
-
-            if (!fontCache.asset)
-                return;
-
-            for (const auto& [codepoint, glyph] : fontCache.asset->glyphs)
-            {
-                if (codepoint < static_cast<char32_t>(fontCache.glyphLookup.size()))
-                    fontCache.glyphLookup[static_cast<std::size_t>(codepoint)] = &glyph;
-            }
-
-            auto setFallback = [&](unsigned char ch)
-                {
-                    if (ch < fontCache.glyphLookup.size() && fontCache.glyphLookup[ch])
-                        fontCache.fallbackGlyph = fontCache.glyphLookup[ch];
-                };
-
-            setFallback(static_cast<unsigned char>('?'));
-            if (!fontCache.fallbackGlyph)
-                setFallback(static_cast<unsigned char>(' '));
-            if (!fontCache.fallbackGlyph && !fontCache.asset->glyphs.empty())
-                fontCache.fallbackGlyph = &fontCache.asset->glyphs.begin()->second;
-        }
-
         static void ensure_font_loaded_locked()
         {
             if (g_resources.font.asset)
@@ -332,7 +393,6 @@ namespace almondnamespace::gui
             }
 
             g_resources.font.metrics = g_resources.font.asset->metrics;
-            populate_font_lookup(g_resources.font);
 
             auto atlasVec = almondnamespace::atlasmanager::get_atlas_vector_snapshot(); // by value snapshot
             if (g_resources.font.asset->atlas_index >= 0 &&
@@ -340,15 +400,6 @@ namespace almondnamespace::gui
             {
                 g_resources.font.atlas = atlasVec[static_cast<std::size_t>(g_resources.font.asset->atlas_index)];
             }
-
-            if (!g_resources.font.atlas)
-            {
-                if (auto it = almondnamespace::atlasmanager::atlas_map.find("font_atlas");
-                    it != almondnamespace::atlasmanager::atlas_map.end())
-                {
-                    g_resources.font.atlas = it->second.get();
-                }
-            }
         }
 
         static void ensure_resources()
@@ -454,6 +505,12 @@ namespace almondnamespace::gui
             if (!handle.is_valid())
                 return;
 
+            if (g_window)
+            {
+                g_window->recording.push_back({ handle, x, y, w, h });
+                return;
+            }
+
             Context* ctx = g_frame.ctx;
             if (!ctx)
                 return;
@@ -533,11 +590,66 @@ namespace almondnamespace::gui
             return base_line_height(scale);
         }
 
+        // The glyph for byte `ch` (as Latin-1), asked of the font's glyph cache
+        // once and kept until that cache evicts anything.
+        [[nodiscard]] static const font::Glyph* resolve_glyph(unsigned char ch) noexcept
+        {
+            const font::FontAsset* asset = g_resources.font.asset;
+            if (!asset)
+                return nullptr;
+
+            GlyphLookup& lookup = g_glyphLookup;
+            const std::uint64_t generation = asset->glyph_generation();
+            if (lookup.asset != asset || lookup.generation != generation)
+            {
+                lookup.asset = asset;
+                lookup.generation = generation;
+                lookup.state.fill(GlyphLookup::Unknown);
+            }
+
+            if (lookup.state[ch] == GlyphLookup::Unknown)
+            {
+                std::optional<font::Glyph> glyph{};
+                try { glyph = asset->find_glyph(static_cast<char32_t>(ch)); }
+                catch (...) { /* GUI optional */ }
+
+                if (glyph)
+                    lookup.glyphs[ch] = *glyph;
+                lookup.state[ch] = glyph ? GlyphLookup::Present : GlyphLookup::Missing;
+            }
+
+            return lookup.state[ch] == GlyphLookup::Present ? &lookup.glyphs[ch] : nullptr;
+        }
+
+        // Pins this thread's resolved glyphs for the new frame: cached runs and
+        // retained draw lists still point at them.
+        static void begin_glyph_frame() noexcept
+        {
+            const font::FontAsset* asset = g_resources.font.asset;
+            if (!asset)
+                return;
+
+            std::array<char32_t, 256> inUse{};
+            std::size_t count = 0;
+            const GlyphLookup& lookup = g_glyphLookup;
+            if (lookup.asset == asset && lookup.generation == asset->glyph_generation())
+            {
+                for (std::size_t ch = 0; ch < lookup.state.size(); ++ch)
+                {
+                    if (lookup.state[ch] == GlyphLookup::Present)
+                        inUse[count++] = static_cast<char32_t>(ch);
+                }
+            }
+
+            try { asset->begin_glyph_frame({ inUse.data(), count }); }
+            catch (...) { /* GUI optional */ }
+        }
+
         [[nodiscard]] static float space_advance(float scale) noexcept
         {
             if (g_resources.font.metrics.spaceAdvance > 0.0f)
                 return g_resources.font.metrics.spaceAdvance * scale;
-            if (const auto* glyph = g_resources.font.glyphLookup[static_cast<unsigned char>(' ')])
+            if (const auto* glyph = resolve_glyph(static_cast<unsigned char>(' ')))
                 return glyph->advance * scale;
             if (g_resources.font.metrics.averageAdvance > 0.0f)
                 return g_resources.font.metrics.averageAdvance * scale;
@@ -557,13 +669,11 @@ namespace almondnamespace::gui
             if (!g_resources.font.asset)
                 return nullptr;
 
-            if (ch < g_resources.font.glyphLookup.size())
-            {
-                if (const auto* glyph = g_resources.font.glyphLookup[ch])
-                    return glyph;
-            }
-
-            return g_resources.font.fallbackGlyph;
+            if (const auto* glyph = resolve_glyph(ch))
+                return glyph;
+            if (const auto* glyph = resolve_glyph(static_cast<unsigned char>('?')))
+                return glyph;
+            return resolve_glyph(static_cast<unsigned char>(' '));
         }
 
         [[nodiscard]] static std::optional<unsigned char> next_drawable_char(std::string_view text, std::size_t index) noexcept
@@ -620,187 +730,288 @@ namespace almondnamespace::gui
             return advance;
         }
 
-        [[nodiscard]] static float measure_text_width(std::string_view text, float scale) noexcept
+        struct TextLayout
         {
-            float current = 0.0f;
-            float maxWidth = 0.0f;
-
-            for (std::size_t i = 0; i < text.size(); ++i)
-            {
-                const char ch = text[i];
-                if (ch == '\n')
-                {
-                    maxWidth = (std::max)(maxWidth, current);
-                    current = 0.0f;
-                    continue;
-                }
-                const auto next = next_drawable_char(text, i);
-                current += glyph_advance_with_kerning(static_cast<unsigned char>(ch), next, scale);
-            }
-            return (std::max)(maxWidth, current);
-        }
+            float height = 0.0f;
+            float extent = 0.0f; // widest line
+            Vec2 end{};          // pen after the last glyph, at the top of its line
+        };
 
-        [[nodiscard]] static float measure_wrapped_text_height(std::string_view text, float width, float scale) noexcept
+        // Lays the text out relative to (0, 0), appending glyph quads when
+        // `quads` is given: the same walk draw_wrapped_text() and
+        // draw_text_line() used to do per glyph, minus the drawing. A negative
+        // width means no wrapping.
+        static TextLayout layout_text(std::string_view text, float width, float scale, std::vector<GlyphQuad>* quads)
         {
-            ensure_resources();
-            const float effectiveWidth = (std::max)(space_advance(scale), width);
+            const bool wrap = width >= 0.0f;
+            const float effectiveWidth = wrap ? (std::max)(space_advance(scale), width) : 0.0f;
             const float lineAdvance = line_advance_amount(scale);
-            const float baseHeight = base_line_height(scale);
 
-            std::size_t lines = 1;
             float penX = 0.0f;
+            float baseline = baseline_offset(scale);
+            float extent = 0.0f;
+            std::size_t lines = 1;
 
             for (std::size_t i = 0; i < text.size(); ++i)
             {
                 const char ch = text[i];
                 if (ch == '\n')
                 {
-                    ++lines;
+                    extent = (std::max)(extent, penX);
                     penX = 0.0f;
+                    baseline += lineAdvance;
+                    ++lines;
                     continue;
                 }
 
                 const auto next = next_drawable_char(text, i);
                 const float advance = glyph_advance_with_kerning(static_cast<unsigned char>(ch), next, scale);
-                if (penX > 0.0f && penX + advance > effectiveWidth + 0.001f)
+                if (wrap && penX > 0.0f && penX + advance > effectiveWidth + 0.001f)
                 {
-                    ++lines;
+                    extent = (std::max)(extent, penX);
                     penX = 0.0f;
+                    baseline += lineAdvance;
+                    ++lines;
+                }
+
+                if (quads && (!wrap || (ch != ' ' && ch != '\t')))
+                {
+                    if (const auto* glyph = lookup_glyph(static_cast<unsigned char>(ch)))
+                    {
+                        const float drawW = glyph->size_px.x * scale;
+                        const float drawH = glyph->size_px.y * scale;
+                        if (glyph->handle.is_valid() && (!wrap || (drawW > 0.0f && drawH > 0.0f)))
+                        {
+                            quads->push_back({ glyph->handle,
+                                penX + glyph->offset_px.x * scale,
+                                baseline + glyph->offset_px.y * scale,
+                                drawW, drawH });
+                        }
+                    }
                 }
 
                 penX += advance;
             }
 
-            const float totalHeight = baseHeight + static_cast<float>(lines - 1) * lineAdvance;
-            return (std::max)(baseHeight, totalHeight);
+            return {
+                base_line_height(scale) + static_cast<float>(lines - 1) * lineAdvance,
+                (std::max)(extent, penX),
+                { penX, baseline - baseline_offset(scale) }
+            };
         }
 
-        [[nodiscard]] static Vec2 compute_caret_position(std::string_view text, float x, float y, float width, float scale) noexcept
+        // The layout, measurements and caret position of run.text, so widgets
+        // need not walk the text again.
+        static void layout_text_run(TextRun& run)
         {
-            ensure_resources();
-            const float effectiveWidth = (std::max)(space_advance(scale), width);
-            const float lineAdvance = line_advance_amount(scale);
+            auto quads = std::make_shared<std::vector<GlyphQuad>>();
+            quads->reserve(run.text.size());
+
+            const TextLayout layout = layout_text(run.text, run.width, run.scale, quads.get());
+            run.height = layout.height;
+            run.extent = layout.extent;
+            run.end = layout.end;
+            run.quads = std::move(quads);
+        }
 
-            float penX = x;
-            float baseline = y + baseline_offset(scale);
+        // Returns the cached layout for `text`, building it on a miss. A negative
+        // width means no wrapping. Runs unused for a couple of frames are dropped
+        // once the cache grows past kTextRunCacheLimit.
+        [[nodiscard]] static bool text_run_matches(const TextRun& run, std::string_view text,
+            const font::FontAsset* font, std::uint64_t glyphGeneration, float width, float scale) noexcept
+        {
+            return run.font == font && run.glyphGeneration == glyphGeneration
+                && run.width == width && run.scale == scale && run.text == text;
+        }
 
-            for (std::size_t i = 0; i < text.size(); ++i)
-            {
-                const char ch = text[i];
-                if (ch == '\n')
-                {
-                    penX = x;
-                    baseline += lineAdvance;
-                    continue;
-                }
+        [[nodiscard]] static std::shared_ptr<const TextRun> acquire_text_run(std::string_view text, float width, float scale)
+        {
+            const font::FontAsset* font = g_resources.font.asset;
+            const std::uint64_t glyphGeneration = font ? font->glyph_generation() : 0;
+            const std::size_t key = text_run_key(text, font, width, scale);
 
-                const auto next = next_drawable_char(text, i);
-                const float advance = glyph_advance_with_kerning(static_cast<unsigned char>(ch), next, scale);
-                if (penX > x && penX + advance > x + effectiveWidth + 0.001f)
+            auto it = g_textRuns.find(key);
+            if (it != g_textRuns.end())
+            {
+                const auto& run = it->second;
+                if (text_run_matches(*run, text, font, glyphGeneration, width, scale))
                 {
-                    penX = x;
-                    baseline += lineAdvance;
+                    run->lastUsedFrame = g_textFrame;
+                    return run;
                 }
+            }
 
-                penX += advance;
+            if (it == g_textRuns.end() && g_textRuns.size() >= kTextRunCacheLimit)
+            {
+                const std::uint64_t frame = g_textFrame;
+                std::erase_if(g_textRuns, [frame](const auto& entry) {
+                    return entry.second->lastUsedFrame + 1 < frame;
+                });
+                it = g_textRuns.end();
             }
 
-            const float caretTop = baseline - baseline_offset(scale);
-            return { penX, caretTop };
+            auto run = std::make_shared<TextRun>();
+            run->text.assign(text);
+            run->font = font;
+            run->width = width;
+            run->scale = scale;
+            layout_text_run(*run);
+            // Glyphs found during layout are pinned for the frame, so an
+            // eviction layout caused cannot touch them; tag the run after it.
+            run->glyphGeneration = font ? font->glyph_generation() : 0;
+            run->lastUsedFrame = g_textFrame;
+
+            if (it != g_textRuns.end())
+                it->second = run; // hash collision: the newest text wins
+            else
+                g_textRuns.emplace(key, run);
+            return run;
         }
 
-        static float draw_wrapped_text(std::string_view text, float x, float y, float width, float scale)
+        // acquire_text_run() for the next text call of the current window. The
+        // window remembers the run each call got last frame, so a widget whose
+        // text, width and font are unchanged only compares the text.
+        [[nodiscard]] static std::shared_ptr<const TextRun> text_run(std::string_view text, float width, float scale)
         {
-            ensure_resources();
-            if (!g_frame.ctx || !g_resources.font.asset)
-                return 0.0f;
+            if (!g_window)
+                return acquire_text_run(text, width, scale);
+
+            RetainedWindow& window = *g_window;
+            if (window.nextText == window.texts.size())
+                window.texts.emplace_back();
+            auto& slot = window.texts[window.nextText++];
+
+            const font::FontAsset* font = g_resources.font.asset;
+            const std::uint64_t glyphGeneration = font ? font->glyph_generation() : 0;
+            if (!slot || !text_run_matches(*slot, text, font, glyphGeneration, width, scale))
+                slot = acquire_text_run(text, width, scale);
+            return slot;
+        }
 
-            const float effectiveWidth = (std::max)(space_advance(scale), width);
-            const float lineAdvance = line_advance_amount(scale);
-            const float ascent = baseline_offset(scale);
-            const float baseHeight = base_line_height(scale);
+        // Submits a whole run as one command: a single queue entry and atlas
+        // snapshot instead of one of each per glyph.
+        static void draw_text_run(const TextRun& run, float x, float y)
+        {
+            Context* ctx = g_frame.ctx;
+            if (!ctx || !run.quads || run.quads->empty())
+                return;
 
-            float penX = x;
-            float baseline = y + ascent;
-            std::size_t lines = 1;
+            if (g_window)
+            {
+                g_window->recording.push_back({ SpriteHandle{}, x, y, 0.0f, 0.0f, run.quads });
+                return;
+            }
 
-            for (std::size_t i = 0; i < text.size(); ++i)
+            if (ctx->windowData && g_frame.ctxShared)
             {
-                const char ch = text[i];
-                if (ch == '\n')
+                auto ctxShared = g_frame.ctxShared;
+                const core::RenderPath renderPath = render_path_for_context(ctx);
+
+                ctx->windowData->commandQueue.enqueue([ctxShared, quads = run.quads, x, y]()
+                    {
+                        if (!ctxShared)
+                            return;
+
+                        auto atlases = almondnamespace::atlasmanager::get_atlas_vector_snapshot();
+                        std::span<const TextureAtlas* const> span(atlases.data(), atlases.size());
+                        for (const GlyphQuad& q : *quads)
+                            ctxShared->draw_sprite_safe(q.handle, span, x + q.x, y + q.y, q.w, q.h);
+                    }, renderPath);
+
+                return;
+            }
+
+            bool onRenderThread = false;
+            if (auto current = core::MultiContextManager::GetCurrent())
+                onRenderThread = (current.get() == ctx);
+
+            if (!ctx->windowData || onRenderThread)
+            {
+                auto atlases = almondnamespace::atlasmanager::get_atlas_vector_snapshot();
+                std::span<const TextureAtlas* const> span(atlases.data(), atlases.size());
+                for (const GlyphQuad& q : *run.quads)
+                    ctx->draw_sprite_safe(q.handle, span, x + q.x, y + q.y, q.w, q.h);
+            }
+        }
+
+        static void draw_draw_list(Context& ctx, const DrawList& list)
+        {
+            auto atlases = almondnamespace::atlasmanager::get_atlas_vector_snapshot();
+            std::span<const TextureAtlas* const> span(atlases.data(), atlases.size());
+            for (const DrawCmd& cmd : list)
+            {
+                if (!cmd.quads)
                 {
-                    penX = x;
-                    baseline += lineAdvance;
-                    ++lines;
+                    ctx.draw_sprite_safe(cmd.handle, span, cmd.x, cmd.y, cmd.w, cmd.h);
                     continue;
                 }
+                for (const GlyphQuad& q : *cmd.quads)
+                    ctx.draw_sprite_safe(q.handle, span, cmd.x + q.x, cmd.y + q.y, q.w, q.h);
+            }
+        }
 
-                const auto next = next_drawable_char(text, i);
-                const float advance = glyph_advance_with_kerning(static_cast<unsigned char>(ch), next, scale);
-                if (penX > x && penX + advance > x + effectiveWidth + 0.001f)
-                {
-                    penX = x;
-                    baseline += lineAdvance;
-                    ++lines;
-                }
+        // Submits a window's whole draw list as one command.
+        static void submit_draw_list(const std::shared_ptr<const DrawList>& list)
+        {
+            Context* ctx = g_frame.ctx;
+            if (!ctx || !list || list->empty())
+                return;
 
-                if (ch != ' ' && ch != '\t')
-                {
-                    if (const auto* glyph = lookup_glyph(static_cast<unsigned char>(ch)))
+            if (ctx->windowData && g_frame.ctxShared)
+            {
+                const core::RenderPath renderPath = render_path_for_context(ctx);
+                ctx->windowData->commandQueue.enqueue([ctxShared = g_frame.ctxShared, list]()
                     {
-                        const float drawW = glyph->size_px.x * scale;
-                        const float drawH = glyph->size_px.y * scale;
-                        if (glyph->handle.is_valid() && drawW > 0.0f && drawH > 0.0f)
-                        {
-                            const float offsetX = glyph->offset_px.x * scale;
-                            const float offsetY = glyph->offset_px.y * scale;
-                            draw_sprite(glyph->handle, penX + offsetX, baseline + offsetY, drawW, drawH);
-                        }
-                    }
-                }
-
-                penX += advance;
+                        if (ctxShared)
+                            draw_draw_list(*ctxShared, *list);
+                    }, renderPath);
+                return;
             }
 
-            return baseHeight + static_cast<float>(lines - 1) * lineAdvance;
+            bool onRenderThread = false;
+            if (auto current = core::MultiContextManager::GetCurrent())
+                onRenderThread = (current.get() == ctx);
+
+            if (!ctx->windowData || onRenderThread)
+                draw_draw_list(*ctx, *list);
         }
 
-        static void draw_text_line(std::string_view text, float x, float y, float scale, std::optional<float> indent = std::nullopt)
+        // Ends the current window's recording. An unchanged list is resubmitted
+        // as last frame's shared copy; the recording keeps its capacity.
+        static void flush_window()
         {
-            ensure_resources();
-            if (!g_frame.ctx || !g_resources.font.asset)
+            if (!g_window)
                 return;
 
-            const float anchorX = indent.value_or(x);
-            float penX = anchorX;
-            float baseline = y + baseline_offset(scale);
-            const float lineAdvance = line_advance_amount(scale);
+            RetainedWindow& window = *g_window;
+            g_window = nullptr;
 
-            for (std::size_t i = 0; i < text.size(); ++i)
-            {
-                const char ch = text[i];
-                if (ch == '\n')
-                {
-                    penX = anchorX;
-                    baseline += lineAdvance;
-                    continue;
-                }
+            window.texts.resize(window.nextText);
+            if (!window.submitted || *window.submitted != window.recording)
+                window.submitted = std::make_shared<const DrawList>(window.recording);
+            window.recording.clear();
 
-                if (const auto* glyph = lookup_glyph(static_cast<unsigned char>(ch)))
-                {
-                    if (glyph->handle.is_valid())
-                    {
-                        const float drawW = glyph->size_px.x * scale;
-                        const float drawH = glyph->size_px.y * scale;
-                        const float offsetX = glyph->offset_px.x * scale;
-                        const float offsetY = glyph->offset_px.y * scale;
-                        draw_sprite(glyph->handle, penX + offsetX, baseline + offsetY, drawW, drawH);
-                    }
-                }
+            submit_draw_list(window.submitted);
+        }
 
-                const auto next = next_drawable_char(text, i);
-                penX += glyph_advance_with_kerning(static_cast<unsigned char>(ch), next, scale);
-            }
+        static float draw_wrapped_text(std::string_view text, float x, float y, float width, float scale)
+        {
+            ensure_resources();
+            if (!g_frame.ctx || !g_resources.font.asset)
+                return 0.0f;
+
+            const auto run = text_run(text, (std::max)(0.0f, width), scale);
+            draw_text_run(*run, x, y);
+            return run->height;
+        }
+
+        static void draw_text_line(std::string_view text, float x, float y, float scale, std::optional<float> indent = std::nullopt)
+        {
+            ensure_resources();
+            if (!g_frame.ctx || !g_resources.font.asset)
+                return;
+
+            draw_text_run(*text_run(text, -1.0f, scale), indent.value_or(x), y);
         }
 
         static void draw_caret(float x, float y, float height)
@@ -809,6 +1020,13 @@ namespace almondnamespace::gui
             draw_sprite(g_resources.buttonActive, x, y, caretWidth, height);
         }
 
+        // A console line's slot: its wrapped height plus the paragraph gap.
+        [[nodiscard]] static float console_line_height(std::string_view text, float width, float scale)
+        {
+            const float paragraphGap = (std::max)(0.0f, line_advance_amount(scale) - base_line_height(scale));
+            return layout_text(text, width, scale, nullptr).height + paragraphGap;
+        }
+
         static void reset_frame()
         {
             g_frame.cursor = {};
@@ -853,6 +1071,18 @@ namespace almondnamespace::gui
         g_frame.ctxShared = ctx;
         g_frame.ctx = rawCtx;
         g_frame.deltaTime = dt;
+        ++g_textFrame;
+        begin_glyph_frame();
+
+        g_window = nullptr;
+        g_windowOrdinal = 0;
+        if (g_windows.size() > kRetainedWindowLimit)
+        {
+            const std::uint64_t frame = g_textFrame;
+            std::erase_if(g_windows, [frame](const auto& entry) {
+                return entry.second.lastUsedFrame + 1 < frame;
+            });
+        }
 
         g_frame.caretTimer += dt;
         while (g_frame.caretTimer >= kCaretBlinkPeriod)
@@ -893,6 +1123,9 @@ namespace almondnamespace::gui
 
     void end_frame() noexcept
     {
+        try { flush_window(); }
+        catch (...) { /* GUI optional */ }
+
         g_frame.ctxShared.reset();
         g_frame.ctx = nullptr;
         g_frame.insideWindow = false;
@@ -908,6 +1141,21 @@ namespace almondnamespace::gui
         try { ensure_resources(); }
         catch (...) { return; }
 
+        try
+        {
+            flush_window();
+
+            // Windows are told apart by title and by their order in the frame.
+            std::size_t key = std::hash<std::string_view>{}(title);
+            key ^= g_windowOrdinal++ + 0x9e3779b97f4a7c15ull + (key << 6) + (key >> 2);
+            RetainedWindow& window = g_windows[key];
+            window.nextText = 0;
+            window.recording.clear();
+            window.lastUsedFrame = g_textFrame;
+            g_window = &window;
+        }
+        catch (...) { g_window = nullptr; } // draws go out one by one instead
+
         g_frame.origin = position;
         g_frame.windowSize = size;
         g_frame.insideWindow = true;
@@ -926,6 +1174,8 @@ namespace almondnamespace::gui
 
     void end_window() noexcept
     {
+        try { flush_window(); }
+        catch (...) { g_window = nullptr; }
         g_frame.insideWindow = false;
     }
 
@@ -948,12 +1198,12 @@ namespace almondnamespace::gui
 
         draw_sprite(background, pos.x, pos.y, width, height);
 
-        const float textWidth = measure_text_width(label, kFontScale);
+        const auto run = text_run(label, -1.0f, kFontScale);
         const float textHeight = lineAdvance;
-        const float textX = pos.x + (std::max)(0.0f, (width - textWidth) * 0.5f);
+        const float textX = pos.x + (std::max)(0.0f, (width - run->extent) * 0.5f);
         const float textY = pos.y + (std::max)(0.0f, (height - textHeight) * 0.5f);
 
-        draw_text_line(label, textX, textY, kFontScale);
+        draw_text_run(*run, textX, textY);
 
         g_frame.lastButtonBounds = WidgetBounds{ .position = pos, .size = { width, height } };
         advance_cursor({ 0.0f, height + kContentPadding });
@@ -1122,17 +1372,15 @@ namespace almondnamespace::gui
             }
         }
 
-        // Create view after edits.
-        const std::string_view sv{ text };
-
-        if (multiline) draw_wrapped_text(sv, textX, textY, contentWidth, kFontScale);
-        else           draw_text_line(sv, textX, textY, kFontScale);
+        // Lay out after edits; the same run places the caret.
+        const auto run = text_run(text, multiline ? contentWidth : -1.0f, kFontScale);
+        draw_text_run(*run, textX, textY);
 
         if (active && g_frame.caretVisible)
         {
             const Vec2 caret = multiline
-                ? compute_caret_position(sv, textX, textY, contentWidth, kFontScale)
-                : Vec2{ textX + measure_text_width(sv, kFontScale), textY };
+                ? Vec2{ textX + run->end.x, textY + run->end.y }
+                : Vec2{ textX + run->extent, textY };
 
             const float caretHeight = multiline ? (std::min)(contentHeight, baseHeight) : baseHeight;
 
@@ -1161,7 +1409,7 @@ namespace almondnamespace::gui
         float width = static_cast<float>(size.x);
         if (width <= 0.0f)
         {
-            const float estimated = measure_text_width(text, kFontScale) + 2.0f * kBoxInnerPadding;
+            const float estimated = text_run(text, -1.0f, kFontScale)->extent + 2.0f * kBoxInnerPadding;
             width = (std::max)(minWidth, estimated);
         }
         else
@@ -1170,12 +1418,12 @@ namespace almondnamespace::gui
         }
 
         const float contentWidth = (std::max)(1.0f, width - 2.0f * kBoxInnerPadding);
+        const auto run = text_run(text, contentWidth, kFontScale);
 
         float height = static_cast<float>(size.y);
         if (height <= 0.0f)
         {
-            const float textHeight = measure_wrapped_text_height(text, contentWidth, kFontScale);
-            height = textHeight + 2.0f * kBoxInnerPadding;
+            height = run->height + 2.0f * kBoxInnerPadding;
         }
         else
         {
@@ -1183,11 +1431,149 @@ namespace almondnamespace::gui
         }
 
         draw_sprite(g_resources.panelBackground, pos.x, pos.y, width, height);
-        draw_wrapped_text(text, pos.x + kBoxInnerPadding, pos.y + kBoxInnerPadding, contentWidth, kFontScale);
+        draw_text_run(*run, pos.x + kBoxInnerPadding, pos.y + kBoxInnerPadding);
 
         advance_cursor({ 0.0f, height + kContentPadding });
     }
 
+    ConsoleScrollback::ConsoleScrollback(std::size_t capacity)
+        : capacity_((std::max)(std::size_t{ 1 }, capacity))
+    {
+    }
+
+    void ConsoleScrollback::push(std::string line)
+    {
+        if (count_ < capacity_)
+        {
+            const std::size_t index = slot(count_);
+            if (index == lines_.size())
+            {
+                lines_.push_back(std::move(line));
+                tops_.push_back(end_);
+            }
+            else
+            {
+                lines_[index] = std::move(line);
+            }
+            ++count_;
+            ++unmeasured_;
+            return;
+        }
+
+        // Full: the oldest line gives its slot to the new one. A scrolled view
+        // moves up with the content so it keeps showing the same lines.
+        if (unmeasured_ < count_)
+        {
+            const double next = count_ > 1 && unmeasured_ < count_ - 1 ? tops_[slot(1)] : end_;
+            if (!follow_)
+                offset_ = (std::max)(0.0f, offset_ - static_cast<float>(next - tops_[head_]));
+        }
+        else
+        {
+            --unmeasured_;
+        }
+
+        lines_[head_] = std::move(line);
+        head_ = (head_ + 1) % capacity_;
+        ++unmeasured_;
+    }
+
+    void ConsoleScrollback::clear() noexcept
+    {
+        lines_.clear();
+        tops_.clear();
+        head_ = 0;
+        count_ = 0;
+        unmeasured_ = 0;
+        end_ = 0.0;
+        offset_ = 0.0f;
+        follow_ = true;
+    }
+
+    float ConsoleScrollback::content_height() const noexcept
+    {
+        return measured() > 0 ? static_cast<float>(end_ - tops_[head_]) : 0.0f;
+    }
+
+    float ConsoleScrollback::line_top(std::size_t index) const noexcept
+    {
+        if (index >= measured())
+            return content_height();
+        return static_cast<float>(tops_[slot(index)] - tops_[head_]);
+    }
+
+    // The last measured line starting at or above `offset`. Tops are compared
+    // as line_top() returns them, so line_at(line_top(i)) is i even where the
+    // float offset rounds below the running sum.
+    std::size_t ConsoleScrollback::line_at(float offset) const noexcept
+    {
+        const std::size_t count = measured();
+        if (count == 0)
+            return 0;
+
+        const double base = tops_[head_];
+        std::size_t lo = 0;
+        std::size_t hi = count;
+        while (lo < hi)
+        {
+            const std::size_t mid = lo + (hi - lo) / 2;
+            if (static_cast<float>(tops_[slot(mid)] - base) <= offset)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        return lo > 0 ? lo - 1 : 0;
+    }
+
+    void ConsoleScrollback::scroll_to(float offset) noexcept
+    {
+        offset_ = (std::max)(0.0f, offset);
+        follow_ = false;
+    }
+
+    void ConsoleScrollback::scroll_to_line(std::size_t index) noexcept
+    {
+        scroll_to(line_top((std::min)(index, count_)));
+    }
+
+    void ConsoleScrollback::scroll_to_end() noexcept
+    {
+        follow_ = true;
+    }
+
+    void ConsoleScrollback::update_layout(float width, float scale, const void* font, LineMeasure measure, float view_height)
+    {
+        if (width != layoutWidth_ || scale != layoutScale_ || font != layoutFont_)
+        {
+            // Keep a scrolled view on the same line across the relayout.
+            const std::size_t anchor = follow_ ? 0 : line_at(offset_);
+            layoutWidth_ = width;
+            layoutScale_ = scale;
+            layoutFont_ = font;
+            unmeasured_ = count_;
+            end_ = 0.0;
+
+            for (std::size_t i = 0; i < count_; ++i)
+            {
+                tops_[slot(i)] = end_;
+                end_ += measure(line(i), width, scale);
+            }
+            unmeasured_ = 0;
+            if (!follow_)
+                offset_ = line_top(anchor);
+        }
+
+        for (; unmeasured_ > 0; --unmeasured_)
+        {
+            const std::size_t index = slot(count_ - unmeasured_);
+            tops_[index] = end_;
+            end_ += measure(lines_[index], width, scale);
+        }
+
+        const float maxOffset = (std::max)(0.0f, content_height() - view_height);
+        offset_ = follow_ ? maxOffset : (std::min)(offset_, maxOffset);
+    }
+
     ConsoleWindowResult console_window(const ConsoleWindowOptions& options, std::string& input)
     {
         ConsoleWindowResult result{};
@@ -1221,7 +1607,28 @@ namespace almondnamespace::gui
         float penY = logPos.y + kBoxInnerPadding;
         const float maxY = logPos.y + (std::max)(0.0f, logHeight - kBoxInnerPadding);
 
-        if (!options.lines.empty() && logHeight > 0.0f)
+        if (options.scrollback && logHeight > 0.0f)
+        {
+            // Only the lines in view are laid out; the first is the one at the
+            // scroll offset, or the next when that one would be cut off.
+            ConsoleScrollback& scrollback = *options.scrollback;
+            const float viewHeight = (std::max)(0.0f, maxY - penY);
+            scrollback.update_layout(contentWidth, kFontScale, g_resources.font.asset, &console_line_height, viewHeight);
+
+            const float offset = scrollback.scroll_offset();
+            std::size_t first = scrollback.line_at(offset);
+            if (first + 1 < scrollback.measured() && scrollback.line_top(first) + 0.5f < offset)
+                ++first;
+
+            const float firstTop = scrollback.line_top(first);
+            for (std::size_t i = first; i < scrollback.measured(); ++i)
+            {
+                const float y = penY + (scrollback.line_top(i) - firstTop);
+                if (y > maxY) break;
+                draw_wrapped_text(scrollback.line(i), logPos.x + kBoxInnerPadding, y, contentWidth, kFontScale);
+            }
+        }
+        else if (!options.lines.empty() && logHeight > 0.0f)
         {
             const std::size_t count = options.lines.size();
             const std::size_t start = (count > options.max_visible_lines) ? (count - options.max_visible_lines) : 0;
@@ -47,139 +47,605 @@ namespace almondnamespace::font
 
             return buffer;
         }
-    }
 
-    almondnamespace::font::FontRenderer::FontRenderer(logger::Logger* log)
-        : logger_(log)
-    {
-    }
+        // Horizontal/vertical oversampling, as the packed bake used.
+        constexpr int kOversample = 2;
 
-    bool FontRenderer::load_font(const std::string& name,
-        const std::string& path,
-        float size_pt)
-    {
-        if (loaded_fonts_.contains(name))
-            return false;
+        // Empty texels around every glyph cell so filtering never reaches a
+        // neighbour.
+        constexpr std::uint32_t kGutter = 1;
 
-        FontAsset asset{};
-        asset.name = name;
-        asset.path = path;
-        asset.size_pt = size_pt;
+        // Distance-field bake: the field runs kSdfPadding texels past the
+        // outline, 128 on the edge and kSdfDistScale per texel, so it reaches 0
+        // at the padding border. The atlas advertises the same scale.
+        constexpr int kSdfPadding = 4;
+        constexpr unsigned char kSdfOnEdge = 128;
+        constexpr float kSdfDistScale = 32.0f;
 
-        std::vector<std::pair<char32_t, BakedGlyph>> baked_glyphs{};
-        Texture raw_texture{};
-        FontMetrics metrics{};
-        std::unordered_map<std::uint64_t, float> kerning_pairs{};
+        // The ranges whose advances feed FontMetrics and whose pairs are kerned.
+        constexpr std::array<std::pair<int, int>, 2> kMetricRanges{ {
+            {32, 126},
+            {160, 255}
+        } };
 
-        if (!load_and_bake_font(path, size_pt, baked_glyphs, metrics, kerning_pairs, raw_texture))
+        // The kerned codepoints grouped by glyph; `slot` maps a glyph id to its
+        // group or -1.
+        struct KernGlyphs
         {
-            std::cerr << "[FontRenderer] Failed to bake font '" << name << "' from '" << path << "'\n";
-            return false;
+            std::vector<int> slot{};
+            std::vector<int> glyph{};
+            std::vector<std::vector<char32_t>> codepoints{};
+        };
+
+        void emit_pairs(const KernGlyphs& glyphs, int left, int right, int advance,
+            float scale, std::vector<KerningPair>& out)
+        {
+            if (advance == 0)
+                return;
+            for (const char32_t l : glyphs.codepoints[left])
+                for (const char32_t r : glyphs.codepoints[right])
+                    out.push_back({ (static_cast<std::uint64_t>(l) << 32) | r, static_cast<float>(advance) * scale });
         }
 
-        if (raw_texture.empty())
+        // Every kerned pair among `glyphs`, read straight from the tables
+        // rather than probed pair by pair; the cost follows the table size and
+        // the number of pairs found. The values match stbtt_GetGlyphKernAdvance:
+        // GPOS when the font has it, else the first 'kern' subtable, and for
+        // GPOS the first pair-adjustment subtable that covers the left glyph
+        // decides (a format 1 subtable without the pair passes it on).
+        void collect_kerning(const stbtt_fontinfo& font, const KernGlyphs& glyphs,
+            float scale, std::vector<KerningPair>& out)
         {
-            std::cerr << "[FontRenderer] Baked texture for font '" << name << "' is empty\n";
-            return false;
+            const auto in_set = [&](int glyph) {
+                return glyph >= 0 && glyph < static_cast<int>(glyphs.slot.size()) ? glyphs.slot[glyph] : -1;
+            };
+
+            if (!font.gpos)
+            {
+                const int length = stbtt_GetKerningTableLength(&font);
+                std::vector<stbtt_kerningentry> table(static_cast<std::size_t>(length));
+                const int count = length > 0 ? stbtt_GetKerningTable(&font, table.data(), length) : 0;
+                for (int i = 0; i < count; ++i)
+                {
+                    const int left = in_set(table[i].glyph1);
+                    const int right = in_set(table[i].glyph2);
+                    if (left >= 0 && right >= 0)
+                        emit_pairs(glyphs, left, right, table[i].advance, scale, out);
+                }
+                return;
+            }
+
+            stbtt_uint8* const data = font.data + font.gpos;
+            if (ttUSHORT(data + 0) != 1 || ttUSHORT(data + 2) != 0)
+                return; // stb reads GPOS 1.0 only
+
+            // The pair-adjustment subtables in lookup order. Class-based ones
+            // get the kerned glyphs bucketed by right-hand class up front.
+            struct PairTable
+            {
+                stbtt_uint8* table = nullptr;
+                int format = 0;
+                bool supported = false;
+                std::vector<std::uint32_t> class_start{};   // bucket c is [class_start[c], class_start[c + 1])
+                std::vector<std::uint32_t> class_members{};
+            };
+
+            const std::size_t count = glyphs.glyph.size();
+            std::vector<PairTable> tables{};
+            stbtt_uint8* const lookup_list = data + ttUSHORT(data + 8);
+            const int lookup_count = ttUSHORT(lookup_list);
+            for (int lookup = 0; lookup < lookup_count; ++lookup)
+            {
+                stbtt_uint8* const lookup_table = lookup_list + ttUSHORT(lookup_list + 2 + 2 * lookup);
+                if (ttUSHORT(lookup_table) != 2)
+                    continue;
+
+                const int subtable_count = ttUSHORT(lookup_table + 4);
+                for (int sub = 0; sub < subtable_count; ++sub)
+                {
+                    PairTable& pt = tables.emplace_back();
+                    pt.table = lookup_table + ttUSHORT(lookup_table + 6 + 2 * sub);
+                    pt.format = ttUSHORT(pt.table);
+                    // stb handles only an x advance on the first glyph.
+                    pt.supported = (pt.format == 1 || pt.format == 2)
+                        && ttUSHORT(pt.table + 4) == 4 && ttUSHORT(pt.table + 6) == 0;
+                    if (!pt.supported || pt.format != 2)
+                        continue;
+
+                    stbtt_uint8* const class_def2 = pt.table + ttUSHORT(pt.table + 10);
+                    const std::uint32_t class2_count = ttUSHORT(pt.table + 14);
+                    std::vector<std::uint32_t> classes(count);
+                    pt.class_start.assign(class2_count + 2, 0);
+                    for (std::size_t r = 0; r < count; ++r)
+                    {
+                        const int c = stbtt__GetGlyphClass(class_def2, glyphs.glyph[r]);
+                        classes[r] = c >= 0 && static_cast<std::uint32_t>(c) < class2_count
+                            ? static_cast<std::uint32_t>(c) : class2_count; // malformed: never kerned
+                        ++pt.class_start[classes[r] + 1];
+                    }
+                    for (std::uint32_t c = 0; c <= class2_count; ++c)
+                        pt.class_start[c + 1] += pt.class_start[c];
+                    std::vector<std::uint32_t> cursor(pt.class_start.begin(), pt.class_start.end() - 1);
+                    pt.class_members.resize(count);
+                    for (std::size_t r = 0; r < count; ++r)
+                        pt.class_members[cursor[classes[r]]++] = static_cast<std::uint32_t>(r);
+                }
+            }
+
+            // decided[r] == left + 1 once a subtable has settled (left, r).
+            std::vector<std::size_t> decided(count, 0);
+            for (std::size_t left = 0; left < count; ++left)
+            {
+                const std::size_t mark = left + 1;
+                for (const PairTable& pt : tables)
+                {
+                    const int coverage_index = stbtt__GetCoverageIndex(pt.table + ttUSHORT(pt.table + 2), glyphs.glyph[left]);
+                    if (coverage_index < 0)
+                        continue;
+                    if (!pt.supported)
+                        break;
+
+                    if (pt.format == 1)
+                    {
+                        if (coverage_index >= ttUSHORT(pt.table + 8))
+                            break;
+                        // A pair set without the pair passes it to the next subtable.
+                        stbtt_uint8* const pair_set = pt.table + ttUSHORT(pt.table + 10 + 2 * coverage_index);
+                        const int pair_count = ttUSHORT(pair_set);
+                        for (int p = 0; p < pair_count; ++p)
+                        {
+                            stbtt_uint8* const pair = pair_set + 2 + 4 * p;
+                            const int right = in_set(ttUSHORT(pair));
+                            if (right < 0 || decided[right] == mark)
+                                continue;
+                            decided[right] = mark;
+                            emit_pairs(glyphs, static_cast<int>(left), right, ttSHORT(pair + 2), scale, out);
+                        }
+                        continue;
+                    }
+
+                    const int class1 = stbtt__GetGlyphClass(pt.table + ttUSHORT(pt.table + 8), glyphs.glyph[left]);
+                    const std::uint32_t class1_count = ttUSHORT(pt.table + 12);
+                    const std::uint32_t class2_count = ttUSHORT(pt.table + 14);
+                    if (class1 >= 0 && static_cast<std::uint32_t>(class1) < class1_count)
+                    {
+                        stbtt_uint8* const row = pt.table + 16 + 2 * (static_cast<std::size_t>(class1) * class2_count);
+                        for (std::uint32_t c = 0; c < class2_count; ++c)
+                        {
+                            const int advance = ttSHORT(row + 2 * c);
+                            if (advance == 0)
+                                continue;
+                            for (std::uint32_t m = pt.class_start[c]; m < pt.class_start[c + 1]; ++m)
+                                if (decided[pt.class_members[m]] != mark)
+                                    emit_pairs(glyphs, static_cast<int>(left), static_cast<int>(pt.class_members[m]), advance, scale, out);
+                        }
+                    }
+                    break; // a class-based subtable settles every pair for this glyph
+                }
+            }
         }
+    }
 
-        raw_texture.name = name;
+    struct GlyphCache::Source
+    {
+        std::vector<unsigned char> data{};
+        stbtt_fontinfo info{};
+        float scale = 1.0f;
+        std::vector<unsigned char> mono{};  // scratch: one rasterised glyph
+        std::vector<std::uint8_t> rgba{};   // scratch: one glyph cell
+    };
+
+    GlyphCache::GlyphCache() = default;
+    GlyphCache::~GlyphCache() = default;
+
+    bool GlyphCache::init(std::vector<unsigned char> font_data,
+        float pixel_height,
+        const std::string& atlas_name,
+        GlyphBake bake,
+        std::uint32_t page_size)
+    {
+        if (font_data.empty() || pixel_height <= 0.0f || page_size == 0)
+            return false;
+
+        auto source = std::make_unique<Source>();
+        source->data = std::move(font_data);
+
+        const int font_offset = stbtt_GetFontOffsetForIndex(source->data.data(), 0);
+        if (font_offset < 0 || !stbtt_InitFont(&source->info, source->data.data(), font_offset))
+            return false;
+        source->scale = stbtt_ScaleForPixelHeight(&source->info, pixel_height);
 
-        static std::mutex atlas_mutex;
-        const std::string atlas_name = "font_atlas";
         if (!atlasmanager::get_registrar(atlas_name))
         {
             atlasmanager::create_atlas({
                 .name = atlas_name,
-                .width = 2048,
-                .height = 2048,
-                .generate_mipmaps = false
+                .width = page_size,
+                .height = page_size,
+                .generate_mipmaps = false,
+                .max_pages = 1,
+                .sdf_scale = bake == GlyphBake::DistanceField ? kSdfDistScale : 0.0f
                 });
         }
 
         auto* registrar = atlasmanager::get_registrar(atlas_name);
         if (!registrar)
-        {
-            std::cerr << "[FontRenderer] Missing registrar for atlas '" << atlas_name << "'\n";
             return false;
+
+        std::lock_guard lock(mutex_);
+        source_ = std::move(source);
+        atlas_ = &registrar->atlas;
+        atlas_name_ = atlas_name;
+        bake_ = bake;
+        page_size_ = (std::min)({ page_size, atlas_->width, atlas_->height });
+
+        slots_.clear();
+        shelves_.clear();
+        next_shelf_y_ = 0;
+        free_entries_.clear();
+        for (std::size_t i = atlas_->entry_count(); i-- > 0;)
+            free_entries_.push_back(static_cast<int>(i));
+
+        generation_.fetch_add(1, std::memory_order_acq_rel);
+        return true;
+    }
+
+    std::optional<Glyph> GlyphCache::find(char32_t codepoint)
+    {
+        std::optional<Glyph> result;
+        bool wrote = false;
+        {
+            std::lock_guard lock(mutex_);
+            if (!source_ || !atlas_)
+                return std::nullopt;
+
+            const std::uint64_t now = ++clock_;
+            auto it = slots_.find(codepoint);
+            if (it == slots_.end())
+            {
+                Slot slot{};
+                wrote = rasterise_locked(codepoint, slot);
+                if (slot.deferred)
+                    return std::nullopt;
+                it = slots_.emplace(codepoint, slot).first;
+            }
+
+            Slot& slot = it->second;
+            if (slot.shelf != kNoShelf)
+            {
+                shelves_[slot.shelf].last_use = now;
+                shelves_[slot.shelf].frame = frame_;
+            }
+            if (slot.present)
+                result = slot.glyph;
         }
 
-        TextureAtlas& atlas = registrar->atlas;
+        // Outside the lock: this may run the backend uploaders inline.
+        if (wrote)
+            atlasmanager::ensure_uploaded(*atlas_);
+        return result;
+    }
+
+    void GlyphCache::begin_frame(std::span<const char32_t> in_use)
+    {
+        std::lock_guard lock(mutex_);
+        const bool deferred = frame_ != 0 && full_frame_ == frame_;
+        ++frame_;
 
-        std::optional<AtlasEntry> maybe_entry;
+        const std::uint64_t now = ++clock_;
+        for (const char32_t codepoint : in_use)
         {
-            std::lock_guard<std::mutex> lock(atlas_mutex);
-            maybe_entry = atlas.add_entry(name, raw_texture);
+            auto it = slots_.find(codepoint);
+            if (it == slots_.end() || it->second.shelf == kNoShelf)
+                continue;
+            shelves_[it->second.shelf].last_use = now;
+            shelves_[it->second.shelf].frame = frame_;
         }
 
-        if (!maybe_entry)
+        // Runs laid out without the deferred glyphs rebuild and ask again.
+        if (deferred)
+            generation_.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    std::size_t GlyphCache::resident_count() const
+    {
+        std::lock_guard lock(mutex_);
+        std::size_t count = 0;
+        for (const auto& shelf : shelves_)
+            count += shelf.codepoints.size();
+        return count;
+    }
+
+    int GlyphCache::atlas_index() const noexcept
+    {
+        std::lock_guard lock(mutex_);
+        return atlas_ ? atlas_->get_index() : -1;
+    }
+
+    // Fills `slot`; returns true when texels were written to the page. Bitmap
+    // glyphs use the same placement maths as stbtt_PackFontRanges with 2x2
+    // oversampling; distance fields are one texel per pixel at the cache's
+    // height.
+    bool GlyphCache::rasterise_locked(char32_t codepoint, Slot& slot)
+    {
+        const stbtt_fontinfo& info = source_->info;
+        const int glyph_index = stbtt_FindGlyphIndex(&info, static_cast<int>(codepoint));
+        if (glyph_index == 0)
+            return false; // missing: callers fall back to their own substitute
+
+        int advance = 0;
+        int lsb = 0;
+        stbtt_GetGlyphHMetrics(&info, glyph_index, &advance, &lsb);
+        slot.present = true;
+        slot.glyph.advance = static_cast<float>(advance) * source_->scale;
+
+        auto& mono = source_->mono;
+        int w = 0;
+        int h = 0;
+        if (bake_ == GlyphBake::DistanceField)
         {
-            std::cerr << "[FontRenderer] Failed to pack font '" << name << "' into shared atlas\n";
+            int xoff = 0;
+            int yoff = 0;
+            unsigned char* field = stbtt_GetGlyphSDF(&info, source_->scale, glyph_index,
+                kSdfPadding, kSdfOnEdge, kSdfDistScale, &w, &h, &xoff, &yoff);
+            if (!field)
+                return false; // blank, e.g. the space
+
+            mono.assign(field, field + static_cast<std::size_t>(w) * h);
+            stbtt_FreeSDF(field, nullptr);
+            slot.glyph.size_px = { static_cast<float>(w), static_cast<float>(h) };
+            slot.glyph.offset_px = { static_cast<float>(xoff), static_cast<float>(yoff) };
+        }
+        else
+        {
+            const float scale = source_->scale * kOversample;
+            int x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+            stbtt_GetGlyphBitmapBoxSubpixel(&info, glyph_index, scale, scale, 0.0f, 0.0f, &x0, &y0, &x1, &y1);
+            if (x1 <= x0 || y1 <= y0)
+                return false; // blank, e.g. the space
+
+            w = x1 - x0 + kOversample - 1;
+            h = y1 - y0 + kOversample - 1;
+            mono.assign(static_cast<std::size_t>(w) * h, 0);
+            float sub_x = 0.0f;
+            float sub_y = 0.0f;
+            stbtt_MakeGlyphBitmapSubpixelPrefilter(&info, mono.data(), w, h, w,
+                scale, scale, 0.0f, 0.0f, kOversample, kOversample, &sub_x, &sub_y, glyph_index);
+
+            // Texels are oversampled; the quad is in pixels.
+            slot.glyph.size_px = {
+                static_cast<float>(w) / kOversample,
+                static_cast<float>(h) / kOversample
+            };
+            slot.glyph.offset_px = {
+                static_cast<float>(x0) / kOversample + sub_x,
+                static_cast<float>(y0) / kOversample + sub_y
+            };
+        }
+
+        const std::uint32_t cell_w = static_cast<std::uint32_t>(w) + kGutter * 2;
+        const std::uint32_t cell_h = static_cast<std::uint32_t>(h) + kGutter * 2;
+
+        std::uint32_t x = 0;
+        bool pinned = false;
+        const std::uint32_t shelf_index = reserve_locked(cell_w, cell_h, x, pinned);
+        if (shelf_index == kNoShelf && pinned)
+        {
+            slot.deferred = true;
             return false;
         }
+        if (shelf_index == kNoShelf)
+        {
+            std::cerr << "[FontRenderer] Glyph U+" << static_cast<std::uint32_t>(codepoint)
+                << " does not fit glyph page '" << atlas_name_ << "'\n";
+            slot.present = false;
+            return false;
+        }
+        Shelf& shelf = shelves_[shelf_index];
 
-        const AtlasEntry& atlas_entry = *maybe_entry;
+        // The cell spans the full shelf height so recycled shelves never keep
+        // stale texels next to a new glyph.
+        auto& rgba = source_->rgba;
+        rgba.assign(static_cast<std::size_t>(cell_w) * shelf.height * 4, 0);
+        for (int row = 0; row < h; ++row)
+        {
+            std::uint8_t* dst = rgba.data()
+                + ((static_cast<std::size_t>(row) + kGutter) * cell_w + kGutter) * 4;
+            for (int col = 0; col < w; ++col, dst += 4)
+            {
+                dst[0] = 255;
+                dst[1] = 255;
+                dst[2] = 255;
+                dst[3] = mono[static_cast<std::size_t>(row) * w + col];
+            }
+        }
+        atlas_->write_rect({ x, shelf.y, cell_w, shelf.height }, rgba);
 
-        float total_advance = 0.0f;
-        std::size_t advance_count = 0;
-        float max_advance = 0.0f;
+        const std::uint32_t gx = x + kGutter;
+        const std::uint32_t gy = shelf.y + kGutter;
+        int entry = -1;
+        if (!free_entries_.empty())
+        {
+            entry = free_entries_.back();
+            free_entries_.pop_back();
+            if (!atlas_->move_slice(entry, gx, gy, static_cast<std::uint32_t>(w), static_cast<std::uint32_t>(h)))
+            {
+                // Keep the entry for a later glyph rather than leaking it.
+                free_entries_.push_back(entry);
+                entry = -1;
+            }
+        }
+        if (entry < 0)
+        {
+            const std::string entry_name = atlas_name_ + "#" + std::to_string(atlas_->entry_count());
+            if (auto added = atlas_->add_slice_entry(entry_name, static_cast<int>(gx), static_cast<int>(gy), w, h))
+                entry = added->index;
+        }
 
-        for (auto& [codepoint, baked] : baked_glyphs)
+        if (entry >= 0)
         {
-            Glyph glyph = std::move(baked.glyph);
+            slot.glyph.handle = SpriteHandle{
+                static_cast<std::uint32_t>(entry),
+                0u,
+                static_cast<std::uint32_t>(atlas_->get_index()),
+                static_cast<std::uint32_t>(entry)
+            };
+            slot.shelf = shelf_index;
+            slot.entry = entry;
+            shelf.codepoints.push_back(codepoint);
+        }
+        return true;
+    }
 
-            const int glyph_width = baked.x1 - baked.x0;
-            const int glyph_height = baked.y1 - baked.y0;
+    // Picks the tightest open shelf that is at most half again as tall as the
+    // cell, then a new shelf, then the least recently used shelf tall enough
+    // that the current frame has not used. `out_pinned` reports a miss caused
+    // only by pinned shelves.
+    std::uint32_t GlyphCache::reserve_locked(std::uint32_t cell_w, std::uint32_t cell_h, std::uint32_t& out_x, bool& out_pinned)
+    {
+        out_pinned = false;
+        const std::uint32_t height = (cell_h + 3u) & ~3u;
+        if (cell_w > page_size_ || height > page_size_)
+            return kNoShelf;
 
-            if (glyph_width > 0 && glyph_height > 0)
-            {
-                const int slice_x = static_cast<int>(atlas_entry.region.x) + baked.x0;
-                const int slice_y = static_cast<int>(atlas_entry.region.y) + baked.y0;
-                const std::string glyph_name =
-                    name + "_pt" + std::to_string(size_pt) +
-                    "_cp" + std::to_string(static_cast<std::uint32_t>(codepoint));
+        std::uint32_t best = kNoShelf;
+        for (std::uint32_t i = 0; i < shelves_.size(); ++i)
+        {
+            const Shelf& shelf = shelves_[i];
+            if (shelf.height < height || shelf.height > height + height / 2
+                || shelf.cursor + cell_w > page_size_)
+                continue;
+            if (best == kNoShelf || shelf.height < shelves_[best].height)
+                best = i;
+        }
 
-                std::optional<AtlasEntry> glyph_entry;
-                {
-                    std::lock_guard<std::mutex> lock(atlas_mutex);
-                    glyph_entry = atlas.add_slice_entry(glyph_name, slice_x, slice_y, glyph_width, glyph_height);
-                }
+        if (best == kNoShelf && next_shelf_y_ + height <= page_size_)
+        {
+            shelves_.push_back({ .y = next_shelf_y_, .height = height });
+            next_shelf_y_ += height;
+            best = static_cast<std::uint32_t>(shelves_.size() - 1);
+        }
 
-                if (glyph_entry)
+        if (best == kNoShelf)
+        {
+            bool tall_enough = false;
+            for (std::uint32_t i = 0; i < shelves_.size(); ++i)
+            {
+                if (shelves_[i].height < height)
+                    continue;
+                tall_enough = true;
+                if (frame_ != 0 && shelves_[i].frame == frame_)
+                    continue;
+                if (best == kNoShelf || shelves_[i].last_use < shelves_[best].last_use)
+                    best = i;
+            }
+            if (best == kNoShelf)
+            {
+                out_pinned = tall_enough;
+                if (tall_enough && full_frame_ != frame_)
                 {
-                    glyph.handle = SpriteHandle{
-                        static_cast<std::uint32_t>(glyph_entry->index),
-                        0u,
-                        static_cast<std::uint32_t>(atlas.get_index()),
-                        static_cast<std::uint32_t>(glyph_entry->index)
-                    };
+                    // Once per cache; an undersized page would hit this every frame.
+                    if (full_frame_ == 0)
+                        std::cerr << "[FontRenderer] Glyph page '" << atlas_name_ << "' (" << page_size_
+                            << "px) is too small for one frame's glyphs; the rest wait for the next frame\n";
+                    full_frame_ = frame_;
                 }
+                return kNoShelf;
             }
+            evict_locked(best);
+        }
+
+        Shelf& shelf = shelves_[best];
+        out_x = shelf.cursor;
+        shelf.cursor += cell_w;
+        return best;
+    }
 
-            asset.glyphs.emplace(codepoint, std::move(glyph));
+    void GlyphCache::evict_locked(std::uint32_t shelf_index)
+    {
+        Shelf& shelf = shelves_[shelf_index];
+        for (const char32_t codepoint : shelf.codepoints)
+        {
+            if (auto it = slots_.find(codepoint); it != slots_.end())
+            {
+                free_entries_.push_back(it->second.entry);
+                slots_.erase(it);
+            }
+        }
+        shelf.codepoints.clear();
+        shelf.cursor = 0;
+        generation_.fetch_add(1, std::memory_order_acq_rel);
+    }
 
-            const Glyph& stored_glyph = asset.glyphs.at(codepoint);
-            total_advance += stored_glyph.advance;
-            max_advance = (std::max)(max_advance, stored_glyph.advance);
-            ++advance_count;
+    almondnamespace::font::FontRenderer::FontRenderer(logger::Logger* log)
+        : logger_(log)
+    {
+    }
 
-            if (codepoint == U' ')
-                metrics.spaceAdvance = stored_glyph.advance;
+    // Only metrics and kerning are computed here; glyphs are rasterised on
+    // first use by the font's GlyphCache.
+    bool FontRenderer::load_font(const std::string& name,
+        const std::string& path,
+        float size_pt,
+        GlyphBake bake)
+    {
+        if (loaded_fonts_.contains(name))
+            return false;
+
+        if (size_pt <= 0.0f)
+        {
+            std::cerr << "[FontRenderer] Invalid font size '" << size_pt << "' requested for '" << path << "'\n";
+            return false;
         }
 
-        if (advance_count > 0)
-            metrics.averageAdvance = total_advance / static_cast<float>(advance_count);
+        auto font_buffer = read_file_binary(path);
+        if (font_buffer.empty())
+        {
+            std::cerr << "[FontRenderer] Unable to read font file '" << path << "'\n";
+            return false;
+        }
+
+        FontAsset asset{};
+        asset.name = name;
+        asset.path = path;
+        asset.size_pt = size_pt;
 
-        metrics.maxAdvance = (std::max)(metrics.maxAdvance, max_advance);
+        if (!load_font_metrics(font_buffer, path, size_pt, asset.metrics, asset.kerning_pairs))
+        {
+            std::cerr << "[FontRenderer] Failed to load font '" << name << "' from '" << path << "'\n";
+            return false;
+        }
 
-        if (metrics.spaceAdvance <= 0.0f)
-            metrics.spaceAdvance = metrics.averageAdvance;
+        std::shared_ptr<GlyphCache> cache;
+        if (bake == GlyphBake::DistanceField)
+        {
+            auto& shared = distance_field_caches_[path];
+            if (!shared)
+            {
+                auto created = std::make_shared<GlyphCache>();
+                if (created->init(std::move(font_buffer), GlyphCache::kDistanceFieldHeight,
+                    "font_sdf:" + path, GlyphBake::DistanceField))
+                    shared = std::move(created);
+            }
+            cache = shared;
+            asset.glyph_scale = size_pt / GlyphCache::kDistanceFieldHeight;
+        }
+        else
+        {
+            cache = std::make_shared<GlyphCache>();
+            if (!cache->init(std::move(font_buffer), size_pt, "font_glyphs:" + name))
+                cache.reset();
+        }
 
-        asset.atlas_index = atlas.get_index();
-        asset.metrics = metrics;
-        asset.kerning_pairs = std::move(kerning_pairs);
+        if (!cache)
+        {
+            if (bake == GlyphBake::DistanceField)
+                distance_field_caches_.erase(path);
+            std::cerr << "[FontRenderer] Failed to create glyph cache for font '" << name << "'\n";
+            return false;
+        }
 
-        almondnamespace::atlasmanager::ensure_uploaded(atlas);
+        asset.atlas_index = cache->atlas_index();
+        asset.glyph_cache = std::move(cache);
 
         loaded_fonts_.emplace(name, std::move(asset));
         return true;
@@ -208,34 +674,16 @@ namespace almondnamespace::font
         loaded_fonts_.erase(name);
     }
 
-    bool FontRenderer::load_and_bake_font(const std::string& ttf_path,
+    bool FontRenderer::load_font_metrics(const std::vector<unsigned char>& font_data,
+        const std::string& ttf_path,
         float size_pt,
-        std::vector<std::pair<char32_t, BakedGlyph>>& out_glyphs,
         FontMetrics& out_metrics,
-        std::unordered_map<std::uint64_t, float>& out_kerning,
-        Texture& out_texture)
+        std::vector<KerningPair>& out_kerning)
     {
-        out_glyphs.clear();
         out_kerning.clear();
-        out_texture.clear();
-        out_texture.channels = 4;
-        out_texture.name = ttf_path;
         out_metrics = FontMetrics{};
 
-        if (size_pt <= 0.0f)
-        {
-            std::cerr << "[FontRenderer] Invalid font size '" << size_pt << "' requested for '" << ttf_path << "'\n";
-            return false;
-        }
-
-        auto font_buffer = read_file_binary(ttf_path);
-        if (font_buffer.empty())
-        {
-            std::cerr << "[FontRenderer] Unable to read font file '" << ttf_path << "'\n";
-            return false;
-        }
-
-        const int font_offset = stbtt_GetFontOffsetForIndex(font_buffer.data(), 0);
+        const int font_offset = stbtt_GetFontOffsetForIndex(font_data.data(), 0);
         if (font_offset < 0)
         {
             std::cerr << "[FontRenderer] Invalid font offset for '" << ttf_path << "'\n";
@@ -243,7 +691,7 @@ namespace almondnamespace::font
         }
 
         stbtt_fontinfo font{};
-        if (!stbtt_InitFont(&font, font_buffer.data(), font_offset))
+        if (!stbtt_InitFont(&font, font_data.data(), font_offset))
         {
             std::cerr << "[FontRenderer] Failed to initialise font info for '" << ttf_path << "'\n";
             return false;
@@ -260,148 +708,50 @@ namespace almondnamespace::font
         out_metrics.lineGap = static_cast<float>(raw_line_gap) * scale;
         out_metrics.lineHeight = out_metrics.ascent + out_metrics.descent + out_metrics.lineGap;
 
-        constexpr int pack_width = 1024;
-        constexpr int pack_height = 1024;
-        std::vector<unsigned char> mono_bitmap(static_cast<std::size_t>(pack_width) * pack_height, 0);
-
-        stbtt_pack_context pack_context{};
-        if (!stbtt_PackBegin(&pack_context, mono_bitmap.data(), pack_width, pack_height, pack_width, 1, nullptr))
-        {
-            std::cerr << "[FontRenderer] Failed to begin packing for font '" << ttf_path << "'\n";
-            return false;
-        }
-
-        stbtt_PackSetOversampling(&pack_context, 2, 2);
-
-        const std::array<std::pair<int, int>, 2> ranges_info{ {
-            {32, 126},
-            {160, 255}
-        } };
-
-        std::size_t total_chars = 0;
-        for (const auto& range : ranges_info)
-            total_chars += static_cast<std::size_t>(range.second - range.first + 1);
+        std::vector<char32_t> codepoints{};
+        for (const auto& [first_codepoint, last_codepoint] : kMetricRanges)
+            for (int cp = first_codepoint; cp <= last_codepoint; ++cp)
+                codepoints.push_back(static_cast<char32_t>(cp));
 
-        std::vector<stbtt_packedchar> packed_chars(total_chars);
-        std::vector<stbtt_pack_range> pack_ranges(ranges_info.size());
-
-        std::size_t packed_offset = 0;
-        for (std::size_t i = 0; i < ranges_info.size(); ++i)
-        {
-            const auto [first_codepoint, last_codepoint] = ranges_info[i];
-            const int glyph_count = last_codepoint - first_codepoint + 1;
-
-            pack_ranges[i].font_size = size_pt;
-            pack_ranges[i].first_unicode_codepoint_in_range = first_codepoint;
-            pack_ranges[i].array_of_unicode_codepoints = nullptr;
-            pack_ranges[i].num_chars = glyph_count;
-            pack_ranges[i].chardata_for_range = packed_chars.data() + packed_offset;
-            pack_ranges[i].h_oversample = 2;
-            pack_ranges[i].v_oversample = 2;
-
-            packed_offset += static_cast<std::size_t>(glyph_count);
-        }
-
-        if (!stbtt_PackFontRanges(&pack_context, font_buffer.data(), 0, pack_ranges.data(), static_cast<int>(pack_ranges.size())))
-        {
-            stbtt_PackEnd(&pack_context);
-            std::cerr << "[FontRenderer] Failed to pack glyph ranges for font '" << ttf_path << "'\n";
-            return false;
-        }
-
-        stbtt_PackEnd(&pack_context);
-
-        int max_x1 = 0;
-        int max_y1 = 0;
-        for (const auto& packed : packed_chars)
+        float total_advance = 0.0f;
+        for (const char32_t codepoint : codepoints)
         {
-            max_x1 = (std::max)(max_x1, static_cast<int>(packed.x1));
-            max_y1 = (std::max)(max_y1, static_cast<int>(packed.y1));
-        }
+            int advance = 0;
+            int lsb = 0;
+            stbtt_GetCodepointHMetrics(&font, static_cast<int>(codepoint), &advance, &lsb);
+            const float advance_px = static_cast<float>(advance) * scale;
 
-        if (max_x1 <= 0 || max_y1 <= 0)
-        {
-            std::cerr << "[FontRenderer] Packed bitmap for font '" << ttf_path << "' is empty\n";
-            return false;
-        }
-
-        max_x1 = (std::min)(max_x1, pack_width);
-        max_y1 = (std::min)(max_y1, pack_height);
-
-        out_texture.width = static_cast<std::uint32_t>(max_x1);
-        out_texture.height = static_cast<std::uint32_t>(max_y1);
-        out_texture.channels = 4;
-        out_texture.pixels.assign(static_cast<std::size_t>(out_texture.width) * out_texture.height * 4, 0);
-
-        for (std::uint32_t y = 0; y < out_texture.height; ++y)
-        {
-            for (std::uint32_t x = 0; x < out_texture.width; ++x)
-            {
-                const unsigned char alpha = mono_bitmap[static_cast<std::size_t>(y) * pack_width + x];
-                const std::size_t idx = (static_cast<std::size_t>(y) * out_texture.width + x) * 4;
-                out_texture.pixels[idx + 0] = 255;
-                out_texture.pixels[idx + 1] = 255;
-                out_texture.pixels[idx + 2] = 255;
-                out_texture.pixels[idx + 3] = alpha;
-            }
+            total_advance += advance_px;
+            out_metrics.maxAdvance = (std::max)(out_metrics.maxAdvance, advance_px);
+            if (codepoint == U' ')
+                out_metrics.spaceAdvance = advance_px;
         }
 
-        out_glyphs.reserve(total_chars);
-        packed_offset = 0;
+        if (!codepoints.empty())
+            out_metrics.averageAdvance = total_advance / static_cast<float>(codepoints.size());
+        if (out_metrics.spaceAdvance <= 0.0f)
+            out_metrics.spaceAdvance = out_metrics.averageAdvance;
 
-        for (std::size_t range_index = 0; range_index < ranges_info.size(); ++range_index)
+        KernGlyphs kern_glyphs{};
+        kern_glyphs.slot.assign(static_cast<std::size_t>((std::max)(font.numGlyphs, 0)), -1);
+        for (const char32_t codepoint : codepoints)
         {
-            const auto [first_codepoint, last_codepoint] = ranges_info[range_index];
-            const int glyph_count = last_codepoint - first_codepoint + 1;
-            const stbtt_packedchar* range_chars = packed_chars.data() + packed_offset;
-
-            for (int glyph_index = 0; glyph_index < glyph_count; ++glyph_index)
+            const int glyph = stbtt_FindGlyphIndex(&font, static_cast<int>(codepoint));
+            if (glyph <= 0 || glyph >= font.numGlyphs)
+                continue; // missing glyphs are drawn as a substitute, never kerned
+            int& slot = kern_glyphs.slot[static_cast<std::size_t>(glyph)];
+            if (slot < 0)
             {
-                const stbtt_packedchar& packed = range_chars[glyph_index];
-
-                BakedGlyph baked{};
-                baked.glyph.size_px = {
-                    static_cast<float>(packed.x1 - packed.x0),
-                    static_cast<float>(packed.y1 - packed.y0)
-                };
-                baked.glyph.offset_px = { packed.xoff, packed.yoff };
-                baked.glyph.advance = packed.xadvance;
-                baked.x0 = packed.x0;
-                baked.y0 = packed.y0;
-                baked.x1 = packed.x1;
-                baked.y1 = packed.y1;
-
-                out_metrics.maxAdvance = (std::max)(out_metrics.maxAdvance, baked.glyph.advance);
-                if (first_codepoint + glyph_index == 32)
-                    out_metrics.spaceAdvance = baked.glyph.advance;
-
-                out_glyphs.emplace_back(static_cast<char32_t>(first_codepoint + glyph_index), std::move(baked));
+                slot = static_cast<int>(kern_glyphs.glyph.size());
+                kern_glyphs.glyph.push_back(glyph);
+                kern_glyphs.codepoints.emplace_back();
             }
-
-            packed_offset += static_cast<std::size_t>(glyph_count);
+            kern_glyphs.codepoints[static_cast<std::size_t>(slot)].push_back(codepoint);
         }
 
-        if (!out_glyphs.empty())
-        {
-            out_kerning.reserve(out_glyphs.size() * 4);
-            for (const auto& [left_cp, _] : out_glyphs)
-            {
-                for (const auto& [right_cp, __] : out_glyphs)
-                {
-                    const int kern = stbtt_GetCodepointKernAdvance(&font,
-                        static_cast<int>(left_cp),
-                        static_cast<int>(right_cp));
-                    if (kern == 0)
-                        continue;
-
-                    const float kern_px = static_cast<float>(kern) * scale;
-                    const std::uint64_t key =
-                        (static_cast<std::uint64_t>(left_cp) << 32) |
-                        static_cast<std::uint64_t>(right_cp);
-                    out_kerning[key] = kern_px;
-                }
-            }
-        }
+        collect_kerning(font, kern_glyphs, scale, out_kerning);
+        std::sort(out_kerning.begin(), out_kerning.end(),
+            [](const KerningPair& a, const KerningPair& b) { return a.key < b.key; });
 
         return true;
     }